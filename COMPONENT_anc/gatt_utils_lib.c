@@ -101,40 +101,41 @@ wiced_bt_gatt_status_t wiced_bt_util_send_gatt_discover(uint16_t conn_id, wiced_
 /*
  * Format and send GATT Read by Handle request
  */
-wiced_bt_gatt_status_t wiced_bt_util_send_gatt_read_by_handle(uint16_t conn_id, uint16_t handle)
+wiced_bt_gatt_status_t wiced_bt_util_send_gatt_read_by_handle(uint16_t conn_id, uint16_t handle, uint8_t *p_read_buf, uint16_t len)
 {
-#if 0
-    wiced_bt_gatt_read_param_t param;
-    wiced_bt_gatt_status_t     status;
+    if ((handle == 0) || (p_read_buf == NULL))
+        return WICED_BT_GATT_ILLEGAL_PARAMETER;
 
-    memset(&param, 0, sizeof(param));
-    param.by_handle.handle = handle;
-
-    status = wiced_bt_gatt_send_read(conn_id, GATT_READ_BY_HANDLE, &param);
-    return status;
-#endif
-    return WICED_BT_GATT_SUCCESS;
+    return wiced_bt_gatt_client_send_read_handle(conn_id, handle, 0, p_read_buf, len, GATT_AUTH_REQ_NONE);
 }
 
 /*
  * Format and send GATT Read by Type request
  */
-wiced_bt_gatt_status_t wiced_bt_util_send_gatt_read_by_type(uint16_t conn_id, uint16_t s_handle, uint16_t e_handle, uint16_t uuid)
+wiced_bt_gatt_status_t wiced_bt_util_send_gatt_read_by_type(uint16_t conn_id, uint16_t s_handle, uint16_t e_handle, uint16_t uuid, uint8_t *p_read_buf, uint16_t len)
 {
-#if 0
-    wiced_bt_gatt_read_param_t param;
-    wiced_bt_gatt_status_t     status;
+    wiced_bt_uuid_t char_type;
 
-    memset(&param, 0, sizeof(param));
-    param.char_type.s_handle        = s_handle;
-    param.char_type.e_handle        = e_handle;
-    param.char_type.uuid.len        = 2;
-    param.char_type.uuid.uu.uuid16  = uuid;
+    if ((s_handle == 0) || (e_handle < s_handle) || (p_read_buf == NULL))
+        return WICED_BT_GATT_ILLEGAL_PARAMETER;
 
-    status = wiced_bt_gatt_send_read(conn_id, GATT_READ_BY_TYPE, &param);
-    return status;
-#endif
-    return WICED_BT_GATT_SUCCESS;
+    memset(&char_type, 0, sizeof(char_type));
+    char_type.len       = LEN_UUID_16;
+    char_type.uu.uuid16 = uuid;
+
+    return wiced_bt_gatt_client_send_read_by_type(conn_id, s_handle, e_handle, &char_type, p_read_buf, len, GATT_AUTH_REQ_NONE);
+}
+
+/*
+ * wiced_bt_util_send_gatt_read_multiple
+ * Format and send GATT Read Multiple request
+ */
+wiced_bt_gatt_status_t wiced_bt_util_send_gatt_read_multiple(uint16_t conn_id, uint16_t *p_handles, int num_handles, uint8_t *p_read_buf, uint16_t len)
+{
+    if ((p_handles == NULL) || (num_handles < 2) || (p_read_buf == NULL))
+        return WICED_BT_GATT_ILLEGAL_PARAMETER;
+
+    return wiced_bt_gatt_client_send_read_multiple(conn_id, GATT_REQ_READ_MULTI, p_handles, num_handles, p_read_buf, len, GATT_AUTH_REQ_NONE);
 }
 
 /*
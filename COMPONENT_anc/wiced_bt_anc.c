@@ -50,13 +50,22 @@
 #include "wiced_bt_anc.h"
 #include "wiced_result.h"
 #include "string.h"
+#include "stddef.h"
 #include "wiced_bt_gatt_util.h"
+#include "wiced_bt_anc_trace.h"
 
 #ifdef WICED_BT_TRACE_ENABLE
 #define     ANC_LIB_TRACE                          WICED_BT_TRACE
 #else
 #define     ANC_LIB_TRACE(...)
 #endif
+
+/* Trace of the alert path (notifications, responses), binary when ANC_BINARY_TRACE is defined */
+#if defined(WICED_BT_TRACE_ENABLE) || defined(ANC_BINARY_TRACE)
+#define     ANC_LIB_TRACE_BIN                      ANC_TRACE_BIN
+#else
+#define     ANC_LIB_TRACE_BIN(...)
+#endif
 #define WICED_BT_GATT_NOT_FOUND WICED_BT_GATT_ATTRIBUTE_NOT_FOUND
 #define MAX_READ_LEN	(256)
 
@@ -68,366 +77,2041 @@ enum
 {
     ANC_CLIENT_STATE_IDLE                                 = 0x00,
     ANC_CLIENT_STATE_CONNECTED                            = 0x01,
-    ANC_CLIENT_STATE_DISCOVER_NEW_ALERT_CCCD              = 0x02,
-    ANC_CLIENT_STATE_DISCOVER_UNREAD_ALERT_CCCD           = 0x03,
+    ANC_CLIENT_STATE_DISCOVER_CCCD                        = 0x02,
+    ANC_CLIENT_STATE_DISCOVER_CHARACTERISTICS             = 0x03,
     ANC_CLIENT_STATE_SET_REQUIRED_CONTROL_ALERTS          = 0x04,
     ANC_CLIENT_STATE_SET_NEW_ALERT_CCCD                   = 0x05,
     ANC_CLIENT_STATE_SET_UNREAD_ALERT_CCCD                = 0x06,
     ANC_CLIENT_STATE_RESET_NEW_ALERT_CCCD                 = 0x07,
     ANC_CLIENT_STATE_RESET_UNREAD_ALERT_CCCD              = 0x08,
+    ANC_CLIENT_STATE_DISCOVER_UNREAD_ALERT_CCCD           = 0x09,
+    ANC_CLIENT_STATE_DISCOVER_GATT_SERVICE                = 0x0A,
+    ANC_CLIENT_STATE_DISCOVER_SERVICE_CHANGED             = 0x0B,
+    ANC_CLIENT_STATE_DISCOVER_SERVICE_CHANGED_CCCD        = 0x0C,
+    ANC_CLIENT_STATE_SET_SERVICE_CHANGED_CCCD             = 0x0D,
+    ANC_CLIENT_STATE_DISCOVER_SERVICE                     = 0x0E,
+    ANC_CLIENT_STATE_VALIDATE_HANDLE_CACHE                = 0x0F,
+};
+
+/* CCCD writes requested during discovery, sent when the discovery completes */
+#define ANC_LIB_PENDING_NEW_ALERT_CCCD                      0x01
+#define ANC_LIB_PENDING_UNREAD_ALERT_CCCD                   0x02
+
+/* Supported category values read on this connection, answered without a read */
+#define ANC_LIB_CACHED_NEW_CATEGORIES                       0x01
+#define ANC_LIB_CACHED_UNREAD_CATEGORIES                    0x02
+
+/* No event to report, outside of wiced_bt_anc_event_t */
+#define ANC_LIB_NO_EVENT                                    ((wiced_bt_anc_event_t)0xFF)
+
+/* ANS characteristics, in the order of their UUIDs (0x2A44 to 0x2A48) so that a
+ * discovered UUID indexes anc_lib_chars directly */
+enum
+{
+    ANC_LIB_CHAR_CONTROL_POINT,
+    ANC_LIB_CHAR_UNREAD_ALERT,
+    ANC_LIB_CHAR_NEW_ALERT,
+    ANC_LIB_CHAR_SUPPORTED_NEW_CATEGORY,
+    ANC_LIB_CHAR_SUPPORTED_UNREAD_CATEGORY,
+    ANC_LIB_NUM_CHARS
 };
+#define ANC_LIB_FIRST_CHAR_UUID                             UUID_CHARACTERISTIC_ALERT_NOTIFICATION_CONTROL_POINT
+#define ANC_LIB_CHAR_BIT(idx)                               (1 << (idx))
+
+/* Characteristic without a CCCD, or without a discovery item */
+#define ANC_LIB_NO_CCCD                                     0xFF
+#define ANC_LIB_NO_ITEM                                     0xFF
+
+#define ANC_LIB_HANDLE_OFFSET(field)                        ((uint8_t)offsetof(wiced_bt_anc_handle_cache_t, field))
+
+/* Route of an attribute handle: nothing, the value or the CCCD of an ANS characteristic */
+#define ANC_LIB_ROUTE_NONE                                  0
+#define ANC_LIB_ROUTE_VALUE(idx)                            (1 + (idx))
+#define ANC_LIB_ROUTE_CCCD(idx)                             (1 + ANC_LIB_NUM_CHARS + (idx))
+#define ANC_LIB_ROUTE_IS_VALUE(route)                       (((route) != ANC_LIB_ROUTE_NONE) && ((route) <= ANC_LIB_NUM_CHARS))
+
+/* Handles, from the ANS start handle, routed with one load from the route map. Handles past
+ * it are routed by a search of the handle cache */
+#ifndef ANC_LIB_ROUTE_MAP_SIZE
+#define ANC_LIB_ROUTE_MAP_SIZE                              32
+#endif
+
+/* Number of control point writes an application can queue on one connection */
+#ifndef MAX_SIMULTANIOUS_CONTROL_POINT_WRITES
+#define MAX_SIMULTANIOUS_CONTROL_POINT_WRITES               5
+#endif
+
+/* Longest alert text copied in WICED_BT_ANC_ALERT_TEXT_COPY mode, longer texts are truncated */
+#ifndef ANC_LIB_MAX_ALERT_TEXT_LEN
+#define ANC_LIB_MAX_ALERT_TEXT_LEN                          (GATT_MAX_ATTR_LEN - 2)
+#endif
+
+/* Time given to the server to answer a GATT request of the library, 0 for no limit. Below the
+ * 30 s ATT transaction timeout so that the library, which then disconnects, gives up first */
+#ifndef ANC_LIB_GATT_TIMEOUT_MS
+#define ANC_LIB_GATT_TIMEOUT_MS                             20000
+#endif
+
+/* GATT request of the library on the air */
+#define ANC_LIB_GATT_NONE                                   0
+#define ANC_LIB_GATT_DISCOVER                               1
+#define ANC_LIB_GATT_READ                                   2
+#define ANC_LIB_GATT_READ_BY_TYPE                           3
+#define ANC_LIB_GATT_READ_MULTIPLE                          4
+#define ANC_LIB_GATT_WRITE_CCCD                             5
+#define ANC_LIB_GATT_WRITE                                  6
+
+/* Requests of the asynchronous API one connection holds, queued or on the air */
+#ifndef ANC_LIB_MAX_REQUESTS
+#define ANC_LIB_MAX_REQUESTS                                4
+#endif
+
+/* Maximum number of ANS peers the library serves at the same time */
+#ifndef ANC_LIB_MAX_CONNECTIONS
+#define ANC_LIB_MAX_CONNECTIONS                             4
+#endif
+
+/* Size of the connection table. Must be a power of two and is kept at twice the
+ * maximum number of connections so that lookups by conn_id stay within one or two probes */
+#define ANC_LIB_CONN_TABLE_SIZE                             (2 * ANC_LIB_MAX_CONNECTIONS)
+#define ANC_LIB_CONN_TABLE_MASK                             (ANC_LIB_CONN_TABLE_SIZE - 1)
 
-//#define MAX_SIMULTANIOUS_CONTROL_POINT_WRITES               5
+#if (ANC_LIB_CONN_TABLE_SIZE & ANC_LIB_CONN_TABLE_MASK) != 0
+#error "ANC_LIB_MAX_CONNECTIONS must be a power of two"
+#endif
 
 /******************************************************
  *                     Structures
  ******************************************************/
 
+/* Timing of the setup of a connection, see wiced_bt_anc_client_get_setup_stats */
+typedef struct {
+    uint64_t connected_us;              /* connection up */
+    uint64_t phase_start_us;            /* start of the running phase */
+    uint8_t  phase;                     /* running phase, WICED_BT_ANC_NUM_PHASES when none */
+    uint8_t  done;                      /* first CCCD write confirmed, phases are no longer tracked */
+    wiced_bt_anc_setup_stats_t stats;
+} anc_lib_setup_t;
+
+/* GATT request of the library on the air, kept to fail it when the server does not answer */
+typedef struct {
+    uint8_t  type;                      /* ANC_LIB_GATT_xxx */
+    uint8_t  discovery_type;            /* wiced_bt_gatt_discovery_type_t of ANC_LIB_GATT_DISCOVER */
+    uint16_t s_handle;                  /* discovered or read by type range, read or written handle, first of a read multiple */
+    uint16_t e_handle;                  /* end of the range, second handle of a read multiple */
+    uint16_t uuid;                      /* discovered or read by type UUID */
+    uint8_t  value[2];                  /* written value */
+    uint64_t deadline_us;               /* 0 when not limited */
+} anc_lib_gatt_req_t;
+
+/* Request of the asynchronous API, see wiced_bt_anc_submit */
+typedef struct {
+    wiced_bt_anc_request_id_t       id;
+    uint8_t                         op;         /* wiced_bt_anc_op_t */
+    uint8_t                         cmd_id;     /* control point write only */
+    uint8_t                         category;   /* control point write only */
+    uint8_t                         started;    /* sent by the library, its result event completes it */
+    wiced_bt_anc_request_complete_t *p_complete; /* NULL once cancelled */
+    void                            *p_context;
+} anc_lib_request_t;
+
+/* Per connection control block. conn_id 0 marks a free slot */
 typedef struct {
-    wiced_bt_anc_callback_t *p_callback;/* Application's callback function */
     uint16_t conn_id;                   /* connection identifier */
-    uint16_t anc_e_handle;              /* ANC discovery end handle */
+    uint16_t mtu;                       /* ATT MTU negotiated on the connection */
     uint8_t  anc_current_state;         /* to avoid other requests during execution of previous request*/
 
-    uint8_t control_alert_cmd_id; //[MAX_SIMULTANIOUS_CONTROL_POINT_WRITES];
-    uint8_t control_alert_catergory_id; //[MAX_SIMULTANIOUS_CONTROL_POINT_WRITES];
-//    uint8_t oldest_cp_write_req; /* To find the oldest control point write request.Used to find when processing the control point write repsonse */
+    /* FIFO of control point writes. Only the oldest one is sent to the server, the
+     * following ones are sent one by one as write responses come back */
+    uint8_t control_alert_cmd_id[MAX_SIMULTANIOUS_CONTROL_POINT_WRITES];
+    uint8_t control_alert_catergory_id[MAX_SIMULTANIOUS_CONTROL_POINT_WRITES];
+    uint8_t oldest_cp_write_req; /* To find the oldest control point write request.Used to find when processing the control point write repsonse */
+    uint8_t num_cp_write_req;    /* Number of queued control point writes */
+    uint8_t cp_write_in_flight;  /* Oldest control point write has been sent and waits for the response */
 
     uint8_t enabled_new_alerts;
     uint8_t enabled_unread_alerts;
+    uint8_t pending_cccd_writes; /* ANC_LIB_PENDING_xxx */
+    uint8_t unread_cccd_searched; /* the Unread Alert Status descriptors have been searched */
+
+    uint8_t  *p_read_buf;         /* buffer of the read on the air, NULL when none */
+    uint16_t read_by_type_uuid;   /* characteristic read by type over the ANS range, 0 for a read by handle */
+    uint8_t  read_multiple;       /* both supported categories are read with one Read Multiple */
+    uint8_t  read_multiple_failed; /* server rejected the Read Multiple, combined reads go one by one */
+    uint8_t  read_unread_next;    /* combined read done one by one, unread categories follow the new ones */
+
+    uint8_t  categories_cached;   /* ANC_LIB_CACHED_xxx */
+    uint8_t  new_categories_reports;    /* reads answered from the cache, reported by cached_timer */
+    uint8_t  unread_categories_reports;
+    wiced_bt_anp_alert_category_enable_t supported_new_alerts;
+    wiced_bt_anp_alert_category_enable_t supported_unread_alerts;
+
+    uint8_t  service_changed_subscribed; /* Service Changed indications enabled, or given up, on this connection */
+    uint8_t  rediscovering;       /* the running discovery only looks again at what a Service Changed covered */
+    uint16_t changed_s_handle;    /* Service Changed range waiting for the bearer, 0 when none */
+    uint16_t changed_e_handle;
+    uint16_t sc_s_handle;         /* range searched for the Service Changed characteristic, then for its CCCD */
+    uint16_t sc_e_handle;
+    uint8_t  database_hash_read;  /* Database Hash read, or not supported, on this connection */
 
     /* during discovery below gets populated and gets used later on application request in connection state */
+    wiced_bt_anc_handle_cache_t handles;
 
-    uint16_t new_alert_char_handle;       /* new alerts characteristic handle */
-    uint16_t new_alert_char_value_handle; /* new alerts characteristic value handle */
-    uint16_t new_alert_cccd_handle;       /* new alerts descriptor handle */
+    anc_lib_setup_t setup;
 
-    uint16_t unread_alert_char_handle;       /* unread alerts characteristic handle */
-    uint16_t unread_alert_char_value_handle; /* unread alerts characteristic value handle */
-    uint16_t unread_alert_cccd_handle;       /* unread alerts descriptor handle */
+    anc_lib_gatt_req_t gatt_req;   /* request on the air, type ANC_LIB_GATT_NONE when none */
+    uint8_t  late_responses;      /* responses still owed by the stack for requests that timed out, nothing
+                                     is sent meanwhile since the stack would refuse it as busy */
+    uint8_t  *p_late_read_buf;    /* buffer of a read that timed out, the stack may still fill it */
 
-    uint16_t alert_notify_control_point_char_handle;    /* Control point to control notifications characteristic handle */
-    uint16_t alert_notify_control_point_value_handle;   /* Control point to control notifications characteristic value handle */
+    /* route of each handle from route_base, built when the handles are known */
+    uint16_t route_base;
+    uint8_t  route_map[ANC_LIB_ROUTE_MAP_SIZE];
 
-    uint16_t supported_new_alert_category_handle;        /* Supported new alert category handle */
-    uint16_t supported_new_alert_category_value_handle;  /* Supported new alert category value handle */
-
-    uint16_t supported_unread_alert_category_handle;         /* Supported unread alert category handle */
-    uint16_t supported_unread_alert_category_value_handle;   /* Supported unread alert category handle */
+    /* FIFO of the requests of the asynchronous API. Only the oldest one is started, the
+     * following ones are started one by one as it completes */
+    anc_lib_request_t requests[ANC_LIB_MAX_REQUESTS];
+    uint8_t  oldest_request;
+    uint8_t  num_requests;
+    uint8_t  completing_request;  /* a completion function runs, requests are not started */
 
 } anc_lib_cb_t;
 
+/* Decoder of the notifications of a characteristic */
+typedef void (anc_lib_notification_decoder_t)( wiced_bt_gatt_operation_complete_t *p_data );
+
+/* Entry of anc_lib_chars, the handles are offsets in wiced_bt_anc_handle_cache_t */
+typedef struct {
+    uint8_t  char_offset;               /* declaration handle */
+    uint8_t  value_offset;              /* value handle */
+    uint8_t  cccd_offset;               /* CCCD handle, ANC_LIB_NO_CCCD when none */
+    uint8_t  pending_cccd_write;        /* ANC_LIB_PENDING_xxx of the CCCD, 0 when none */
+    uint8_t  mandatory;                 /* discovery fails without the characteristic */
+    uint8_t  ready_item;                /* wiced_bt_anc_discovery_item_t reported when the value handle, or
+                                           the CCCD handle if any, is found. ANC_LIB_NO_ITEM when none */
+    anc_lib_notification_decoder_t *p_decoder; /* NULL when the characteristic is not notified */
+} anc_lib_char_desc_t;
+
+typedef struct {
+    wiced_bt_anc_callback_t *p_callback;                    /* Application's callback function */
+    uint8_t                 alert_text_mode;                /* wiced_bt_anc_alert_text_mode_t */
+    uint8_t                 discovery_mode;                 /* wiced_bt_anc_discovery_mode_t */
+    uint8_t                 num_connections;                /* Number of slots in use */
+    wiced_bt_anc_request_id_t last_request_id;              /* Identifier given to the last submitted request */
+    uint32_t                gatt_timeout_ms;                /* see ANC_LIB_GATT_TIMEOUT_MS */
+    wiced_timer_t           gatt_timer;                     /* Earliest deadline of the requests on the air */
+    wiced_timer_t           cached_timer;                   /* Reports the reads answered from the cache */
+    char                    alert_text[ANC_LIB_MAX_ALERT_TEXT_LEN + 1]; /* Copy of the text of the New Alert being delivered */
+    anc_lib_cb_t            conn[ANC_LIB_CONN_TABLE_SIZE];  /* Connection table, open addressed by conn_id */
+} anc_lib_data_t;
+
 /******************************************************
  *                Variables Definitions
  ******************************************************/
-static anc_lib_cb_t anc_lib_data;
+static anc_lib_data_t anc_lib_data;
 
 /******************************************************
  *               Function Prototypes
  ******************************************************/
+static anc_lib_cb_t *anc_lib_find_conn( uint16_t conn_id );
+static anc_lib_cb_t *anc_lib_alloc_conn( uint16_t conn_id );
+static void anc_lib_free_conn( anc_lib_cb_t *p_cb );
+static void anc_lib_reset_conn( anc_lib_cb_t *p_cb );
+static void anc_lib_notify( wiced_bt_anc_event_t event, wiced_bt_anc_event_data_t *p_event_data );
+static wiced_bt_gatt_status_t anc_lib_send_control_point_write( anc_lib_cb_t *p_cb );
+static void anc_lib_send_queued_writes( anc_lib_cb_t *p_cb );
+static void anc_lib_setup_phase( anc_lib_cb_t *p_cb, uint8_t next_phase );
+static void anc_lib_setup_request( anc_lib_cb_t *p_cb, wiced_bt_gatt_status_t status );
+static void anc_lib_setup_subscribed( anc_lib_cb_t *p_cb );
+static wiced_bool_t anc_lib_start_rediscovery( anc_lib_cb_t *p_cb );
+static void anc_lib_subscribe_service_changed( anc_lib_cb_t *p_cb );
+static void anc_lib_service_changed_discovery_complete( anc_lib_cb_t *p_cb );
+static void anc_lib_rediscovery_done( anc_lib_cb_t *p_cb, wiced_bt_gatt_status_t status );
+static void anc_lib_update_database_hash( anc_lib_cb_t *p_cb );
+static void anc_lib_decode_new_alert( wiced_bt_gatt_operation_complete_t *p_data );
+static void anc_lib_decode_unread_alert( wiced_bt_gatt_operation_complete_t *p_data );
+static wiced_bool_t anc_lib_complete_request( anc_lib_cb_t *p_cb, wiced_bt_anc_event_t event, wiced_bt_anc_event_data_t *p_event_data );
+static void anc_lib_fail_requests( anc_lib_cb_t *p_cb, wiced_bt_gatt_status_t status );
+static void anc_lib_start_requests( anc_lib_cb_t *p_cb );
+static void anc_lib_gatt_arm_timer( void );
+static void anc_lib_cached_timeout( WICED_TIMER_PARAM_TYPE param );
+static wiced_bt_gatt_status_t anc_lib_gatt_discover( anc_lib_cb_t *p_cb, wiced_bt_gatt_discovery_type_t type, uint16_t uuid,
+                                                     uint16_t s_handle, uint16_t e_handle );
+static wiced_bt_gatt_status_t anc_lib_gatt_read( anc_lib_cb_t *p_cb, uint16_t handle );
+static wiced_bt_gatt_status_t anc_lib_gatt_read_by_type( anc_lib_cb_t *p_cb, uint16_t s_handle, uint16_t e_handle, uint16_t uuid );
+static wiced_bt_gatt_status_t anc_lib_gatt_read_multiple( anc_lib_cb_t *p_cb, uint16_t handle1, uint16_t handle2 );
+static wiced_bt_gatt_status_t anc_lib_gatt_write_cccd( anc_lib_cb_t *p_cb, uint16_t handle, uint16_t value );
+static wiced_bt_gatt_status_t anc_lib_gatt_write( anc_lib_cb_t *p_cb, uint16_t handle, uint8_t value0, uint8_t value1 );
+static wiced_bool_t anc_lib_gatt_response( anc_lib_cb_t *p_cb );
+
+/* Result event of each operation of the asynchronous API, see wiced_bt_anc_op_t */
+static const wiced_bt_anc_event_t anc_lib_request_events[WICED_BT_ANC_NUM_OPS] =
+{
+    [WICED_BT_ANC_OP_READ_SUPPORTED_NEW_ALERTS]     = WICED_BT_ANC_READ_SUPPORTED_NEW_ALERTS_RESULT,
+    [WICED_BT_ANC_OP_READ_SUPPORTED_UNREAD_ALERTS]  = WICED_BT_ANC_READ_SUPPORTED_UNREAD_ALERTS_RESULT,
+    [WICED_BT_ANC_OP_CONTROL_ALERTS]                = WICED_BT_ANC_CONTROL_ALERTS_RESULT,
+    [WICED_BT_ANC_OP_ENABLE_NEW_ALERTS]             = WICED_BT_ANC_ENABLE_NEW_ALERTS_RESULT,
+    [WICED_BT_ANC_OP_DISABLE_NEW_ALERTS]            = WICED_BT_ANC_DISABLE_NEW_ALERTS_RESULT,
+    [WICED_BT_ANC_OP_ENABLE_UNREAD_ALERTS]          = WICED_BT_ANC_ENABLE_UNREAD_ALERTS_RESULT,
+    [WICED_BT_ANC_OP_DISABLE_UNREAD_ALERTS]         = WICED_BT_ANC_DISABLE_UNREAD_ALERTS_RESULT,
+};
+
+/* ANS characteristics, see ANC_LIB_CHAR_xxx */
+static const anc_lib_char_desc_t anc_lib_chars[ANC_LIB_NUM_CHARS] =
+{
+    [ANC_LIB_CHAR_CONTROL_POINT] =
+    {
+        ANC_LIB_HANDLE_OFFSET(alert_notify_control_point_char_handle), ANC_LIB_HANDLE_OFFSET(alert_notify_control_point_value_handle),
+        ANC_LIB_NO_CCCD, 0, WICED_TRUE, WICED_BT_ANC_CONTROL_POINT_READY, NULL
+    },
+    [ANC_LIB_CHAR_UNREAD_ALERT] =
+    {
+        ANC_LIB_HANDLE_OFFSET(unread_alert_char_handle), ANC_LIB_HANDLE_OFFSET(unread_alert_char_value_handle),
+        ANC_LIB_HANDLE_OFFSET(unread_alert_cccd_handle), ANC_LIB_PENDING_UNREAD_ALERT_CCCD, WICED_FALSE, WICED_BT_ANC_UNREAD_ALERT_CCCD_READY,
+        anc_lib_decode_unread_alert
+    },
+    [ANC_LIB_CHAR_NEW_ALERT] =
+    {
+        ANC_LIB_HANDLE_OFFSET(new_alert_char_handle), ANC_LIB_HANDLE_OFFSET(new_alert_char_value_handle),
+        ANC_LIB_HANDLE_OFFSET(new_alert_cccd_handle), ANC_LIB_PENDING_NEW_ALERT_CCCD, WICED_TRUE, WICED_BT_ANC_NEW_ALERT_CCCD_READY,
+        anc_lib_decode_new_alert
+    },
+    [ANC_LIB_CHAR_SUPPORTED_NEW_CATEGORY] =
+    {
+        ANC_LIB_HANDLE_OFFSET(supported_new_alert_category_handle), ANC_LIB_HANDLE_OFFSET(supported_new_alert_category_value_handle),
+        ANC_LIB_NO_CCCD, 0, WICED_TRUE, ANC_LIB_NO_ITEM, NULL
+    },
+    [ANC_LIB_CHAR_SUPPORTED_UNREAD_CATEGORY] =
+    {
+        ANC_LIB_HANDLE_OFFSET(supported_unread_alert_category_handle), ANC_LIB_HANDLE_OFFSET(supported_unread_alert_category_value_handle),
+        ANC_LIB_NO_CCCD, 0, WICED_FALSE, ANC_LIB_NO_ITEM, NULL
+    },
+};
 
 /******************************************************
  *               Function Definitions
  ******************************************************/
-#if 0
-wiced_bool_t control_point_cache_alloc( uint8_t *index )
+static wiced_bool_t control_point_cache_alloc( anc_lib_cb_t *p_cb, uint8_t *index )
 {
-    uint8_t i;
+    if (p_cb->num_cp_write_req == MAX_SIMULTANIOUS_CONTROL_POINT_WRITES)
+        return FALSE;
+
+    *index = (p_cb->oldest_cp_write_req + p_cb->num_cp_write_req) % MAX_SIMULTANIOUS_CONTROL_POINT_WRITES;
+    p_cb->num_cp_write_req++;
 
-    for (i = 0; i < MAX_SIMULTANIOUS_CONTROL_POINT_WRITES; i++)
+    return TRUE;
+}
+
+static void control_point_cache_free_oldest( anc_lib_cb_t *p_cb )
+{
+    p_cb->control_alert_cmd_id[p_cb->oldest_cp_write_req] = 0;
+    p_cb->control_alert_catergory_id[p_cb->oldest_cp_write_req] = 0;
+    if (++p_cb->oldest_cp_write_req == MAX_SIMULTANIOUS_CONTROL_POINT_WRITES)
     {
-        if (anc_lib_data.control_alert_cmd_id[i++] == 0)
-            break;
-        if (i == MAX_SIMULTANIOUS_CONTROL_POINT_WRITES)
-            return FALSE;
+        p_cb->oldest_cp_write_req = 0;
     }
+    p_cb->num_cp_write_req--;
+    p_cb->cp_write_in_flight = 0;
+}
+/*
+ * Connection table helpers. The table is open addressed with linear probing, the
+ * start slot is derived from the conn_id so a lookup normally hits on the first probe.
+ */
+static uint8_t anc_lib_conn_hash( uint16_t conn_id )
+{
+    return (uint8_t)( ( conn_id ^ ( conn_id >> 8 ) ) & ANC_LIB_CONN_TABLE_MASK );
+}
 
-    *index = i;
+static anc_lib_cb_t *anc_lib_find_conn( uint16_t conn_id )
+{
+    uint8_t i, idx;
 
-    return TRUE;
+    if ( conn_id == 0 )
+        return NULL;
+
+    idx = anc_lib_conn_hash( conn_id );
+    for ( i = 0; i < ANC_LIB_CONN_TABLE_SIZE; i++ )
+    {
+        if ( anc_lib_data.conn[idx].conn_id == conn_id )
+            return &anc_lib_data.conn[idx];
+        if ( anc_lib_data.conn[idx].conn_id == 0 )
+            break;
+        idx = ( idx + 1 ) & ANC_LIB_CONN_TABLE_MASK;
+    }
+    return NULL;
 }
-#endif
-void wiced_bt_anc_utils_sort( uint16_t char_arr[], uint8_t len )
+
+static anc_lib_cb_t *anc_lib_alloc_conn( uint16_t conn_id )
 {
-    uint8_t i,j;
-    uint16_t temp;
+    anc_lib_cb_t *p_cb;
+    uint8_t idx;
+
+    if ( conn_id == 0 )
+        return NULL;
+
+    if ( ( p_cb = anc_lib_find_conn( conn_id ) ) != NULL )
+        return p_cb;
+
+    if ( anc_lib_data.num_connections >= ANC_LIB_MAX_CONNECTIONS )
+        return NULL;
+
+    idx = anc_lib_conn_hash( conn_id );
+    while ( anc_lib_data.conn[idx].conn_id != 0 )
+    {
+        idx = ( idx + 1 ) & ANC_LIB_CONN_TABLE_MASK;
+    }
 
-    for(i=0;i<len-1;i++)
+    p_cb = &anc_lib_data.conn[idx];
+    memset( p_cb, 0, sizeof(*p_cb) );
+    p_cb->conn_id = conn_id;
+    anc_lib_data.num_connections++;
+
+    return p_cb;
+}
+
+/*
+ * Release a slot. Entries that follow in the same probe run are shifted back so
+ * that lookups never need tombstones.
+ */
+static void anc_lib_free_conn( anc_lib_cb_t *p_cb )
+{
+    uint8_t hole = (uint8_t)( p_cb - anc_lib_data.conn );
+    uint8_t idx  = hole;
+    uint8_t home;
+
+    /* no new request is accepted while the pending ones complete */
+    p_cb->anc_current_state = ANC_CLIENT_STATE_IDLE;
+    anc_lib_fail_requests( p_cb, WICED_BT_GATT_ERROR );
+
+    if ( p_cb->p_read_buf != NULL )
+        wiced_bt_free_buffer( p_cb->p_read_buf );
+    if ( p_cb->p_late_read_buf != NULL )
+        wiced_bt_free_buffer( p_cb->p_late_read_buf );
+    memset( p_cb, 0, sizeof(*p_cb) );
+    anc_lib_data.num_connections--;
+
+    while ( 1 )
     {
-        for(j=0;j<len-i-1;j++)
+        idx = ( idx + 1 ) & ANC_LIB_CONN_TABLE_MASK;
+        if ( anc_lib_data.conn[idx].conn_id == 0 )
+            break;
+
+        home = anc_lib_conn_hash( anc_lib_data.conn[idx].conn_id );
+
+        /* move the entry into the hole if its home slot is not between the hole and its current slot */
+        if ( ( ( idx - home ) & ANC_LIB_CONN_TABLE_MASK ) >= ( ( idx - hole ) & ANC_LIB_CONN_TABLE_MASK ) )
         {
-            if( char_arr[j] > char_arr[j+1] )
-            {
-                temp = char_arr[j];
-                char_arr[j] = char_arr[j+1];
-                char_arr[j+1] = temp;
-            }
+            anc_lib_data.conn[hole] = anc_lib_data.conn[idx];
+            memset( &anc_lib_data.conn[idx], 0, sizeof(anc_lib_data.conn[idx]) );
+            hole = idx;
         }
     }
+    anc_lib_gatt_arm_timer();
 }
 
-wiced_result_t wiced_bt_anc_init(wiced_bt_anc_callback_t *p_callback)
+/* Forget everything learnt about the server, but keep the slot, the MTU, the setup timing,
+ * the requests of the application and what the stack still owes */
+static void anc_lib_reset_conn( anc_lib_cb_t *p_cb )
 {
-    memset(&anc_lib_data , 0, sizeof(anc_lib_data) );
+    uint16_t conn_id = p_cb->conn_id;
+    uint16_t mtu = p_cb->mtu;
+    anc_lib_setup_t setup = p_cb->setup;
+    anc_lib_request_t requests[ANC_LIB_MAX_REQUESTS];
+    uint8_t oldest_request = p_cb->oldest_request;
+    uint8_t num_requests = p_cb->num_requests;
+    uint8_t late_responses = p_cb->late_responses;
+    uint8_t *p_late_read_buf = p_cb->p_late_read_buf;
+
+    memcpy( requests, p_cb->requests, sizeof(requests) );
+    if ( p_cb->p_read_buf != NULL )
+        wiced_bt_free_buffer( p_cb->p_read_buf );
+    memset( p_cb, 0, sizeof(*p_cb) );
+    p_cb->conn_id = conn_id;
+    p_cb->mtu = mtu;
+    p_cb->setup = setup;
+    memcpy( p_cb->requests, requests, sizeof(requests) );
+    p_cb->oldest_request = oldest_request;
+    p_cb->num_requests = num_requests;
+    p_cb->late_responses = late_responses;
+    p_cb->p_late_read_buf = p_late_read_buf;
+}
 
-    anc_lib_data.p_callback = p_callback;
+/* End the running setup phase, if any, and start the next one */
+static void anc_lib_setup_phase( anc_lib_cb_t *p_cb, uint8_t next_phase )
+{
+    anc_lib_setup_t *p_setup = &p_cb->setup;
+    uint64_t now = clock_SystemTimeMicroseconds64();
 
-    return WICED_SUCCESS;
+    if ( p_setup->done )
+        return;
+
+    if ( p_setup->phase < WICED_BT_ANC_NUM_PHASES )
+    {
+        p_setup->stats.duration_us[p_setup->phase] = (uint32_t)( now - p_setup->phase_start_us );
+        ANC_LIB_TRACE_BIN(ANC_TRACE_LIB_SETUP_PHASE, p_cb->conn_id, p_setup->phase,
+                          p_setup->stats.duration_us[p_setup->phase], p_setup->stats.num_requests[p_setup->phase]);
+    }
+    p_setup->phase = next_phase;
+    p_setup->phase_start_us = now;
 }
 
-void wiced_bt_anc_client_connection_up(wiced_bt_gatt_connection_status_t *p_conn_status)
+/* Count a request sent during the running setup phase */
+static void anc_lib_setup_request( anc_lib_cb_t *p_cb, wiced_bt_gatt_status_t status )
 {
-    anc_lib_data.conn_id = p_conn_status->conn_id;
-    anc_lib_data.anc_current_state = ANC_CLIENT_STATE_CONNECTED;
+    if ( ( status == WICED_BT_GATT_SUCCESS ) && !p_cb->setup.done && ( p_cb->setup.phase < WICED_BT_ANC_NUM_PHASES ) )
+        p_cb->setup.stats.num_requests[p_cb->setup.phase]++;
 }
 
-void wiced_bt_anc_client_connection_down(wiced_bt_gatt_connection_status_t *p_conn_status)
+/* The server confirmed the first CCCD write, the setup is over */
+static void anc_lib_setup_subscribed( anc_lib_cb_t *p_cb )
 {
-    wiced_bt_anc_init(anc_lib_data.p_callback);
+    if ( p_cb->setup.done )
+        return;
+
+    anc_lib_setup_phase( p_cb, WICED_BT_ANC_NUM_PHASES );
+    p_cb->setup.done = 1;
+    p_cb->setup.stats.time_to_subscribed_us = (uint32_t)( clock_SystemTimeMicroseconds64() - p_cb->setup.connected_us );
+    ANC_LIB_TRACE_BIN(ANC_TRACE_LIB_SUBSCRIBED, p_cb->conn_id, p_cb->setup.stats.time_to_subscribed_us,
+                      p_cb->setup.stats.handles_from_cache, 0);
 }
 
-wiced_bt_gatt_status_t wiced_bt_anc_discover( uint16_t conn_id, uint16_t start_handle, uint16_t end_handle)
+static void anc_lib_notify( wiced_bt_anc_event_t event, wiced_bt_anc_event_data_t *p_event_data )
 {
-    if ((start_handle == 0) || (end_handle == 0))
-        return WICED_BT_GATT_INVALID_HANDLE;
+    anc_lib_cb_t *p_cb;
 
-    anc_lib_data.anc_e_handle = end_handle;
-    anc_lib_data.anc_current_state = ANC_CLIENT_STATE_CONNECTED;
+    /* a result may answer a request of the asynchronous API, every event structure starts with the conn_id */
+    if ( ( event >= WICED_BT_ANC_READ_SUPPORTED_NEW_ALERTS_RESULT ) && ( event <= WICED_BT_ANC_DISABLE_UNREAD_ALERTS_RESULT ) )
+    {
+        p_cb = anc_lib_find_conn( p_event_data->discovery_result.conn_id );
+        if ( ( p_cb != NULL ) && anc_lib_complete_request( p_cb, event, p_event_data ) )
+            return;
+    }
 
-    return wiced_bt_util_send_gatt_discover(conn_id, GATT_DISCOVER_CHARACTERISTICS, 0, start_handle, end_handle);
+    if ( anc_lib_data.p_callback != NULL )
+        anc_lib_data.p_callback( event, p_event_data );
 }
 
-/*
- * While application performs GATT discovery it shall pass discovery results for
- * for the handles that belong to ANP service, to this function.
- * Process discovery results from the stack.  We are looking for 3 characteristics
- * new alert source, unread alert source, and control point.  First 2 have client
- * configuration descriptors (CCCD).
- */
-void wiced_bt_anc_discovery_result(wiced_bt_gatt_discovery_result_t *p_data)
+/* A discovery procedure, the Service Changed subscription or the handle cache validation holds the bearer */
+static wiced_bool_t anc_lib_discovering( anc_lib_cb_t *p_cb )
 {
-    ANC_LIB_TRACE("[%s]\n",__FUNCTION__);
+    return ( p_cb->anc_current_state == ANC_CLIENT_STATE_DISCOVER_CHARACTERISTICS ) ||
+           ( p_cb->anc_current_state == ANC_CLIENT_STATE_DISCOVER_CCCD ) ||
+           ( p_cb->anc_current_state == ANC_CLIENT_STATE_DISCOVER_UNREAD_ALERT_CCCD ) ||
+           ( p_cb->anc_current_state == ANC_CLIENT_STATE_DISCOVER_GATT_SERVICE ) ||
+           ( p_cb->anc_current_state == ANC_CLIENT_STATE_DISCOVER_SERVICE_CHANGED ) ||
+           ( p_cb->anc_current_state == ANC_CLIENT_STATE_DISCOVER_SERVICE_CHANGED_CCCD ) ||
+           ( p_cb->anc_current_state == ANC_CLIENT_STATE_SET_SERVICE_CHANGED_CCCD ) ||
+           ( p_cb->anc_current_state == ANC_CLIENT_STATE_DISCOVER_SERVICE ) ||
+           ( p_cb->anc_current_state == ANC_CLIENT_STATE_VALIDATE_HANDLE_CACHE );
+}
+
+static void anc_lib_notify_progress( anc_lib_cb_t *p_cb, wiced_bt_anc_discovery_item_t item, uint16_t handle )
+{
+    wiced_bt_anc_event_data_t event_data;
+
+    event_data.discovery_progress.conn_id = p_cb->conn_id;
+    event_data.discovery_progress.item = item;
+    event_data.discovery_progress.handle = handle;
+    anc_lib_notify( WICED_BT_ANC_DISCOVERY_PROGRESS, &event_data );
+}
+
+/* Handle at an offset of the handle cache, see anc_lib_chars */
+static uint16_t *anc_lib_handle( anc_lib_cb_t *p_cb, uint8_t offset )
+{
+    return (uint16_t *)( (uint8_t *)&p_cb->handles + offset );
+}
+
+/* Entry of the ANS characteristic table for a discovered UUID, NULL when the UUID is not an ANS one */
+static const anc_lib_char_desc_t *anc_lib_char_desc( const wiced_bt_uuid_t *p_uuid )
+{
+    uint16_t idx;
 
-    uint16_t an_cp_uuid = UUID_CHARACTERISTIC_ALERT_NOTIFICATION_CONTROL_POINT;
-    uint16_t an_na_uuid = UUID_CHARACTERISTIC_NEW_ALERT;
-    uint16_t an_ua_uuid = UUID_CHARACTERISTIC_UNREAD_ALERT_STATUS;
-    uint16_t sup_na_uuid = UUID_CHARACTERISTIC_SUPPORTED_NEW_ALERT_CATEGORY;
-    uint16_t sup_ua_uuid = UUID_CHARACTERISTIC_SUPPORTED_UNREAD_ALERT_CATEGORY;
+    if ( p_uuid->len != LEN_UUID_16 )
+        return NULL;
 
-    if (p_data->discovery_type == GATT_DISCOVER_CHARACTERISTICS)
+    idx = (uint16_t)( p_uuid->uu.uuid16 - ANC_LIB_FIRST_CHAR_UUID );
+    return ( idx < ANC_LIB_NUM_CHARS ) ? &anc_lib_chars[idx] : NULL;
+}
+
+/* Declaration handle of the ANS characteristic that follows char_handle, 0 when it is the last one */
+static uint16_t anc_lib_next_char_handle( anc_lib_cb_t *p_cb, uint16_t char_handle )
+{
+    uint16_t next = 0;
+    uint16_t handle;
+    uint8_t i;
+
+    for ( i = 0; i < ANC_LIB_NUM_CHARS; i++ )
     {
-        // Result for characteristic discovery.  Save appropriate handle based on the UUID.
-        wiced_bt_gatt_char_declaration_t *p_char = &p_data->discovery_data.characteristic_declaration;
-        if(p_char->char_uuid.len == LEN_UUID_16)
-        {
-            if (memcmp(&p_char->char_uuid.uu.uuid16, &an_cp_uuid, 2) == 0)
-            {
-                anc_lib_data.alert_notify_control_point_char_handle = p_char->handle;
-                anc_lib_data.alert_notify_control_point_value_handle = p_char->val_handle;
-                ANC_LIB_TRACE("control hdl:%04x-%04x", anc_lib_data.alert_notify_control_point_char_handle, anc_lib_data.alert_notify_control_point_value_handle);
-            }
-            else if(memcmp(&p_char->char_uuid.uu.uuid16, &an_ua_uuid, 2) == 0)
-            {
-                anc_lib_data.unread_alert_char_handle = p_char->handle;
-                anc_lib_data.unread_alert_char_value_handle = p_char->val_handle;
-                ANC_LIB_TRACE("unread alert hdl:%04x-%04x", anc_lib_data.unread_alert_char_handle, anc_lib_data.unread_alert_char_value_handle);
-            }
-            else if(memcmp(&p_char->char_uuid.uu.uuid16, &an_na_uuid, 2) == 0)
-            {
-                anc_lib_data.new_alert_char_handle = p_char->handle;
-                anc_lib_data.new_alert_char_value_handle = p_char->val_handle;
-                ANC_LIB_TRACE("new alert hdl:%04x-%04x", anc_lib_data.new_alert_char_handle, anc_lib_data.new_alert_char_value_handle);
-            }
-            else if(memcmp(&p_char->char_uuid.uu.uuid16, &sup_na_uuid, 2) == 0)
-            {
-                anc_lib_data.supported_new_alert_category_handle = p_char->handle;
-                anc_lib_data.supported_new_alert_category_value_handle = p_char->val_handle;
-                ANC_LIB_TRACE("supported new alert category hdl:%04x-%04x", anc_lib_data.supported_new_alert_category_handle, anc_lib_data.supported_new_alert_category_value_handle);
-            }
-            else if(memcmp(&p_char->char_uuid.uu.uuid16, &sup_ua_uuid, 2) == 0)
-            {
-                anc_lib_data.supported_unread_alert_category_handle = p_char->handle;
-                anc_lib_data.supported_unread_alert_category_value_handle = p_char->val_handle;
-                ANC_LIB_TRACE("supported unread alert hdl:%04x-%04x", anc_lib_data.supported_unread_alert_category_handle, anc_lib_data.supported_unread_alert_category_value_handle);
-            }
-        }
+        handle = *anc_lib_handle( p_cb, anc_lib_chars[i].char_offset );
+        if ( ( handle > char_handle ) && ( ( next == 0 ) || ( handle < next ) ) )
+            next = handle;
     }
-    else if((p_data->discovery_type == GATT_DISCOVER_CHARACTERISTIC_DESCRIPTORS) &&
-            (p_data->discovery_data.char_descr_info.type.len == 2) &&
-            (p_data->discovery_data.char_descr_info.type.uu.uuid16 == UUID_DESCRIPTOR_CLIENT_CHARACTERISTIC_CONFIGURATION))
+    return next;
+}
+
+/* A descriptor belongs to the characteristic declared last before it, NULL when none is known */
+static const anc_lib_char_desc_t *anc_lib_descriptor_owner( anc_lib_cb_t *p_cb, uint16_t descr_handle )
+{
+    const anc_lib_char_desc_t *p_owner = NULL;
+    uint16_t owner_handle = 0;
+    uint16_t handle;
+    uint8_t i;
+
+    for ( i = 0; i < ANC_LIB_NUM_CHARS; i++ )
     {
-        // result for descriptor discovery, save appropriate handle based on the state
-        if( anc_lib_data.anc_current_state == ANC_CLIENT_STATE_DISCOVER_NEW_ALERT_CCCD )
-        {
-            anc_lib_data.new_alert_cccd_handle = p_data->discovery_data.char_descr_info.handle;
-            ANC_LIB_TRACE("new alert cccd_hdl hdl:%04x", anc_lib_data.new_alert_cccd_handle);
-        }
-        else if( anc_lib_data.anc_current_state == ANC_CLIENT_STATE_DISCOVER_UNREAD_ALERT_CCCD )
+        handle = *anc_lib_handle( p_cb, anc_lib_chars[i].value_offset );
+        if ( ( handle != 0 ) && ( handle < descr_handle ) && ( handle > owner_handle ) )
         {
-            anc_lib_data.unread_alert_cccd_handle = p_data->discovery_data.char_descr_info.handle;
-            ANC_LIB_TRACE("unread alert cccd_hdl hdl:%04x", anc_lib_data.unread_alert_cccd_handle);
+            owner_handle = handle;
+            p_owner = &anc_lib_chars[i];
         }
     }
+    return p_owner;
+}
+
+/* All the characteristics the discovery insists on have been found */
+static wiced_bool_t anc_lib_mandatory_chars_found( anc_lib_cb_t *p_cb )
+{
+    uint8_t i;
+
+    for ( i = 0; i < ANC_LIB_NUM_CHARS; i++ )
+    {
+        if ( anc_lib_chars[i].mandatory &&
+             ( ( *anc_lib_handle( p_cb, anc_lib_chars[i].char_offset ) == 0 ) ||
+               ( *anc_lib_handle( p_cb, anc_lib_chars[i].value_offset ) == 0 ) ) )
+            return WICED_FALSE;
+    }
+    return WICED_TRUE;
 }
 
 /*
- * While application performs GATT discovery it shall pass discovery complete callbacks
- * for the ANC service to the ANC Library. This function initiates the next discovery
- * request or write request to configure the ANC service on the iOS device.
+ * Range holding the descriptors of the characteristics in chars (ANC_LIB_CHAR_BIT), from the
+ * first value handle to the declaration that follows the last of them.
  */
-void wiced_bt_anc_client_discovery_complete(wiced_bt_gatt_discovery_complete_t *p_data)
+static void anc_lib_cccd_range( anc_lib_cb_t *p_cb, uint8_t chars, uint16_t *p_start_handle, uint16_t *p_end_handle )
 {
-    uint16_t start_handle;
+    uint16_t start_handle = 0xFFFF;
+    uint16_t last_char_handle = 0;
     uint16_t end_handle;
-    wiced_bt_anc_event_data_t event_data;
-    uint16_t char_handle_list[5];
-    uint8_t len,i,pos = 0;
+    uint16_t handle;
+    uint8_t i;
+
+    for ( i = 0; i < ANC_LIB_NUM_CHARS; i++ )
+    {
+        if ( !( chars & ANC_LIB_CHAR_BIT( i ) ) )
+            continue;
+        handle = *anc_lib_handle( p_cb, anc_lib_chars[i].value_offset );
+        if ( handle < start_handle )
+            start_handle = handle + 1;
+        handle = *anc_lib_handle( p_cb, anc_lib_chars[i].char_offset );
+        if ( handle > last_char_handle )
+            last_char_handle = handle;
+    }
+    end_handle = anc_lib_next_char_handle( p_cb, last_char_handle );
+
+    *p_start_handle = start_handle;
+    *p_end_handle = ( end_handle != 0 ) ? end_handle - 1 : p_cb->handles.anc_e_handle;
+}
+
+/*
+ * One Find Information pass covers the descriptors of the New Alert and/or Unread Alert
+ * Status characteristics. Each CCCD found is given to the characteristic declared last
+ * before it.
+ */
+static wiced_bt_gatt_status_t anc_lib_send_cccd_discovery( anc_lib_cb_t *p_cb, uint8_t chars )
+{
+    uint16_t start_handle, end_handle;
+    wiced_bt_gatt_status_t status;
+
+    if ( chars & ANC_LIB_CHAR_BIT( ANC_LIB_CHAR_UNREAD_ALERT ) )
+        p_cb->unread_cccd_searched = 1;
+    anc_lib_cccd_range( p_cb, chars, &start_handle, &end_handle );
+
+    p_cb->anc_current_state = ANC_CLIENT_STATE_DISCOVER_CCCD;
+    status = anc_lib_gatt_discover( p_cb, GATT_DISCOVER_CHARACTERISTIC_DESCRIPTORS, UUID_DESCRIPTOR_CLIENT_CHARACTERISTIC_CONFIGURATION,
+            start_handle, end_handle );
+    anc_lib_setup_request( p_cb, status );
+    return status;
+}
+
+static void anc_lib_set_route( anc_lib_cb_t *p_cb, uint16_t handle, uint8_t route )
+{
+    uint16_t offset = (uint16_t)( handle - p_cb->route_base );
 
-    ANC_LIB_TRACE("[%s] state:%d\n", __FUNCTION__, anc_lib_data.anc_current_state);
+    if ( ( handle != 0 ) && ( offset < ANC_LIB_ROUTE_MAP_SIZE ) )
+        p_cb->route_map[offset] = route;
+}
 
-    /* Maintain an array to get the range of descriptors */
-    char_handle_list[0] = anc_lib_data.new_alert_char_handle;
-    char_handle_list[1] = anc_lib_data.alert_notify_control_point_char_handle;
-    char_handle_list[2] = anc_lib_data.unread_alert_char_handle;
-    char_handle_list[3] = anc_lib_data.supported_new_alert_category_handle;
-    char_handle_list[4] = anc_lib_data.supported_unread_alert_category_handle;
-    len = sizeof(char_handle_list)/sizeof(char_handle_list[0]);
+/* Map the value and CCCD handles known now, called each time the handles settle */
+static void anc_lib_build_route_map( anc_lib_cb_t *p_cb )
+{
+    uint8_t i;
 
-    /* Sort the Array of Characteristic values to get the range */
-    wiced_bt_anc_utils_sort( char_handle_list, len );
+    memset( p_cb->route_map, ANC_LIB_ROUTE_NONE, sizeof(p_cb->route_map) );
+    p_cb->route_base = p_cb->handles.anc_s_handle;
 
-    if( p_data->discovery_type == GATT_DISCOVER_CHARACTERISTICS )
+    for ( i = 0; i < ANC_LIB_NUM_CHARS; i++ )
     {
-        // done with ANC characteristics, start reading descriptor handles
-        // make sure that all mandatory characteristics are present
-        if ((anc_lib_data.new_alert_char_handle == 0) ||
-            (anc_lib_data.new_alert_char_value_handle == 0) ||
-            (anc_lib_data.alert_notify_control_point_char_handle == 0) ||
-            (anc_lib_data.alert_notify_control_point_value_handle == 0) ||
-            (anc_lib_data.supported_new_alert_category_handle == 0) ||
-            (anc_lib_data.supported_new_alert_category_value_handle == 0) )
-        {
-            // something is very wrong
-            ANC_LIB_TRACE("[%s] failed\n", __FUNCTION__);
-            anc_lib_data.anc_current_state = ANC_CLIENT_STATE_IDLE;
-            wiced_bt_anc_init(anc_lib_data.p_callback);
-            event_data.discovery_result.conn_id = p_data->conn_id;
-            event_data.discovery_result.status = WICED_BT_GATT_NOT_FOUND;
-            anc_lib_data.p_callback(WICED_BT_ANC_DISCOVER_RESULT, &event_data);
-            return;
-        }
+        anc_lib_set_route( p_cb, *anc_lib_handle( p_cb, anc_lib_chars[i].value_offset ), ANC_LIB_ROUTE_VALUE( i ) );
+        if ( anc_lib_chars[i].cccd_offset != ANC_LIB_NO_CCCD )
+            anc_lib_set_route( p_cb, *anc_lib_handle( p_cb, anc_lib_chars[i].cccd_offset ), ANC_LIB_ROUTE_CCCD( i ) );
+    }
+}
 
-        /* Get the position of the new_alert handle in the sorted list */
-        for(i=0;i<5;i++)
-        {
-            if( char_handle_list[i] == anc_lib_data.new_alert_char_handle )
-            {
-                pos = i;
-            }
-        }
+/* Route of a handle past the route map */
+static uint8_t anc_lib_search_route( anc_lib_cb_t *p_cb, uint16_t handle )
+{
+    uint8_t i;
 
-        anc_lib_data.anc_current_state = ANC_CLIENT_STATE_DISCOVER_NEW_ALERT_CCCD;
-        start_handle = anc_lib_data.new_alert_char_handle + 1;
-        if( pos < 4 )
-        {
-            end_handle = char_handle_list[pos+1] - 1;
-        }
-        else
-        {
-            end_handle = anc_lib_data.anc_e_handle;
-        }
+    if ( handle == 0 )
+        return ANC_LIB_ROUTE_NONE;
 
-        wiced_bt_util_send_gatt_discover(p_data->conn_id, GATT_DISCOVER_CHARACTERISTIC_DESCRIPTORS, UUID_DESCRIPTOR_CLIENT_CHARACTERISTIC_CONFIGURATION,
-                start_handle , end_handle);
+    for ( i = 0; i < ANC_LIB_NUM_CHARS; i++ )
+    {
+        if ( *anc_lib_handle( p_cb, anc_lib_chars[i].value_offset ) == handle )
+            return ANC_LIB_ROUTE_VALUE( i );
+        if ( ( anc_lib_chars[i].cccd_offset != ANC_LIB_NO_CCCD ) && ( *anc_lib_handle( p_cb, anc_lib_chars[i].cccd_offset ) == handle ) )
+            return ANC_LIB_ROUTE_CCCD( i );
     }
-    else if(p_data->discovery_type == GATT_DISCOVER_CHARACTERISTIC_DESCRIPTORS)
+    return ANC_LIB_ROUTE_NONE;
+}
+
+/* Route of an incoming PDU, one load from the route map for the handles of the ANS */
+static uint8_t anc_lib_route( anc_lib_cb_t *p_cb, uint16_t handle )
+{
+    uint16_t offset = (uint16_t)( handle - p_cb->route_base );
+
+    if ( offset < ANC_LIB_ROUTE_MAP_SIZE )
+        return p_cb->route_map[offset];
+    return anc_lib_search_route( p_cb, handle );
+}
+
+/*
+ * GATT requests of the library. Each one gets a deadline, one timer runs for the earliest
+ * deadline over all connections. A request the server does not answer in time fails through
+ * the response handlers with WICED_BT_ANC_GATT_TIMEOUT so that the state of the connection
+ * never waits for it. ATT allows one request at a time, so the connection sends nothing more
+ * until the stack delivers the late response or the link goes down.
+ */
+static void anc_lib_gatt_arm_timer( void )
+{
+    anc_lib_cb_t *p_cb;
+    uint64_t next = 0, now;
+    uint8_t i;
+
+    for ( i = 0; i < ANC_LIB_CONN_TABLE_SIZE; i++ )
     {
-        if ( (anc_lib_data.anc_current_state == ANC_CLIENT_STATE_DISCOVER_NEW_ALERT_CCCD)
-              && (anc_lib_data.supported_unread_alert_category_handle != 0) )
-        {
-            /* Get the position of the unread_alert handle in the sorted list */
-            for(i=0; i<5; i++ )
-            {
-                if( char_handle_list[i] == anc_lib_data.unread_alert_char_handle )
-                {
-                    pos = i;
-                }
-            }
+        p_cb = &anc_lib_data.conn[i];
+        if ( ( p_cb->conn_id != 0 ) && ( p_cb->gatt_req.type != ANC_LIB_GATT_NONE ) && ( p_cb->gatt_req.deadline_us != 0 ) &&
+             ( ( next == 0 ) || ( p_cb->gatt_req.deadline_us < next ) ) )
+            next = p_cb->gatt_req.deadline_us;
+    }
 
-            anc_lib_data.anc_current_state = ANC_CLIENT_STATE_DISCOVER_UNREAD_ALERT_CCCD;
-            start_handle = anc_lib_data.unread_alert_char_handle + 1;
-            if( pos < 4 )
-            {
-                end_handle = char_handle_list[pos+1] - 1;
-            }
-            else
-            {
-                end_handle = anc_lib_data.anc_e_handle;
-            }
+    if ( next == 0 )
+    {
+        if ( wiced_is_timer_in_use( &anc_lib_data.gatt_timer ) )
+            wiced_stop_timer( &anc_lib_data.gatt_timer );
+        return;
+    }
 
-            wiced_bt_util_send_gatt_discover(p_data->conn_id, GATT_DISCOVER_CHARACTERISTIC_DESCRIPTORS, UUID_DESCRIPTOR_CLIENT_CHARACTERISTIC_CONFIGURATION,
-                                start_handle, end_handle);
-        }
-        else
-        {
-            // done with descriptor discovery.
-            anc_lib_data.anc_current_state = ANC_CLIENT_STATE_CONNECTED;
-            event_data.discovery_result.conn_id = p_data->conn_id;
-            if (anc_lib_data.new_alert_cccd_handle)
-                event_data.discovery_result.status = WICED_BT_GATT_SUCCESS;
-            else
-                event_data.discovery_result.status = WICED_BT_GATT_NOT_FOUND;
-            anc_lib_data.p_callback(WICED_BT_ANC_DISCOVER_RESULT, &event_data);
-        }
+    now = clock_SystemTimeMicroseconds64();
+    wiced_start_timer( &anc_lib_data.gatt_timer, ( next > now ) ? (uint32_t)( ( next - now + 999 ) / 1000 ) : 1 );
+}
+
+static wiced_bt_gatt_status_t anc_lib_gatt_send( anc_lib_cb_t *p_cb, anc_lib_gatt_req_t *p_req )
+{
+    wiced_bt_gatt_write_hdr_t write_header = { 0 };
+    wiced_bt_gatt_status_t status;
+    uint16_t handles[2];
+    uint8_t *p_write_req;
+
+    switch ( p_req->type )
+    {
+    case ANC_LIB_GATT_DISCOVER:
+        status = wiced_bt_util_send_gatt_discover( p_cb->conn_id, (wiced_bt_gatt_discovery_type_t)p_req->discovery_type, p_req->uuid,
+                                                   p_req->s_handle, p_req->e_handle );
+        break;
+    case ANC_LIB_GATT_READ:
+        status = wiced_bt_util_send_gatt_read_by_handle( p_cb->conn_id, p_req->s_handle, p_cb->p_read_buf, MAX_READ_LEN );
+        break;
+    case ANC_LIB_GATT_READ_BY_TYPE:
+        status = wiced_bt_util_send_gatt_read_by_type( p_cb->conn_id, p_req->s_handle, p_req->e_handle, p_req->uuid,
+                                                       p_cb->p_read_buf, MAX_READ_LEN );
+        break;
+    case ANC_LIB_GATT_READ_MULTIPLE:
+        handles[0] = p_req->s_handle;
+        handles[1] = p_req->e_handle;
+        status = wiced_bt_util_send_gatt_read_multiple( p_cb->conn_id, handles, 2, p_cb->p_read_buf, MAX_READ_LEN );
+        break;
+    case ANC_LIB_GATT_WRITE_CCCD:
+        status = wiced_bt_util_set_gatt_client_config_descriptor( p_cb->conn_id, p_req->s_handle, p_req->value[0] | ( p_req->value[1] << 8 ) );
+        break;
+    default:
+        p_write_req = wiced_bt_get_buffer( sizeof(p_req->value) );
+        if ( p_write_req == NULL )
+            return WICED_BT_GATT_NO_RESOURCES;
+
+        write_header.handle = p_req->s_handle;
+        write_header.offset = 0;
+        write_header.len = sizeof(p_req->value);
+        write_header.auth_req = GATT_AUTH_REQ_NONE;
+        memcpy( p_write_req, p_req->value, sizeof(p_req->value) );
+        status = wiced_bt_gatt_client_send_write( p_cb->conn_id, GATT_REQ_WRITE, &write_header, p_write_req, NULL );
+        wiced_bt_free_buffer( p_write_req );
+        break;
     }
+    return status;
 }
 
-wiced_bt_gatt_status_t wiced_bt_anc_read_server_supported_new_alerts( uint16_t conn_id )
+/* Send a request and start its deadline. A request the stack refuses leaves the one on the air, if any, untouched.
+ * While a response is owed for a request that timed out, the request is refused as busy without being sent */
+static wiced_bt_gatt_status_t anc_lib_gatt_start( anc_lib_cb_t *p_cb, anc_lib_gatt_req_t *p_req )
 {
-    wiced_bt_gatt_status_t status = WICED_BT_GATT_ERROR;
-    uint8_t *p_read = NULL;
-    p_read = wiced_bt_get_buffer(MAX_READ_LEN);
+    wiced_bt_gatt_status_t status;
+
+    if ( p_cb->late_responses != 0 )
+        return WICED_BT_GATT_BUSY;
+
+    status = anc_lib_gatt_send( p_cb, p_req );
+    if ( status != WICED_BT_GATT_SUCCESS )
+        return status;
+
+    p_req->deadline_us = ( anc_lib_data.gatt_timeout_ms == 0 ) ? 0 :
+                         clock_SystemTimeMicroseconds64() + (uint64_t)anc_lib_data.gatt_timeout_ms * 1000;
+    p_cb->gatt_req = *p_req;
+    anc_lib_gatt_arm_timer();
+    return status;
+}
+
+static wiced_bt_gatt_status_t anc_lib_gatt_discover( anc_lib_cb_t *p_cb, wiced_bt_gatt_discovery_type_t type, uint16_t uuid,
+                                                     uint16_t s_handle, uint16_t e_handle )
+{
+    anc_lib_gatt_req_t req = { 0 };
+
+    req.type = ANC_LIB_GATT_DISCOVER;
+    req.discovery_type = (uint8_t)type;
+    req.uuid = uuid;
+    req.s_handle = s_handle;
+    req.e_handle = e_handle;
+    return anc_lib_gatt_start( p_cb, &req );
+}
+
+/* Reads are made in p_cb->p_read_buf */
+static wiced_bt_gatt_status_t anc_lib_gatt_read( anc_lib_cb_t *p_cb, uint16_t handle )
+{
+    anc_lib_gatt_req_t req = { 0 };
+
+    req.type = ANC_LIB_GATT_READ;
+    req.s_handle = handle;
+    return anc_lib_gatt_start( p_cb, &req );
+}
+
+static wiced_bt_gatt_status_t anc_lib_gatt_read_by_type( anc_lib_cb_t *p_cb, uint16_t s_handle, uint16_t e_handle, uint16_t uuid )
+{
+    anc_lib_gatt_req_t req = { 0 };
+
+    req.type = ANC_LIB_GATT_READ_BY_TYPE;
+    req.s_handle = s_handle;
+    req.e_handle = e_handle;
+    req.uuid = uuid;
+    return anc_lib_gatt_start( p_cb, &req );
+}
+
+static wiced_bt_gatt_status_t anc_lib_gatt_read_multiple( anc_lib_cb_t *p_cb, uint16_t handle1, uint16_t handle2 )
+{
+    anc_lib_gatt_req_t req = { 0 };
+
+    req.type = ANC_LIB_GATT_READ_MULTIPLE;
+    req.s_handle = handle1;
+    req.e_handle = handle2;
+    return anc_lib_gatt_start( p_cb, &req );
+}
+
+static wiced_bt_gatt_status_t anc_lib_gatt_write_cccd( anc_lib_cb_t *p_cb, uint16_t handle, uint16_t value )
+{
+    anc_lib_gatt_req_t req = { 0 };
+
+    req.type = ANC_LIB_GATT_WRITE_CCCD;
+    req.s_handle = handle;
+    req.value[0] = (uint8_t)( value & 0xff );
+    req.value[1] = (uint8_t)( value >> 8 );
+    return anc_lib_gatt_start( p_cb, &req );
+}
+
+static wiced_bt_gatt_status_t anc_lib_gatt_write( anc_lib_cb_t *p_cb, uint16_t handle, uint8_t value0, uint8_t value1 )
+{
+    anc_lib_gatt_req_t req = { 0 };
+
+    req.type = ANC_LIB_GATT_WRITE;
+    req.s_handle = handle;
+    req.value[0] = value0;
+    req.value[1] = value1;
+    return anc_lib_gatt_start( p_cb, &req );
+}
+
+/* A response came back. Returns WICED_FALSE for the late response of a request that timed out,
+ * the connection then sends what waited for it */
+static wiced_bool_t anc_lib_gatt_response( anc_lib_cb_t *p_cb )
+{
+    if ( p_cb->gatt_req.type == ANC_LIB_GATT_NONE )
+    {
+        if ( p_cb->late_responses == 0 )
+            return WICED_TRUE;
+
+        ANC_LIB_TRACE("[%s] conn %d late response dropped\n", __FUNCTION__, p_cb->conn_id);
+        if ( --p_cb->late_responses == 0 )
+        {
+            if ( p_cb->p_late_read_buf != NULL )
+            {
+                wiced_bt_free_buffer( p_cb->p_late_read_buf );
+                p_cb->p_late_read_buf = NULL;
+            }
+            anc_lib_send_queued_writes( p_cb );
+        }
+        return WICED_FALSE;
+    }
+
+    p_cb->gatt_req.type = ANC_LIB_GATT_NONE;
+    anc_lib_gatt_arm_timer();
+    return WICED_TRUE;
+}
+
+/* A discovery request of the library timed out, the procedure ends as it does when nothing is found */
+static void anc_lib_discovery_timeout( anc_lib_cb_t *p_cb )
+{
+    wiced_bt_anc_event_data_t event_data;
+
+    switch ( p_cb->anc_current_state )
+    {
+    case ANC_CLIENT_STATE_DISCOVER_GATT_SERVICE:
+    case ANC_CLIENT_STATE_DISCOVER_SERVICE_CHANGED:
+    case ANC_CLIENT_STATE_DISCOVER_SERVICE_CHANGED_CCCD:
+        /* not tried again on this connection */
+        p_cb->anc_current_state = ANC_CLIENT_STATE_CONNECTED;
+        p_cb->service_changed_subscribed = 1;
+        anc_lib_send_queued_writes( p_cb );
+        break;
+
+    case ANC_CLIENT_STATE_DISCOVER_UNREAD_ALERT_CCCD:
+        /* the enable request waiting for the lazy search fails, the next one searches again */
+        p_cb->anc_current_state = ANC_CLIENT_STATE_CONNECTED;
+        p_cb->unread_cccd_searched = 0;
+        if ( p_cb->pending_cccd_writes & ANC_LIB_PENDING_UNREAD_ALERT_CCCD )
+        {
+            p_cb->pending_cccd_writes &= ~ANC_LIB_PENDING_UNREAD_ALERT_CCCD;
+            event_data.enable_disable_alerts_result.conn_id = p_cb->conn_id;
+            event_data.enable_disable_alerts_result.status = WICED_BT_ANC_GATT_TIMEOUT;
+            anc_lib_notify( WICED_BT_ANC_ENABLE_UNREAD_ALERTS_RESULT, &event_data );
+        }
+        anc_lib_send_queued_writes( p_cb );
+        break;
+
+    default:
+        if ( p_cb->rediscovering )
+        {
+            anc_lib_rediscovery_done( p_cb, WICED_BT_ANC_GATT_TIMEOUT );
+            break;
+        }
+        /* characteristics or descriptors of the discovery of the application */
+        p_cb->anc_current_state = ANC_CLIENT_STATE_CONNECTED;
+        anc_lib_setup_phase( p_cb, WICED_BT_ANC_NUM_PHASES );
+        anc_lib_build_route_map( p_cb );
+        anc_lib_send_queued_writes( p_cb );
+        event_data.discovery_result.conn_id = p_cb->conn_id;
+        event_data.discovery_result.status = WICED_BT_ANC_GATT_TIMEOUT;
+        anc_lib_notify( WICED_BT_ANC_DISCOVER_RESULT, &event_data );
+        break;
+    }
+}
+
+/* Give up the request on the air, its response handler reports WICED_BT_ANC_GATT_TIMEOUT. ATT allows no
+ * request after a transaction timeout, the link is taken down and the requests made by the handlers wait
+ * for the response owed by the stack or for the disconnection */
+static void anc_lib_gatt_failed( anc_lib_cb_t *p_cb )
+{
+    anc_lib_gatt_req_t req = p_cb->gatt_req;
+    wiced_bt_gatt_operation_complete_t rsp;
+    uint16_t conn_id = p_cb->conn_id;
+
+    ANC_LIB_TRACE("[%s] conn %d type %d handle %04x timed out\n", __FUNCTION__, conn_id, req.type, req.s_handle);
+
+    /* the request stays on the air for anc_lib_gatt_response, which takes the response below as its own */
+    p_cb->late_responses++;
+
+    memset( &rsp, 0, sizeof(rsp) );
+    rsp.conn_id = conn_id;
+    rsp.status = WICED_BT_ANC_GATT_TIMEOUT;
+
+    switch ( req.type )
+    {
+    case ANC_LIB_GATT_DISCOVER:
+        p_cb->gatt_req.type = ANC_LIB_GATT_NONE;
+        anc_lib_discovery_timeout( p_cb );
+        break;
+    case ANC_LIB_GATT_WRITE_CCCD:
+    case ANC_LIB_GATT_WRITE:
+        rsp.op = GATTC_OPTYPE_WRITE_WITH_RSP;
+        rsp.response_data.handle = req.s_handle;
+        wiced_bt_anc_write_rsp( &rsp );
+        break;
+    default:
+        /* the stack may still fill the buffer, it is kept until the response or the disconnection */
+        p_cb->p_late_read_buf = p_cb->p_read_buf;
+        p_cb->p_read_buf = NULL;
+        rsp.op = ( req.type == ANC_LIB_GATT_READ ) ? GATTC_OPTYPE_READ_HANDLE :
+                 ( req.type == ANC_LIB_GATT_READ_BY_TYPE ) ? GATTC_OPTYPE_READ_BY_TYPE : GATTC_OPTYPE_READ_MULTIPLE;
+        rsp.response_data.att_value.handle = req.s_handle;
+        wiced_bt_anc_read_rsp( &rsp );
+        break;
+    }
+
+    p_cb = anc_lib_find_conn( conn_id );
+    if ( p_cb != NULL )
+    {
+        p_cb->gatt_req.type = ANC_LIB_GATT_NONE;
+        ANC_LIB_TRACE("[%s] disconnecting conn %d\n", __FUNCTION__, conn_id);
+        wiced_bt_gatt_disconnect( conn_id );
+    }
+}
+
+static void anc_lib_gatt_timeout( WICED_TIMER_PARAM_TYPE param )
+{
+    uint16_t conn_ids[ANC_LIB_CONN_TABLE_SIZE];
+    uint64_t now = clock_SystemTimeMicroseconds64();
+    anc_lib_cb_t *p_cb;
+    uint8_t i, num = 0;
+
+    (void)param;
+
+    /* the handlers may free connections, which moves the others in the table */
+    for ( i = 0; i < ANC_LIB_CONN_TABLE_SIZE; i++ )
+    {
+        p_cb = &anc_lib_data.conn[i];
+        if ( ( p_cb->conn_id != 0 ) && ( p_cb->gatt_req.type != ANC_LIB_GATT_NONE ) &&
+             ( p_cb->gatt_req.deadline_us != 0 ) && ( p_cb->gatt_req.deadline_us <= now ) )
+            conn_ids[num++] = p_cb->conn_id;
+    }
+
+    for ( i = 0; i < num; i++ )
+    {
+        p_cb = anc_lib_find_conn( conn_ids[i] );
+        if ( ( p_cb != NULL ) && ( p_cb->gatt_req.type != ANC_LIB_GATT_NONE ) && ( p_cb->gatt_req.deadline_us <= now ) )
+            anc_lib_gatt_failed( p_cb );
+    }
+    anc_lib_gatt_arm_timer();
+}
+
+wiced_result_t wiced_bt_anc_init(wiced_bt_anc_callback_t *p_callback)
+{
+    if (wiced_is_timer_in_use(&anc_lib_data.gatt_timer))
+        wiced_stop_timer(&anc_lib_data.gatt_timer);
+    if (wiced_is_timer_in_use(&anc_lib_data.cached_timer))
+        wiced_stop_timer(&anc_lib_data.cached_timer);
+
+    memset(&anc_lib_data , 0, sizeof(anc_lib_data) );
+
+    anc_lib_data.p_callback = p_callback;
+    anc_lib_data.gatt_timeout_ms = ANC_LIB_GATT_TIMEOUT_MS;
+    wiced_init_timer(&anc_lib_data.gatt_timer, anc_lib_gatt_timeout, 0, WICED_MILLI_SECONDS_TIMER);
+    wiced_init_timer(&anc_lib_data.cached_timer, anc_lib_cached_timeout, 0, WICED_MILLI_SECONDS_TIMER);
+
+    return WICED_SUCCESS;
+}
+
+void wiced_bt_anc_set_gatt_timeout(uint32_t timeout_ms)
+{
+    anc_lib_data.gatt_timeout_ms = timeout_ms;
+}
+
+void wiced_bt_anc_set_alert_text_mode(wiced_bt_anc_alert_text_mode_t mode)
+{
+    anc_lib_data.alert_text_mode = mode;
+}
+
+void wiced_bt_anc_set_discovery_mode(wiced_bt_anc_discovery_mode_t mode)
+{
+    anc_lib_data.discovery_mode = mode;
+}
+
+void wiced_bt_anc_client_connection_up(wiced_bt_gatt_connection_status_t *p_conn_status)
+{
+    anc_lib_cb_t *p_cb = anc_lib_alloc_conn(p_conn_status->conn_id);
+
+    if (p_cb == NULL)
+    {
+        ANC_LIB_TRACE("[%s] no free slot for conn_id:%04x\n", __FUNCTION__, p_conn_status->conn_id);
+        return;
+    }
+    p_cb->mtu = GATT_DEF_BLE_MTU_SIZE;
+    p_cb->anc_current_state = ANC_CLIENT_STATE_CONNECTED;
+
+    p_cb->setup.connected_us = clock_SystemTimeMicroseconds64();
+    p_cb->setup.phase_start_us = p_cb->setup.connected_us;
+    p_cb->setup.phase = WICED_BT_ANC_PHASE_MTU_EXCHANGE;
+}
+
+void wiced_bt_anc_client_service_search_started(uint16_t conn_id)
+{
+    anc_lib_cb_t *p_cb = anc_lib_find_conn(conn_id);
+
+    if (p_cb == NULL)
+        return;
+
+    /* a fallback search is counted in the running phase */
+    if (p_cb->setup.phase != WICED_BT_ANC_PHASE_SERVICE_SEARCH)
+        anc_lib_setup_phase(p_cb, WICED_BT_ANC_PHASE_SERVICE_SEARCH);
+    anc_lib_setup_request(p_cb, WICED_BT_GATT_SUCCESS);
+}
+
+wiced_bool_t wiced_bt_anc_client_get_setup_stats(uint16_t conn_id, wiced_bt_anc_setup_stats_t *p_stats)
+{
+    anc_lib_cb_t *p_cb = anc_lib_find_conn(conn_id);
+
+    if ((p_cb == NULL) || (p_stats == NULL))
+        return WICED_FALSE;
+
+    memcpy(p_stats, &p_cb->setup.stats, sizeof(*p_stats));
+
+    /* the running phase reports the time spent so far */
+    if (!p_cb->setup.done && (p_cb->setup.phase < WICED_BT_ANC_NUM_PHASES))
+        p_stats->duration_us[p_cb->setup.phase] = (uint32_t)(clock_SystemTimeMicroseconds64() - p_cb->setup.phase_start_us);
+
+    return WICED_TRUE;
+}
+
+void wiced_bt_anc_client_set_mtu(uint16_t conn_id, uint16_t mtu)
+{
+    anc_lib_cb_t *p_cb = anc_lib_find_conn(conn_id);
+
+    if ((p_cb == NULL) || (mtu < GATT_DEF_BLE_MTU_SIZE))
+        return;
+
+    ANC_LIB_TRACE("[%s] conn_id:%04x mtu:%d\n", __FUNCTION__, conn_id, mtu);
+    p_cb->mtu = mtu;
+
+    /* the exchange may still be on the air when the handles come from the cache */
+    if (!p_cb->setup.done)
+        p_cb->setup.stats.num_requests[WICED_BT_ANC_PHASE_MTU_EXCHANGE]++;
+}
+
+uint16_t wiced_bt_anc_client_get_mtu(uint16_t conn_id)
+{
+    anc_lib_cb_t *p_cb = anc_lib_find_conn(conn_id);
+
+    return (p_cb != NULL) ? p_cb->mtu : GATT_DEF_BLE_MTU_SIZE;
+}
+
+void wiced_bt_anc_client_connection_down(wiced_bt_gatt_connection_status_t *p_conn_status)
+{
+    anc_lib_cb_t *p_cb = anc_lib_find_conn(p_conn_status->conn_id);
+
+    if (p_cb != NULL)
+        anc_lib_free_conn(p_cb);
+}
+
+wiced_bt_gatt_status_t wiced_bt_anc_discover( uint16_t conn_id, uint16_t start_handle, uint16_t end_handle)
+{
+    anc_lib_cb_t *p_cb = anc_lib_find_conn(conn_id);
+    wiced_bt_gatt_status_t status;
+
+    if (p_cb == NULL)
+        return WICED_BT_GATT_ERROR;
+
+    if ((start_handle == 0) || (end_handle == 0))
+        return WICED_BT_GATT_INVALID_HANDLE;
+
+    p_cb->handles.anc_s_handle = start_handle;
+    p_cb->handles.anc_e_handle = end_handle;
+    p_cb->anc_current_state = ANC_CLIENT_STATE_DISCOVER_CHARACTERISTICS;
+
+    anc_lib_setup_phase(p_cb, WICED_BT_ANC_PHASE_CHARACTERISTICS);
+    status = anc_lib_gatt_discover(p_cb, GATT_DISCOVER_CHARACTERISTICS, 0, start_handle, end_handle);
+    anc_lib_setup_request(p_cb, status);
+    if (status != WICED_BT_GATT_SUCCESS)
+        p_cb->anc_current_state = ANC_CLIENT_STATE_CONNECTED;
+
+    return status;
+}
+
+/*
+ * While application performs GATT discovery it shall pass discovery results for
+ * for the handles that belong to ANP service, to this function.
+ * Process discovery results from the stack.  We are looking for 3 characteristics
+ * new alert source, unread alert source, and control point.  First 2 have client
+ * configuration descriptors (CCCD).
+ */
+void wiced_bt_anc_discovery_result(wiced_bt_gatt_discovery_result_t *p_data)
+{
+    anc_lib_cb_t *p_cb = anc_lib_find_conn(p_data->conn_id);
+
+    ANC_LIB_TRACE("[%s]\n",__FUNCTION__);
+
+    if (p_cb == NULL)
+        return;
+
+    /* still from a discovery that timed out */
+    if ((p_cb->gatt_req.type == ANC_LIB_GATT_NONE) && (p_cb->late_responses != 0))
+        return;
+
+    if (p_data->discovery_type == GATT_DISCOVER_SERVICES_BY_UUID)
+    {
+        // GATT service holding Service Changed, or the ANS searched again after a Service Changed
+        wiced_bt_gatt_group_value_t *p_group = &p_data->discovery_data.group_value;
+
+        if (p_cb->anc_current_state == ANC_CLIENT_STATE_DISCOVER_GATT_SERVICE)
+        {
+            p_cb->sc_s_handle = p_group->s_handle;
+            p_cb->sc_e_handle = p_group->e_handle;
+        }
+        else if (p_cb->anc_current_state == ANC_CLIENT_STATE_DISCOVER_SERVICE)
+        {
+            p_cb->handles.anc_s_handle = p_group->s_handle;
+            p_cb->handles.anc_e_handle = p_group->e_handle;
+        }
+    }
+    else if ((p_data->discovery_type == GATT_DISCOVER_CHARACTERISTICS) &&
+             (p_cb->anc_current_state == ANC_CLIENT_STATE_DISCOVER_SERVICE_CHANGED))
+    {
+        // Service Changed, its descriptors end before the next characteristic
+        wiced_bt_gatt_char_declaration_t *p_char = &p_data->discovery_data.characteristic_declaration;
+
+        if ((p_char->char_uuid.len == LEN_UUID_16) && (p_char->char_uuid.uu.uuid16 == UUID_CHARACTERISTIC_SERVICE_CHANGED))
+        {
+            p_cb->handles.service_changed_value_handle = p_char->val_handle;
+            ANC_LIB_TRACE("service changed hdl:%04x-%04x", p_char->handle, p_char->val_handle);
+        }
+        else if ((p_cb->handles.service_changed_value_handle != 0) && (p_char->handle > p_cb->handles.service_changed_value_handle) &&
+                 (p_char->handle <= p_cb->sc_e_handle))
+        {
+            p_cb->sc_e_handle = p_char->handle - 1;
+        }
+    }
+    else if ((p_data->discovery_type == GATT_DISCOVER_CHARACTERISTIC_DESCRIPTORS) &&
+             (p_cb->anc_current_state == ANC_CLIENT_STATE_DISCOVER_SERVICE_CHANGED_CCCD))
+    {
+        if ((p_cb->handles.service_changed_cccd_handle == 0) &&
+            (p_data->discovery_data.char_descr_info.type.len == LEN_UUID_16) &&
+            (p_data->discovery_data.char_descr_info.type.uu.uuid16 == UUID_DESCRIPTOR_CLIENT_CHARACTERISTIC_CONFIGURATION))
+        {
+            p_cb->handles.service_changed_cccd_handle = p_data->discovery_data.char_descr_info.handle;
+            ANC_LIB_TRACE("service changed cccd hdl:%04x", p_cb->handles.service_changed_cccd_handle);
+        }
+    }
+    else if (p_data->discovery_type == GATT_DISCOVER_CHARACTERISTICS)
+    {
+        // Result for characteristic discovery.  Save the handles in the slots of the UUID.
+        wiced_bt_gatt_char_declaration_t *p_char = &p_data->discovery_data.characteristic_declaration;
+        const anc_lib_char_desc_t *p_desc = anc_lib_char_desc(&p_char->char_uuid);
+
+        if (p_desc != NULL)
+        {
+            *anc_lib_handle(p_cb, p_desc->char_offset) = p_char->handle;
+            *anc_lib_handle(p_cb, p_desc->value_offset) = p_char->val_handle;
+            ANC_LIB_TRACE("char %04x hdl:%04x-%04x", p_char->char_uuid.uu.uuid16, p_char->handle, p_char->val_handle);
+            if ((p_desc->cccd_offset == ANC_LIB_NO_CCCD) && (p_desc->ready_item != ANC_LIB_NO_ITEM))
+                anc_lib_notify_progress(p_cb, (wiced_bt_anc_discovery_item_t)p_desc->ready_item, p_char->val_handle);
+        }
+    }
+    else if((p_data->discovery_type == GATT_DISCOVER_CHARACTERISTIC_DESCRIPTORS) &&
+            (p_data->discovery_data.char_descr_info.type.len == 2) &&
+            (p_data->discovery_data.char_descr_info.type.uu.uuid16 == UUID_DESCRIPTOR_CLIENT_CHARACTERISTIC_CONFIGURATION))
+    {
+        // result for descriptor discovery, save appropriate handle based on the owning characteristic
+        uint16_t descr_handle = p_data->discovery_data.char_descr_info.handle;
+        const anc_lib_char_desc_t *p_desc = anc_lib_descriptor_owner(p_cb, descr_handle);
+
+        if ((p_desc != NULL) && (p_desc->cccd_offset != ANC_LIB_NO_CCCD))
+        {
+            *anc_lib_handle(p_cb, p_desc->cccd_offset) = descr_handle;
+            ANC_LIB_TRACE("cccd hdl:%04x of char hdl:%04x", descr_handle, *anc_lib_handle(p_cb, p_desc->char_offset));
+            anc_lib_notify_progress(p_cb, (wiced_bt_anc_discovery_item_t)p_desc->ready_item, descr_handle);
+        }
+    }
+}
+
+/*
+ * While application performs GATT discovery it shall pass discovery complete callbacks
+ * for the ANC service to the ANC Library. This function initiates the next discovery
+ * request or write request to configure the ANC service on the iOS device.
+ */
+void wiced_bt_anc_client_discovery_complete(wiced_bt_gatt_discovery_complete_t *p_data)
+{
+    wiced_bt_anc_event_data_t event_data;
+    wiced_bt_gatt_status_t status;
+    wiced_bool_t unread_alert;
+    anc_lib_cb_t *p_cb = anc_lib_find_conn(p_data->conn_id);
+
+    if ((p_cb == NULL) || !anc_lib_gatt_response(p_cb))
+        return;
+
+    ANC_LIB_TRACE("[%s] state:%d\n", __FUNCTION__, p_cb->anc_current_state);
+
+    if( ( p_cb->anc_current_state == ANC_CLIENT_STATE_DISCOVER_GATT_SERVICE ) ||
+        ( p_cb->anc_current_state == ANC_CLIENT_STATE_DISCOVER_SERVICE_CHANGED ) ||
+        ( p_cb->anc_current_state == ANC_CLIENT_STATE_DISCOVER_SERVICE_CHANGED_CCCD ) )
+    {
+        anc_lib_service_changed_discovery_complete(p_cb);
+    }
+    else if( p_cb->anc_current_state == ANC_CLIENT_STATE_DISCOVER_SERVICE )
+    {
+        // ANS searched again after a Service Changed covering its declaration
+        if (p_cb->handles.anc_s_handle == 0)
+        {
+            p_cb->pending_cccd_writes = 0;
+            anc_lib_rediscovery_done(p_cb, WICED_BT_GATT_NOT_FOUND);
+            return;
+        }
+        p_cb->anc_current_state = ANC_CLIENT_STATE_DISCOVER_CHARACTERISTICS;
+        status = anc_lib_gatt_discover(p_cb, GATT_DISCOVER_CHARACTERISTICS, 0,
+                p_cb->handles.anc_s_handle, p_cb->handles.anc_e_handle);
+        if (status != WICED_BT_GATT_SUCCESS)
+            anc_lib_rediscovery_done(p_cb, status);
+    }
+    else if( p_data->discovery_type == GATT_DISCOVER_CHARACTERISTICS )
+    {
+        // done with ANC characteristics, start reading descriptor handles
+        // make sure that all mandatory characteristics are present
+        if (!anc_lib_mandatory_chars_found(p_cb))
+        {
+            // something is very wrong
+            ANC_LIB_TRACE("[%s] failed\n", __FUNCTION__);
+            anc_lib_setup_phase(p_cb, WICED_BT_ANC_NUM_PHASES);
+            anc_lib_reset_conn(p_cb);
+            p_cb->anc_current_state = ANC_CLIENT_STATE_IDLE;
+            event_data.discovery_result.conn_id = p_data->conn_id;
+            event_data.discovery_result.status = WICED_BT_GATT_NOT_FOUND;
+            anc_lib_notify(WICED_BT_ANC_DISCOVER_RESULT, &event_data);
+            anc_lib_fail_requests(p_cb, WICED_BT_GATT_NOT_FOUND);
+            return;
+        }
+
+        /* In lazy mode the Unread Alert Status descriptors wait for wiced_bt_anc_enable_unread_alerts */
+        unread_alert = ( p_cb->handles.unread_alert_char_value_handle != 0 ) &&
+                       ( p_cb->unread_cccd_searched || ( anc_lib_data.discovery_mode == WICED_BT_ANC_DISCOVERY_EAGER ) );
+
+        if ( p_cb->rediscovering )
+        {
+            /* only the descriptors dropped with the changed range are searched again */
+            unread_alert = unread_alert && ( p_cb->handles.unread_alert_cccd_handle == 0 );
+            if ( ( p_cb->handles.new_alert_cccd_handle != 0 ) && !unread_alert )
+            {
+                anc_lib_rediscovery_done(p_cb, WICED_BT_GATT_SUCCESS);
+                return;
+            }
+            status = anc_lib_send_cccd_discovery(p_cb,
+                    ((p_cb->handles.new_alert_cccd_handle == 0) ? ANC_LIB_CHAR_BIT(ANC_LIB_CHAR_NEW_ALERT) : 0) |
+                    (unread_alert ? ANC_LIB_CHAR_BIT(ANC_LIB_CHAR_UNREAD_ALERT) : 0));
+            if (status != WICED_BT_GATT_SUCCESS)
+                anc_lib_rediscovery_done(p_cb, status);
+            return;
+        }
+
+        anc_lib_setup_phase(p_cb, WICED_BT_ANC_PHASE_DESCRIPTORS);
+        status = anc_lib_send_cccd_discovery(p_cb, ANC_LIB_CHAR_BIT(ANC_LIB_CHAR_NEW_ALERT) |
+                (unread_alert ? ANC_LIB_CHAR_BIT(ANC_LIB_CHAR_UNREAD_ALERT) : 0));
+        if (status != WICED_BT_GATT_SUCCESS)
+        {
+            p_cb->anc_current_state = ANC_CLIENT_STATE_CONNECTED;
+            anc_lib_setup_phase(p_cb, WICED_BT_ANC_NUM_PHASES);
+            event_data.discovery_result.conn_id = p_data->conn_id;
+            event_data.discovery_result.status = status;
+            anc_lib_notify(WICED_BT_ANC_DISCOVER_RESULT, &event_data);
+        }
+    }
+    else if( ( p_data->discovery_type == GATT_DISCOVER_CHARACTERISTIC_DESCRIPTORS ) &&
+             ( p_cb->anc_current_state == ANC_CLIENT_STATE_DISCOVER_UNREAD_ALERT_CCCD ) )
+    {
+        // done with the lazy search, the enable request waits for it
+        p_cb->anc_current_state = ANC_CLIENT_STATE_CONNECTED;
+        anc_lib_build_route_map(p_cb);
+        anc_lib_send_queued_writes(p_cb);
+    }
+    else if(p_data->discovery_type == GATT_DISCOVER_CHARACTERISTIC_DESCRIPTORS)
+    {
+        // done with descriptor discovery.
+        p_cb->anc_current_state = ANC_CLIENT_STATE_CONNECTED;
+        event_data.discovery_result.conn_id = p_data->conn_id;
+        if (p_cb->handles.new_alert_cccd_handle)
+            event_data.discovery_result.status = WICED_BT_GATT_SUCCESS;
+        else
+            event_data.discovery_result.status = WICED_BT_GATT_NOT_FOUND;
+        if (p_cb->rediscovering)
+        {
+            anc_lib_rediscovery_done(p_cb, event_data.discovery_result.status);
+            return;
+        }
+        anc_lib_setup_phase(p_cb, (event_data.discovery_result.status == WICED_BT_GATT_SUCCESS) ?
+                                  WICED_BT_ANC_PHASE_FIRST_CCCD_WRITE : WICED_BT_ANC_NUM_PHASES);
+        anc_lib_build_route_map(p_cb);
+        /* writes requested on the progress events go first */
+        anc_lib_send_queued_writes(p_cb);
+        anc_lib_notify(WICED_BT_ANC_DISCOVER_RESULT, &event_data);
+    }
+}
+
+wiced_bool_t wiced_bt_anc_get_handle_cache( uint16_t conn_id, wiced_bt_anc_handle_cache_t *p_cache )
+{
+    anc_lib_cb_t *p_cb = anc_lib_find_conn(conn_id);
+
+    if ( ( p_cb == NULL ) || ( p_cache == NULL ) || ( p_cb->handles.new_alert_cccd_handle == 0 ) )
+        return WICED_FALSE;
+
+    memcpy( p_cache, &p_cb->handles, sizeof(*p_cache) );
+    return WICED_TRUE;
+}
+
+/*
+ * Handles saved on a previous connection are only accepted if everything the
+ * discovery would have insisted on is present and inside the service range.
+ */
+static wiced_bool_t anc_lib_handle_cache_usable( const wiced_bt_anc_handle_cache_t *p_cache )
+{
+    return ( p_cache->anc_s_handle != 0 ) && ( p_cache->anc_e_handle >= p_cache->anc_s_handle ) &&
+           ( p_cache->new_alert_char_value_handle > p_cache->anc_s_handle ) &&
+           ( p_cache->new_alert_cccd_handle <= p_cache->anc_e_handle ) &&
+           ( p_cache->new_alert_cccd_handle > p_cache->new_alert_char_value_handle ) &&
+           ( p_cache->alert_notify_control_point_value_handle != 0 ) &&
+           ( p_cache->supported_new_alert_category_value_handle != 0 );
+}
+
+wiced_bt_gatt_status_t wiced_bt_anc_restore_handle_cache( uint16_t conn_id, const wiced_bt_anc_handle_cache_t *p_cache )
+{
+    anc_lib_cb_t *p_cb = anc_lib_find_conn(conn_id);
+
+    if ( ( p_cb == NULL ) || ( p_cache == NULL ) )
+        return WICED_BT_GATT_ERROR;
+
+    if ( !anc_lib_handle_cache_usable( p_cache ) )
+        return WICED_BT_GATT_INVALID_HANDLE;
+
+    memcpy( &p_cb->handles, p_cache, sizeof(p_cb->handles) );
+    anc_lib_build_route_map( p_cb );
+    p_cb->anc_current_state = ANC_CLIENT_STATE_CONNECTED;
+
+    p_cb->setup.stats.handles_from_cache = WICED_TRUE;
+    anc_lib_setup_phase( p_cb, WICED_BT_ANC_PHASE_FIRST_CCCD_WRITE );
+
+    ANC_LIB_TRACE("[%s] conn_id:%04x ANS %04x-%04x\n", __FUNCTION__, conn_id, p_cache->anc_s_handle, p_cache->anc_e_handle);
+    return WICED_BT_GATT_SUCCESS;
+}
+
+/* Read By Type of the Database Hash over the whole database, its handle is not kept */
+static wiced_bt_gatt_status_t anc_lib_read_database_hash( anc_lib_cb_t *p_cb )
+{
+    wiced_bt_gatt_status_t status;
+
+    p_cb->p_read_buf = (uint8_t *)wiced_bt_get_buffer( MAX_READ_LEN );
+    if ( p_cb->p_read_buf == NULL )
+        return WICED_BT_GATT_NO_RESOURCES;
+
+    p_cb->read_by_type_uuid = UUID_CHARACTERISTIC_DATABASE_HASH;
+    status = anc_lib_gatt_read_by_type( p_cb, 0x0001, 0xFFFF, UUID_CHARACTERISTIC_DATABASE_HASH );
+    anc_lib_setup_request( p_cb, status );
+
+    if ( status != WICED_BT_GATT_SUCCESS )
+    {
+        wiced_bt_free_buffer( p_cb->p_read_buf );
+        p_cb->p_read_buf = NULL;
+        p_cb->read_by_type_uuid = 0;
+    }
+    return status;
+}
+
+/*
+ * The handles are taken while the hash is read so that requests made meanwhile are
+ * queued, and are dropped if the hash does not match.
+ */
+wiced_bt_gatt_status_t wiced_bt_anc_validate_handle_cache( uint16_t conn_id, const wiced_bt_anc_handle_cache_t *p_cache )
+{
+    static const uint8_t no_hash[WICED_BT_ANC_DATABASE_HASH_LEN] = { 0 };
+    anc_lib_cb_t *p_cb = anc_lib_find_conn(conn_id);
+    wiced_bt_gatt_status_t status;
+
+    if ( ( p_cb == NULL ) || ( p_cache == NULL ) )
+        return WICED_BT_GATT_ERROR;
+
+    if ( memcmp( p_cache->database_hash, no_hash, sizeof(no_hash) ) == 0 )
+        return WICED_BT_GATT_NOT_FOUND;
+
+    if ( !anc_lib_handle_cache_usable( p_cache ) )
+        return WICED_BT_GATT_INVALID_HANDLE;
+
+    if ( ( p_cb->p_read_buf != NULL ) || ( p_cb->anc_current_state != ANC_CLIENT_STATE_CONNECTED ) )
+        return WICED_BT_GATT_BUSY;
+
+    anc_lib_setup_phase( p_cb, WICED_BT_ANC_PHASE_SERVICE_SEARCH );
+    status = anc_lib_read_database_hash( p_cb );
+    if ( status != WICED_BT_GATT_SUCCESS )
+        return status;
+
+    memcpy( &p_cb->handles, p_cache, sizeof(p_cb->handles) );
+    anc_lib_build_route_map( p_cb );
+    p_cb->anc_current_state = ANC_CLIENT_STATE_VALIDATE_HANDLE_CACHE;
+
+    ANC_LIB_TRACE("[%s] conn_id:%04x ANS %04x-%04x\n", __FUNCTION__, conn_id, p_cache->anc_s_handle, p_cache->anc_e_handle);
+    return WICED_BT_GATT_SUCCESS;
+}
+
+/* Database Hash read to validate the handle cache, or to be saved with the handles */
+static void anc_lib_database_hash_rsp( anc_lib_cb_t *p_cb, wiced_bt_gatt_operation_complete_t *p_data )
+{
+    wiced_bt_anc_event_data_t event_data;
+    wiced_bool_t valid = ( p_data->status == WICED_BT_GATT_SUCCESS ) &&
+                         ( p_data->response_data.att_value.p_data != NULL ) &&
+                         ( p_data->response_data.att_value.len == WICED_BT_ANC_DATABASE_HASH_LEN );
+    wiced_bool_t matched = WICED_FALSE;
+
+    ANC_LIB_TRACE("[%s] conn_id:%04x status:%d len:%d\n", __FUNCTION__, p_cb->conn_id, p_data->status,
+                  p_data->response_data.att_value.len);
+
+    p_cb->database_hash_read = 1;
+    if ( p_cb->anc_current_state == ANC_CLIENT_STATE_VALIDATE_HANDLE_CACHE )
+        matched = valid && ( memcmp( p_data->response_data.att_value.p_data, p_cb->handles.database_hash, WICED_BT_ANC_DATABASE_HASH_LEN ) == 0 );
+    else if ( valid )
+        memcpy( p_cb->handles.database_hash, p_data->response_data.att_value.p_data, WICED_BT_ANC_DATABASE_HASH_LEN );
+
+    if ( p_cb->p_read_buf != NULL )
+        wiced_bt_free_buffer( p_cb->p_read_buf );
+    p_cb->p_read_buf = NULL;
+
+    if ( p_cb->anc_current_state != ANC_CLIENT_STATE_VALIDATE_HANDLE_CACHE )
+    {
+        if ( valid )
+            anc_lib_notify_progress( p_cb, WICED_BT_ANC_DATABASE_HASH_READY, p_data->response_data.att_value.handle );
+        anc_lib_send_queued_writes( p_cb );
+        return;
+    }
+
+    p_cb->anc_current_state = ANC_CLIENT_STATE_CONNECTED;
+    event_data.discovery_result.conn_id = p_cb->conn_id;
+    if ( matched )
+    {
+        p_cb->setup.stats.handles_from_cache = WICED_TRUE;
+        anc_lib_setup_phase( p_cb, WICED_BT_ANC_PHASE_FIRST_CCCD_WRITE );
+        event_data.discovery_result.status = WICED_BT_GATT_SUCCESS;
+        anc_lib_send_queued_writes( p_cb );
+    }
+    else
+    {
+        /* the queued requests wait for the discovery of the application */
+        memset( &p_cb->handles, 0, sizeof(p_cb->handles) );
+        anc_lib_build_route_map( p_cb );
+        p_cb->database_hash_read = 0;
+        if ( valid )
+            event_data.discovery_result.status = WICED_BT_GATT_DATABASE_OUT_OF_SYNC;
+        else if ( p_data->status != WICED_BT_GATT_SUCCESS )
+            event_data.discovery_result.status = p_data->status;
+        else
+            event_data.discovery_result.status = WICED_BT_GATT_INVALID_ATTR_LEN;
+    }
+    anc_lib_notify( WICED_BT_ANC_DISCOVER_RESULT, &event_data );
+}
+
+/* Read the Database Hash to save it with the handles, once nothing else waits for the bearer */
+static void anc_lib_update_database_hash( anc_lib_cb_t *p_cb )
+{
+    wiced_bt_gatt_status_t status;
+
+    if ( p_cb->database_hash_read || !p_cb->service_changed_subscribed || !p_cb->setup.done ||
+         ( p_cb->anc_current_state != ANC_CLIENT_STATE_CONNECTED ) || ( p_cb->p_read_buf != NULL ) ||
+         p_cb->cp_write_in_flight || p_cb->pending_cccd_writes )
+        return;
+
+    status = anc_lib_read_database_hash( p_cb );
+    /* another request is on the air, try again with its response */
+    if ( ( status != WICED_BT_GATT_SUCCESS ) && ( status != WICED_BT_GATT_BUSY ) )
+        p_cb->database_hash_read = 1;
+}
+
+void wiced_bt_anc_client_service_found(uint16_t conn_id, uint16_t start_handle, uint16_t end_handle)
+{
+    anc_lib_cb_t *p_cb = anc_lib_find_conn(conn_id);
+
+    if ((p_cb == NULL) || (start_handle == 0) || (end_handle < start_handle))
+        return;
+
+    p_cb->handles.anc_s_handle = start_handle;
+    p_cb->handles.anc_e_handle = end_handle;
+}
+
+void wiced_bt_anc_client_service_changed(uint16_t conn_id, uint16_t start_handle, uint16_t end_handle)
+{
+    anc_lib_cb_t *p_cb = anc_lib_find_conn(conn_id);
+
+    if (p_cb == NULL)
+        return;
+
+    ANC_LIB_TRACE("[%s] conn %d range %04x-%04x\n", __FUNCTION__, conn_id, start_handle, end_handle);
+
+    /* the hash covers the whole database, read it again */
+    memset(p_cb->handles.database_hash, 0, sizeof(p_cb->handles.database_hash));
+    p_cb->database_hash_read = 0;
+
+    /* the supported categories may have changed with the ANS */
+    if ((p_cb->handles.anc_s_handle == 0) ||
+        ((start_handle <= p_cb->handles.anc_e_handle) && (end_handle >= p_cb->handles.anc_s_handle)))
+    {
+        p_cb->categories_cached = 0;
+    }
+
+    /* handles inside the ANS are discovered again, ranges received meanwhile are merged */
+    if ((p_cb->handles.anc_s_handle != 0) && (start_handle != 0) && (end_handle >= start_handle) &&
+        (start_handle <= p_cb->handles.anc_e_handle) && (end_handle >= p_cb->handles.anc_s_handle))
+    {
+        if ((p_cb->changed_s_handle == 0) || (start_handle < p_cb->changed_s_handle))
+            p_cb->changed_s_handle = start_handle;
+        if (end_handle > p_cb->changed_e_handle)
+            p_cb->changed_e_handle = end_handle;
+        anc_lib_start_rediscovery(p_cb);
+    }
+}
+
+void wiced_bt_anc_client_process_indication(wiced_bt_gatt_operation_complete_t *p_data)
+{
+    anc_lib_cb_t *p_cb = anc_lib_find_conn(p_data->conn_id);
+    uint8_t *p_value = p_data->response_data.att_value.p_data;
+
+    if ((p_cb == NULL) || (p_value == NULL) || (p_data->response_data.att_value.len < 4))
+        return;
+
+    /* by handle only, indications of other profiles are 4 bytes long too. Until the handle is
+     * known the library has not subscribed, and cached handles are checked with the Database Hash */
+    if ((p_cb->handles.service_changed_value_handle == 0) ||
+        (p_data->response_data.att_value.handle != p_cb->handles.service_changed_value_handle))
+        return;
+
+    wiced_bt_anc_client_service_changed(p_data->conn_id, p_value[0] | (p_value[1] << 8), p_value[2] | (p_value[3] << 8));
+}
+
+static wiced_bool_t anc_lib_in_range( uint16_t handle, uint16_t start_handle, uint16_t end_handle )
+{
+    return ( handle != 0 ) && ( handle >= start_handle ) && ( handle <= end_handle );
+}
+
+/* Drop the handles inside a changed range. Alerts enabled on a dropped CCCD are enabled
+ * again once the rediscovery found it */
+static void anc_lib_forget_handles( anc_lib_cb_t *p_cb, uint16_t start_handle, uint16_t end_handle )
+{
+    wiced_bt_anc_handle_cache_t *p_handles = &p_cb->handles;
+    const anc_lib_char_desc_t *p_desc;
+    uint16_t *p_char, *p_value, *p_cccd;
+    uint8_t enabled;
+    uint8_t i;
+
+    for ( i = 0; i < ANC_LIB_NUM_CHARS; i++ )
+    {
+        p_desc = &anc_lib_chars[i];
+        p_char = anc_lib_handle( p_cb, p_desc->char_offset );
+        p_value = anc_lib_handle( p_cb, p_desc->value_offset );
+
+        if ( anc_lib_in_range( *p_char, start_handle, end_handle ) || anc_lib_in_range( *p_value, start_handle, end_handle ) )
+        {
+            *p_char = 0;
+            *p_value = 0;
+        }
+        if ( p_desc->cccd_offset == ANC_LIB_NO_CCCD )
+            continue;
+
+        p_cccd = anc_lib_handle( p_cb, p_desc->cccd_offset );
+        if ( ( *p_value == 0 ) || anc_lib_in_range( *p_cccd, start_handle, end_handle ) )
+        {
+            enabled = ( p_desc->pending_cccd_write == ANC_LIB_PENDING_NEW_ALERT_CCCD ) ? p_cb->enabled_new_alerts : p_cb->enabled_unread_alerts;
+            if ( ( *p_cccd != 0 ) && enabled )
+                p_cb->pending_cccd_writes |= p_desc->pending_cccd_write;
+            *p_cccd = 0;
+        }
+    }
+
+    /* the GATT service changed too, subscribe again */
+    if ( anc_lib_in_range( p_handles->service_changed_value_handle, start_handle, end_handle ) ||
+         anc_lib_in_range( p_handles->service_changed_cccd_handle, start_handle, end_handle ) )
+    {
+        p_handles->service_changed_value_handle = 0;
+        p_handles->service_changed_cccd_handle = 0;
+        p_cb->service_changed_subscribed = 0;
+    }
+
+    anc_lib_build_route_map( p_cb );
+}
+
+/*
+ * Look again at the part of the ANS covered by Service Changed indications, once the
+ * bearer is free. Characteristics are searched in that part only, unless it covers the
+ * service declaration: the ANS may have moved and is searched again first.
+ */
+static wiced_bool_t anc_lib_start_rediscovery( anc_lib_cb_t *p_cb )
+{
+    uint16_t start_handle = p_cb->changed_s_handle;
+    uint16_t end_handle = p_cb->changed_e_handle;
+    wiced_bt_gatt_status_t status;
+
+    if ( ( start_handle == 0 ) || ( p_cb->anc_current_state != ANC_CLIENT_STATE_CONNECTED ) ||
+         ( p_cb->p_read_buf != NULL ) || p_cb->cp_write_in_flight )
+        return WICED_FALSE;
+
+    if ( start_handle <= p_cb->handles.anc_s_handle )
+    {
+        p_cb->anc_current_state = ANC_CLIENT_STATE_DISCOVER_SERVICE;
+        status = anc_lib_gatt_discover( p_cb, GATT_DISCOVER_SERVICES_BY_UUID, UUID_SERVICE_ALERT_NOTIFICATION, 1, 0xFFFF );
+    }
+    else
+    {
+        p_cb->anc_current_state = ANC_CLIENT_STATE_DISCOVER_CHARACTERISTICS;
+        status = anc_lib_gatt_discover( p_cb, GATT_DISCOVER_CHARACTERISTICS, 0, start_handle,
+                ( end_handle < p_cb->handles.anc_e_handle ) ? end_handle : p_cb->handles.anc_e_handle );
+    }
+    ANC_LIB_TRACE("[%s] conn %d range %04x-%04x status %d\n", __FUNCTION__, p_cb->conn_id, start_handle, end_handle, status);
+
+    if ( status != WICED_BT_GATT_SUCCESS )
+    {
+        p_cb->anc_current_state = ANC_CLIENT_STATE_CONNECTED;
+        /* another request is on the air, the range is tried again with its response */
+        if ( status == WICED_BT_GATT_BUSY )
+            return WICED_FALSE;
+        p_cb->changed_s_handle = 0;
+        p_cb->changed_e_handle = 0;
+        return WICED_FALSE;
+    }
+
+    p_cb->changed_s_handle = 0;
+    p_cb->changed_e_handle = 0;
+    p_cb->rediscovering = 1;
+    anc_lib_forget_handles( p_cb, start_handle, end_handle );
+    if ( p_cb->anc_current_state == ANC_CLIENT_STATE_DISCOVER_SERVICE )
+    {
+        p_cb->handles.anc_s_handle = 0;
+        p_cb->handles.anc_e_handle = 0;
+    }
+    return WICED_TRUE;
+}
+
+/* End of a rediscovery, the alerts enabled on dropped descriptors are enabled again */
+static void anc_lib_rediscovery_done( anc_lib_cb_t *p_cb, wiced_bt_gatt_status_t status )
+{
+    wiced_bt_anc_event_data_t event_data;
+
+    ANC_LIB_TRACE("[%s] conn %d status %d\n", __FUNCTION__, p_cb->conn_id, status);
+
+    p_cb->rediscovering = 0;
+    p_cb->anc_current_state = ANC_CLIENT_STATE_CONNECTED;
+    anc_lib_build_route_map( p_cb );
+    anc_lib_send_queued_writes( p_cb );
+
+    event_data.discovery_result.conn_id = p_cb->conn_id;
+    event_data.discovery_result.status = status;
+    anc_lib_notify( WICED_BT_ANC_DISCOVER_RESULT, &event_data );
+}
+
+/*
+ * Enable the Service Changed indications once the first alert subscription is confirmed,
+ * so that it never delays it. The GATT service, the characteristic and its CCCD are looked
+ * for unless they came with the handle cache. Only tried while the bearer is free.
+ */
+static void anc_lib_subscribe_service_changed( anc_lib_cb_t *p_cb )
+{
+    wiced_bt_gatt_status_t status;
+
+    if ( p_cb->service_changed_subscribed || !p_cb->setup.done ||
+         ( p_cb->anc_current_state != ANC_CLIENT_STATE_CONNECTED ) || ( p_cb->p_read_buf != NULL ) ||
+         p_cb->cp_write_in_flight || p_cb->pending_cccd_writes )
+        return;
+
+    if ( p_cb->handles.service_changed_cccd_handle != 0 )
+    {
+        p_cb->anc_current_state = ANC_CLIENT_STATE_SET_SERVICE_CHANGED_CCCD;
+        status = anc_lib_gatt_write_cccd( p_cb, p_cb->handles.service_changed_cccd_handle, GATT_CLIENT_CONFIG_INDICATION );
+    }
+    else
+    {
+        p_cb->sc_s_handle = 0;
+        p_cb->sc_e_handle = 0;
+        p_cb->anc_current_state = ANC_CLIENT_STATE_DISCOVER_GATT_SERVICE;
+        status = anc_lib_gatt_discover( p_cb, GATT_DISCOVER_SERVICES_BY_UUID, UUID_SERVICE_GENERIC_ATTRIBUTE, 1, 0xFFFF );
+    }
+
+    if ( status != WICED_BT_GATT_SUCCESS )
+    {
+        p_cb->anc_current_state = ANC_CLIENT_STATE_CONNECTED;
+        /* another request is on the air, try again with its response */
+        if ( status != WICED_BT_GATT_BUSY )
+            p_cb->service_changed_subscribed = 1;
+    }
+}
+
+/* Next step of the Service Changed subscription. Without one, it is not tried again on this connection */
+static void anc_lib_service_changed_discovery_complete( anc_lib_cb_t *p_cb )
+{
+    wiced_bt_gatt_status_t status = WICED_BT_GATT_NOT_FOUND;
+    uint8_t state = p_cb->anc_current_state;
+
+    if ( ( state == ANC_CLIENT_STATE_DISCOVER_GATT_SERVICE ) && ( p_cb->sc_s_handle != 0 ) )
+    {
+        p_cb->anc_current_state = ANC_CLIENT_STATE_DISCOVER_SERVICE_CHANGED;
+        status = anc_lib_gatt_discover( p_cb, GATT_DISCOVER_CHARACTERISTICS, 0, p_cb->sc_s_handle, p_cb->sc_e_handle );
+    }
+    else if ( ( state == ANC_CLIENT_STATE_DISCOVER_SERVICE_CHANGED ) &&
+              ( p_cb->handles.service_changed_value_handle != 0 ) && ( p_cb->handles.service_changed_value_handle < p_cb->sc_e_handle ) )
+    {
+        p_cb->anc_current_state = ANC_CLIENT_STATE_DISCOVER_SERVICE_CHANGED_CCCD;
+        status = anc_lib_gatt_discover( p_cb, GATT_DISCOVER_CHARACTERISTIC_DESCRIPTORS, UUID_DESCRIPTOR_CLIENT_CHARACTERISTIC_CONFIGURATION,
+                p_cb->handles.service_changed_value_handle + 1, p_cb->sc_e_handle );
+    }
+    else if ( ( state == ANC_CLIENT_STATE_DISCOVER_SERVICE_CHANGED_CCCD ) && ( p_cb->handles.service_changed_cccd_handle != 0 ) )
+    {
+        p_cb->anc_current_state = ANC_CLIENT_STATE_SET_SERVICE_CHANGED_CCCD;
+        status = anc_lib_gatt_write_cccd( p_cb, p_cb->handles.service_changed_cccd_handle, GATT_CLIENT_CONFIG_INDICATION );
+    }
+
+    if ( status != WICED_BT_GATT_SUCCESS )
+    {
+        ANC_LIB_TRACE("[%s] no Service Changed state:%d status:%d\n", __FUNCTION__, state, status);
+        p_cb->anc_current_state = ANC_CLIENT_STATE_CONNECTED;
+        p_cb->service_changed_subscribed = 1;
+        anc_lib_send_queued_writes( p_cb );
+    }
+}
+
+/* Keep the supported categories of a successful read, later reads are answered locally */
+static void anc_lib_cache_categories( anc_lib_cb_t *p_cb, wiced_bt_anc_event_t event, wiced_bt_anc_event_data_t *p_event_data )
+{
+    if ( ( event == WICED_BT_ANC_READ_SUPPORTED_NEW_ALERTS_RESULT ) &&
+         ( p_event_data->supported_new_alerts_result.status == WICED_BT_GATT_SUCCESS ) )
+    {
+        p_cb->supported_new_alerts = p_event_data->supported_new_alerts_result.supported_alerts;
+        p_cb->categories_cached |= ANC_LIB_CACHED_NEW_CATEGORIES;
+    }
+    else if ( ( event == WICED_BT_ANC_READ_SUPPORTED_UNREAD_ALERTS_RESULT ) &&
+              ( p_event_data->supported_unread_alerts_result.status == WICED_BT_GATT_SUCCESS ) )
+    {
+        p_cb->supported_unread_alerts = p_event_data->supported_unread_alerts_result.supported_alerts;
+        p_cb->categories_cached |= ANC_LIB_CACHED_UNREAD_CATEGORIES;
+    }
+}
+
+/* Report cached supported categories with the event of a read. The read may come from any thread of
+ * the application, the event is given from the stack thread like the one of a read sent to the server */
+static void anc_lib_notify_cached_categories( anc_lib_cb_t *p_cb, wiced_bt_anc_event_t event )
+{
+    ANC_LIB_TRACE(" [%s] conn %d event %d\n", __FUNCTION__, p_cb->conn_id, event);
+
+    if ( event == WICED_BT_ANC_READ_SUPPORTED_NEW_ALERTS_RESULT )
+        p_cb->new_categories_reports++;
+    else
+        p_cb->unread_categories_reports++;
+
+    if ( !wiced_is_timer_in_use( &anc_lib_data.cached_timer ) )
+        wiced_start_timer( &anc_lib_data.cached_timer, 1 );
+}
+
+static void anc_lib_report_cached_categories( anc_lib_cb_t *p_cb, wiced_bt_anc_event_t event )
+{
+    wiced_bt_anc_event_data_t event_data;
+
+    if ( event == WICED_BT_ANC_READ_SUPPORTED_NEW_ALERTS_RESULT )
+    {
+        event_data.supported_new_alerts_result.conn_id = p_cb->conn_id;
+        event_data.supported_new_alerts_result.status = WICED_BT_GATT_SUCCESS;
+        event_data.supported_new_alerts_result.supported_alerts = p_cb->supported_new_alerts;
+    }
+    else
+    {
+        event_data.supported_unread_alerts_result.conn_id = p_cb->conn_id;
+        event_data.supported_unread_alerts_result.status = WICED_BT_GATT_SUCCESS;
+        event_data.supported_unread_alerts_result.supported_alerts = p_cb->supported_unread_alerts;
+    }
+    anc_lib_notify( event, &event_data );
+}
+
+static void anc_lib_cached_timeout( WICED_TIMER_PARAM_TYPE param )
+{
+    uint16_t conn_ids[ANC_LIB_CONN_TABLE_SIZE];
+    anc_lib_cb_t *p_cb;
+    uint8_t i, num = 0;
+
+    (void)param;
+
+    /* the callback may free connections, which moves the others in the table */
+    for ( i = 0; i < ANC_LIB_CONN_TABLE_SIZE; i++ )
+    {
+        p_cb = &anc_lib_data.conn[i];
+        if ( ( p_cb->conn_id != 0 ) && ( ( p_cb->new_categories_reports != 0 ) || ( p_cb->unread_categories_reports != 0 ) ) )
+            conn_ids[num++] = p_cb->conn_id;
+    }
+
+    for ( i = 0; i < num; i++ )
+    {
+        while ( ( ( p_cb = anc_lib_find_conn( conn_ids[i] ) ) != NULL ) && ( p_cb->new_categories_reports != 0 ) )
+        {
+            p_cb->new_categories_reports--;
+            anc_lib_report_cached_categories( p_cb, WICED_BT_ANC_READ_SUPPORTED_NEW_ALERTS_RESULT );
+        }
+        while ( ( ( p_cb = anc_lib_find_conn( conn_ids[i] ) ) != NULL ) && ( p_cb->unread_categories_reports != 0 ) )
+        {
+            p_cb->unread_categories_reports--;
+            anc_lib_report_cached_categories( p_cb, WICED_BT_ANC_READ_SUPPORTED_UNREAD_ALERTS_RESULT );
+        }
+    }
+}
+
+/*
+ * Read a supported category value. Once discovery found the value handle it is read by
+ * handle, before that a read by type over the ANS range gets the value and its handle in
+ * one round trip.
+ */
+static wiced_bt_gatt_status_t anc_lib_read_category( anc_lib_cb_t *p_cb, uint16_t value_handle, uint16_t char_uuid )
+{
+    wiced_bt_gatt_status_t status;
+
+    if ( ( value_handle == 0 ) && ( p_cb->handles.anc_s_handle == 0 ) )
+        return WICED_BT_GATT_ERROR;
+
+    if ( ( p_cb->p_read_buf != NULL ) || anc_lib_discovering( p_cb ) )
+        return WICED_BT_GATT_BUSY;
+
+    p_cb->p_read_buf = (uint8_t *)wiced_bt_get_buffer( MAX_READ_LEN );
+    if ( p_cb->p_read_buf == NULL )
+        return WICED_BT_GATT_NO_RESOURCES;
+
+    if ( value_handle != 0 )
+    {
+        p_cb->read_by_type_uuid = 0;
+        status = anc_lib_gatt_read( p_cb, value_handle );
+    }
+    else
+    {
+        p_cb->read_by_type_uuid = char_uuid;
+        status = anc_lib_gatt_read_by_type( p_cb, p_cb->handles.anc_s_handle, p_cb->handles.anc_e_handle, char_uuid );
+    }
+    anc_lib_setup_request( p_cb, status );
+
+    if ( status != WICED_BT_GATT_SUCCESS )
+    {
+        wiced_bt_free_buffer( p_cb->p_read_buf );
+        p_cb->p_read_buf = NULL;
+    }
+    return status;
+}
+
+wiced_bt_gatt_status_t wiced_bt_anc_read_server_supported_new_alerts( uint16_t conn_id )
+{
+    anc_lib_cb_t *p_cb = anc_lib_find_conn(conn_id);
+
+    if (p_cb == NULL)
+        return WICED_BT_GATT_ERROR;
+
+    if ( p_cb->categories_cached & ANC_LIB_CACHED_NEW_CATEGORIES )
+    {
+        anc_lib_notify_cached_categories( p_cb, WICED_BT_ANC_READ_SUPPORTED_NEW_ALERTS_RESULT );
+        return WICED_BT_GATT_SUCCESS;
+    }
+
+    return anc_lib_read_category( p_cb, p_cb->handles.supported_new_alert_category_value_handle,
+                                  UUID_CHARACTERISTIC_SUPPORTED_NEW_ALERT_CATEGORY );
+}
+
+wiced_bt_gatt_status_t wiced_bt_anc_read_server_supported_unread_alerts( uint16_t conn_id )
+{
+    anc_lib_cb_t *p_cb = anc_lib_find_conn(conn_id);
+
+    if (p_cb == NULL)
+        return WICED_BT_GATT_ERROR;
+
+    if ( p_cb->categories_cached & ANC_LIB_CACHED_UNREAD_CATEGORIES )
+    {
+        anc_lib_notify_cached_categories( p_cb, WICED_BT_ANC_READ_SUPPORTED_UNREAD_ALERTS_RESULT );
+        return WICED_BT_GATT_SUCCESS;
+    }
+
+    return anc_lib_read_category( p_cb, p_cb->handles.supported_unread_alert_category_value_handle,
+                                  UUID_CHARACTERISTIC_SUPPORTED_UNREAD_ALERT_CATEGORY );
+}
+
+wiced_bt_gatt_status_t wiced_bt_anc_read_server_supported_categories( uint16_t conn_id )
+{
+    wiced_bt_gatt_status_t status;
+    anc_lib_cb_t *p_cb = anc_lib_find_conn(conn_id);
+    uint16_t handles[2];
 
-    if( ( anc_lib_data.conn_id == conn_id ) && ( anc_lib_data.supported_new_alert_category_value_handle ) && (NULL != p_read) )
+    if (p_cb == NULL)
+        return WICED_BT_GATT_ERROR;
+
+    if ( ( p_cb->categories_cached & ( ANC_LIB_CACHED_NEW_CATEGORIES | ANC_LIB_CACHED_UNREAD_CATEGORIES ) ) ==
+         ( ANC_LIB_CACHED_NEW_CATEGORIES | ANC_LIB_CACHED_UNREAD_CATEGORIES ) )
     {
-		status = wiced_bt_gatt_client_send_read_handle( conn_id, anc_lib_data.supported_new_alert_category_value_handle, 
-														0, p_read, MAX_READ_LEN, GATT_AUTH_REQ_NONE );
+        anc_lib_notify_cached_categories( p_cb, WICED_BT_ANC_READ_SUPPORTED_NEW_ALERTS_RESULT );
+        anc_lib_notify_cached_categories( p_cb, WICED_BT_ANC_READ_SUPPORTED_UNREAD_ALERTS_RESULT );
+        return WICED_BT_GATT_SUCCESS;
     }
 
-    return status;
-}
-
-wiced_bt_gatt_status_t wiced_bt_anc_read_server_supported_unread_alerts( uint16_t conn_id )
-{
-    wiced_bt_gatt_status_t status = WICED_BT_GATT_ERROR;
-    uint8_t *p_read = NULL;
-    p_read = wiced_bt_get_buffer(MAX_READ_LEN);
+    handles[0] = p_cb->handles.supported_new_alert_category_value_handle;
+    handles[1] = p_cb->handles.supported_unread_alert_category_value_handle;
 
-    if( ( anc_lib_data.conn_id == conn_id ) && ( anc_lib_data.supported_unread_alert_category_value_handle ) && (NULL != p_read) )
+    if ( ( handles[0] != 0 ) && ( handles[1] != 0 ) && !p_cb->read_multiple_failed )
     {
-        status = wiced_bt_gatt_client_send_read_handle( conn_id, anc_lib_data.supported_unread_alert_category_value_handle, 
-														0, p_read, MAX_READ_LEN, GATT_AUTH_REQ_NONE );
+        if ( ( p_cb->p_read_buf != NULL ) || anc_lib_discovering( p_cb ) )
+            return WICED_BT_GATT_BUSY;
+
+        p_cb->p_read_buf = (uint8_t *)wiced_bt_get_buffer( MAX_READ_LEN );
+        if ( p_cb->p_read_buf == NULL )
+            return WICED_BT_GATT_NO_RESOURCES;
+
+        status = anc_lib_gatt_read_multiple( p_cb, handles[0], handles[1] );
+        anc_lib_setup_request( p_cb, status );
+        if ( status == WICED_BT_GATT_SUCCESS )
+        {
+            p_cb->read_multiple = 1;
+            return status;
+        }
+
+        wiced_bt_free_buffer( p_cb->p_read_buf );
+        p_cb->p_read_buf = NULL;
+        if ( status == WICED_BT_GATT_BUSY )
+            return status;
+        p_cb->read_multiple_failed = 1;
     }
 
+    /* one read after the other, the unread categories are read when the new ones come back */
+    status = anc_lib_read_category( p_cb, handles[0], UUID_CHARACTERISTIC_SUPPORTED_NEW_ALERT_CATEGORY );
+    if ( status == WICED_BT_GATT_SUCCESS )
+        p_cb->read_unread_next = 1;
     return status;
 }
 
 wiced_bt_gatt_status_t wiced_bt_anc_enable_new_alerts( uint16_t conn_id )
 {
     wiced_bt_gatt_status_t status;
+    uint8_t state;
+    anc_lib_cb_t *p_cb = anc_lib_find_conn(conn_id);
+
+    if (p_cb == NULL)
+    {
+        return WICED_BT_GATT_ERROR;
+    }
+
     // verify that CCCD has been discovered
-    if ((anc_lib_data.new_alert_cccd_handle == 0))
+    if ((p_cb->handles.new_alert_cccd_handle == 0))
     {
         return WICED_BT_GATT_NOT_FOUND;
     }
 
-    if( (anc_lib_data.anc_current_state != ANC_CLIENT_STATE_SET_NEW_ALERT_CCCD) &&
-        ( anc_lib_data.anc_current_state != ANC_CLIENT_STATE_RESET_NEW_ALERT_CCCD ) )
+    if( anc_lib_discovering( p_cb ) )
+    {
+        // the discovery holds the bearer, write when it completes
+        p_cb->enabled_new_alerts = 1;
+        p_cb->pending_cccd_writes |= ANC_LIB_PENDING_NEW_ALERT_CCCD;
+        status = WICED_BT_GATT_SUCCESS;
+    }
+    else if( (p_cb->anc_current_state != ANC_CLIENT_STATE_SET_NEW_ALERT_CCCD) &&
+        ( p_cb->anc_current_state != ANC_CLIENT_STATE_RESET_NEW_ALERT_CCCD ) )
     {
         // Register for notifications
-        anc_lib_data.enabled_new_alerts = 1;
-        anc_lib_data.anc_current_state = ANC_CLIENT_STATE_SET_NEW_ALERT_CCCD;
-        status = wiced_bt_util_set_gatt_client_config_descriptor( conn_id, anc_lib_data.new_alert_cccd_handle, GATT_CLIENT_CONFIG_NOTIFICATION );
+        p_cb->enabled_new_alerts = 1;
+        state = p_cb->anc_current_state;
+        p_cb->anc_current_state = ANC_CLIENT_STATE_SET_NEW_ALERT_CCCD;
+        status = anc_lib_gatt_write_cccd( p_cb, p_cb->handles.new_alert_cccd_handle, GATT_CLIENT_CONFIG_NOTIFICATION );
+        anc_lib_setup_request( p_cb, status );
+        if ( status != WICED_BT_GATT_SUCCESS )
+            p_cb->anc_current_state = state;
     }
     else
     {
@@ -439,20 +2123,31 @@ wiced_bt_gatt_status_t wiced_bt_anc_enable_new_alerts( uint16_t conn_id )
 wiced_bt_gatt_status_t wiced_bt_anc_disable_new_alerts( uint16_t conn_id )
 {
     wiced_bt_gatt_status_t status;
+    uint8_t state;
+    anc_lib_cb_t *p_cb = anc_lib_find_conn(conn_id);
+
+    if (p_cb == NULL)
+    {
+        return WICED_BT_GATT_ERROR;
+    }
 
     // verify that CCCD has been discovered
-    if ((anc_lib_data.new_alert_cccd_handle == 0))
+    if ((p_cb->handles.new_alert_cccd_handle == 0))
     {
         return WICED_BT_GATT_NOT_FOUND;
     }
 
-    if( (anc_lib_data.anc_current_state != ANC_CLIENT_STATE_SET_NEW_ALERT_CCCD)
-        && ( anc_lib_data.anc_current_state != ANC_CLIENT_STATE_RESET_NEW_ALERT_CCCD ))
+    if( (p_cb->anc_current_state != ANC_CLIENT_STATE_SET_NEW_ALERT_CCCD)
+        && ( p_cb->anc_current_state != ANC_CLIENT_STATE_RESET_NEW_ALERT_CCCD ))
     {
         // Register for notifications
-        anc_lib_data.enabled_new_alerts = 0;
-        anc_lib_data.anc_current_state = ANC_CLIENT_STATE_RESET_NEW_ALERT_CCCD;
-        status = wiced_bt_util_set_gatt_client_config_descriptor( conn_id, anc_lib_data.new_alert_cccd_handle, GATT_CLIENT_CONFIG_NONE );
+        p_cb->enabled_new_alerts = 0;
+        state = p_cb->anc_current_state;
+        p_cb->anc_current_state = ANC_CLIENT_STATE_RESET_NEW_ALERT_CCCD;
+        status = anc_lib_gatt_write_cccd( p_cb, p_cb->handles.new_alert_cccd_handle, GATT_CLIENT_CONFIG_NONE );
+        anc_lib_setup_request( p_cb, status );
+        if ( status != WICED_BT_GATT_SUCCESS )
+            p_cb->anc_current_state = state;
     }
     else
     {
@@ -461,22 +2156,65 @@ wiced_bt_gatt_status_t wiced_bt_anc_disable_new_alerts( uint16_t conn_id )
     return status;
 }
 
+/* Lazy search of the Unread Alert Status descriptors, on the first enable request */
+static wiced_bt_gatt_status_t anc_lib_discover_unread_cccd( anc_lib_cb_t *p_cb )
+{
+    uint16_t start_handle, end_handle;
+    wiced_bt_gatt_status_t status;
+
+    anc_lib_cccd_range( p_cb, ANC_LIB_CHAR_BIT( ANC_LIB_CHAR_UNREAD_ALERT ), &start_handle, &end_handle );
+    status = anc_lib_gatt_discover( p_cb, GATT_DISCOVER_CHARACTERISTIC_DESCRIPTORS, UUID_DESCRIPTOR_CLIENT_CHARACTERISTIC_CONFIGURATION,
+            start_handle, end_handle );
+    anc_lib_setup_request( p_cb, status );
+    if ( status == WICED_BT_GATT_SUCCESS )
+    {
+        p_cb->anc_current_state = ANC_CLIENT_STATE_DISCOVER_UNREAD_ALERT_CCCD;
+        p_cb->unread_cccd_searched = 1;
+    }
+    return status;
+}
+
 wiced_bt_gatt_status_t wiced_bt_anc_enable_unread_alerts( uint16_t conn_id )
 {
     wiced_bt_gatt_status_t status;
+    anc_lib_cb_t *p_cb = anc_lib_find_conn(conn_id);
 
-    // verify that CCCD has been discovered
-    if ((anc_lib_data.unread_alert_cccd_handle == 0))
+    if (p_cb == NULL)
     {
-        return WICED_BT_GATT_NOT_FOUND;
+        return WICED_BT_GATT_ERROR;
     }
 
-    if( (anc_lib_data.anc_current_state != ANC_CLIENT_STATE_SET_UNREAD_ALERT_CCCD)
-        && ( anc_lib_data.anc_current_state != ANC_CLIENT_STATE_RESET_UNREAD_ALERT_CCCD ))
+    // verify that CCCD has been discovered, or look for it now
+    if ((p_cb->handles.unread_alert_cccd_handle == 0))
+    {
+        if ( p_cb->unread_cccd_searched || ( p_cb->handles.unread_alert_char_value_handle == 0 ) )
+            return WICED_BT_GATT_NOT_FOUND;
+        if ( p_cb->anc_current_state != ANC_CLIENT_STATE_CONNECTED )
+            return WICED_BT_GATT_BUSY;
+
+        status = anc_lib_discover_unread_cccd( p_cb );
+        if ( status == WICED_BT_GATT_SUCCESS )
+        {
+            p_cb->enabled_unread_alerts = 1;
+            p_cb->pending_cccd_writes |= ANC_LIB_PENDING_UNREAD_ALERT_CCCD;
+        }
+        return status;
+    }
+
+    if( anc_lib_discovering( p_cb ) )
+    {
+        // the discovery holds the bearer, write when it completes
+        p_cb->enabled_unread_alerts = 1;
+        p_cb->pending_cccd_writes |= ANC_LIB_PENDING_UNREAD_ALERT_CCCD;
+        status = WICED_BT_GATT_SUCCESS;
+    }
+    else if( (p_cb->anc_current_state != ANC_CLIENT_STATE_SET_UNREAD_ALERT_CCCD)
+        && ( p_cb->anc_current_state != ANC_CLIENT_STATE_RESET_UNREAD_ALERT_CCCD ))
     {
         // Register for notifications
-        anc_lib_data.enabled_unread_alerts = 1;
-        status = wiced_bt_util_set_gatt_client_config_descriptor( conn_id, anc_lib_data.unread_alert_cccd_handle, GATT_CLIENT_CONFIG_NOTIFICATION );
+        p_cb->enabled_unread_alerts = 1;
+        status = anc_lib_gatt_write_cccd( p_cb, p_cb->handles.unread_alert_cccd_handle, GATT_CLIENT_CONFIG_NOTIFICATION );
+        anc_lib_setup_request( p_cb, status );
     }
     else
     {
@@ -489,19 +2227,26 @@ wiced_bt_gatt_status_t wiced_bt_anc_enable_unread_alerts( uint16_t conn_id )
 wiced_bt_gatt_status_t wiced_bt_anc_disable_unread_alerts( uint16_t conn_id )
 {
     wiced_bt_gatt_status_t status;
+    anc_lib_cb_t *p_cb = anc_lib_find_conn(conn_id);
+
+    if (p_cb == NULL)
+    {
+        return WICED_BT_GATT_ERROR;
+    }
 
     // verify that CCCD has been discovered
-    if ((anc_lib_data.unread_alert_cccd_handle == 0))
+    if ((p_cb->handles.unread_alert_cccd_handle == 0))
     {
         return WICED_BT_GATT_NOT_FOUND;
     }
 
-    if( (anc_lib_data.anc_current_state != ANC_CLIENT_STATE_SET_UNREAD_ALERT_CCCD)
-        && ( anc_lib_data.anc_current_state != ANC_CLIENT_STATE_RESET_UNREAD_ALERT_CCCD ))
+    if( (p_cb->anc_current_state != ANC_CLIENT_STATE_SET_UNREAD_ALERT_CCCD)
+        && ( p_cb->anc_current_state != ANC_CLIENT_STATE_RESET_UNREAD_ALERT_CCCD ))
     {
         // Register for notifications
-        anc_lib_data.enabled_unread_alerts = 0;
-        status = wiced_bt_util_set_gatt_client_config_descriptor( conn_id, anc_lib_data.unread_alert_cccd_handle, GATT_CLIENT_CONFIG_NONE );
+        p_cb->enabled_unread_alerts = 0;
+        status = anc_lib_gatt_write_cccd( p_cb, p_cb->handles.unread_alert_cccd_handle, GATT_CLIENT_CONFIG_NONE );
+        anc_lib_setup_request( p_cb, status );
     }
     else
     {
@@ -511,37 +2256,140 @@ wiced_bt_gatt_status_t wiced_bt_anc_disable_unread_alerts( uint16_t conn_id )
 }
 
 
+/*
+ * Send the oldest queued control point write, unless it is already on the air.
+ * The stack accepts one request at a time, if it is busy with another request
+ * the write stays queued and is retried when that request completes.
+ */
+static wiced_bt_gatt_status_t anc_lib_send_control_point_write( anc_lib_cb_t *p_cb )
+{
+    wiced_bt_gatt_status_t status;
+
+    if ( ( p_cb->num_cp_write_req == 0 ) || ( p_cb->cp_write_in_flight ) )
+        return WICED_BT_GATT_SUCCESS;
+
+    /* the discovery holds the bearer, the write goes out when it completes */
+    if ( anc_lib_discovering( p_cb ) )
+        return WICED_BT_GATT_BUSY;
+
+    ANC_LIB_TRACE_BIN(ANC_TRACE_LIB_CP_WRITE, p_cb->handles.alert_notify_control_point_value_handle,
+                      p_cb->control_alert_cmd_id[p_cb->oldest_cp_write_req], p_cb->control_alert_catergory_id[p_cb->oldest_cp_write_req],
+                      p_cb->num_cp_write_req);
+    status = anc_lib_gatt_write( p_cb, p_cb->handles.alert_notify_control_point_value_handle,
+                                 p_cb->control_alert_cmd_id[p_cb->oldest_cp_write_req], p_cb->control_alert_catergory_id[p_cb->oldest_cp_write_req] );
+
+    if (status == WICED_BT_GATT_SUCCESS)
+        p_cb->cp_write_in_flight = 1;
+    anc_lib_setup_request( p_cb, status );
+
+    return status;
+}
+
+/*
+ * Feed the control point writes. A write the stack refuses for another reason than
+ * another request on the air is given up and reported, the next one is tried.
+ */
+static void anc_lib_send_queued_control_point_writes( anc_lib_cb_t *p_cb )
+{
+    wiced_bt_anc_event_data_t event_data;
+    wiced_bt_gatt_status_t status;
+
+    while ( ( p_cb->num_cp_write_req != 0 ) && !p_cb->cp_write_in_flight )
+    {
+        status = anc_lib_send_control_point_write( p_cb );
+        if ( ( status == WICED_BT_GATT_SUCCESS ) || ( status == WICED_BT_GATT_BUSY ) )
+            return;
+
+        memset( &event_data, 0, sizeof(event_data) );
+        event_data.control_alerts_result.conn_id = p_cb->conn_id;
+        event_data.control_alerts_result.status = status;
+        event_data.control_alerts_result.category_id = p_cb->control_alert_catergory_id[p_cb->oldest_cp_write_req];
+        event_data.control_alerts_result.control_point_cmd_id = p_cb->control_alert_cmd_id[p_cb->oldest_cp_write_req];
+        control_point_cache_free_oldest( p_cb );
+        anc_lib_notify( WICED_BT_ANC_CONTROL_ALERTS_RESULT, &event_data );
+    }
+}
+
+/*
+ * Send what the application asked for while the bearer was taken: the CCCD writes
+ * requested during discovery, then the control point writes. One at a time, the
+ * next one goes out with the response of the previous one.
+ */
+static void anc_lib_send_queued_writes( anc_lib_cb_t *p_cb )
+{
+    wiced_bt_anc_event_data_t event_data;
+    wiced_bt_gatt_status_t status;
+
+    /* everything waits for the late response of a request that timed out, the stack would refuse it */
+    if ( p_cb->late_responses != 0 )
+        return;
+
+    /* a Service Changed range goes first, the writes may depend on the handles it covers */
+    if ( anc_lib_start_rediscovery( p_cb ) )
+        return;
+
+    if ( p_cb->pending_cccd_writes & ANC_LIB_PENDING_NEW_ALERT_CCCD )
+    {
+        p_cb->pending_cccd_writes &= ~ANC_LIB_PENDING_NEW_ALERT_CCCD;
+        status = wiced_bt_anc_enable_new_alerts( p_cb->conn_id );
+        if ( status == WICED_BT_GATT_SUCCESS )
+            return;
+
+        event_data.enable_disable_alerts_result.conn_id = p_cb->conn_id;
+        event_data.enable_disable_alerts_result.status = status;
+        anc_lib_notify( WICED_BT_ANC_ENABLE_NEW_ALERTS_RESULT, &event_data );
+    }
+    if ( p_cb->pending_cccd_writes & ANC_LIB_PENDING_UNREAD_ALERT_CCCD )
+    {
+        p_cb->pending_cccd_writes &= ~ANC_LIB_PENDING_UNREAD_ALERT_CCCD;
+        status = wiced_bt_anc_enable_unread_alerts( p_cb->conn_id );
+        if ( status == WICED_BT_GATT_SUCCESS )
+            return;
+
+        event_data.enable_disable_alerts_result.conn_id = p_cb->conn_id;
+        event_data.enable_disable_alerts_result.status = status;
+        anc_lib_notify( WICED_BT_ANC_ENABLE_UNREAD_ALERTS_RESULT, &event_data );
+    }
+    anc_lib_send_queued_control_point_writes( p_cb );
+    anc_lib_subscribe_service_changed( p_cb );
+    anc_lib_update_database_hash( p_cb );
+    anc_lib_start_requests( p_cb );
+}
+
 wiced_bt_gatt_status_t wiced_bt_anc_control_required_alerts( uint16_t conn_id , wiced_bt_anp_alert_control_cmd_id_t cmd_id, wiced_bt_anp_alert_category_id_t category)
 {
-    uint8_t  *p_write_req;
-    wiced_bt_gatt_write_hdr_t p_write_header = { 0 };
-    uint8_t value[2];
     wiced_bt_gatt_status_t status = WICED_BT_GATT_ERROR;
+    anc_lib_cb_t *p_cb = anc_lib_find_conn(conn_id);
+    uint8_t index;
 
-    if( ( anc_lib_data.conn_id == conn_id ) && ( anc_lib_data.alert_notify_control_point_value_handle ) )
+    if( ( p_cb != NULL ) && ( p_cb->handles.alert_notify_control_point_value_handle ) )
     {
-        p_write_req = wiced_bt_get_buffer(sizeof(value));
-        if (p_write_req == NULL)
+        /* older writes first, those which fail are reported to their own callers */
+        anc_lib_send_queued_control_point_writes(p_cb);
+
+        if (!control_point_cache_alloc(p_cb, &index))
         {
-            return WICED_BT_GATT_NO_RESOURCES;
+            return WICED_BT_GATT_BUSY;
         }
-        memset( p_write_req, 0, sizeof(value) );
-
-        p_write_header.handle = anc_lib_data.alert_notify_control_point_value_handle;
-        p_write_header.offset   = 0;
-        p_write_header.len = sizeof(value);
-        p_write_header.auth_req = GATT_AUTH_REQ_NONE;
+        p_cb->control_alert_cmd_id[index]       = cmd_id;
+        p_cb->control_alert_catergory_id[index] = category;
 
-        value[0] = cmd_id;
-        value[1] = category;
-        memcpy( p_write_req, value, sizeof(value) );
+        /* Queued behind a write on the air or waiting for the bearer, sent when it completes */
+        if (p_cb->num_cp_write_req > 1)
+            return WICED_BT_GATT_SUCCESS;
 
-        ANC_LIB_TRACE("Control Point Value handle :0x%02x Command %d Category %d\n", p_write_header.handle, cmd_id, category);
-        anc_lib_data.control_alert_cmd_id       = cmd_id;
-        anc_lib_data.control_alert_catergory_id = category;
-        status = wiced_bt_gatt_client_send_write( conn_id, GATT_REQ_WRITE, &p_write_header, p_write_req, NULL );
+        status = anc_lib_send_control_point_write(p_cb);
 
-        wiced_bt_free_buffer(p_write_req);
+        /* Another request is on the air, the write goes out when it completes */
+        if (status == WICED_BT_GATT_BUSY)
+        {
+            status = WICED_BT_GATT_SUCCESS;
+        }
+        /* Not queued, give the slot back and return the failure */
+        else if (status != WICED_BT_GATT_SUCCESS)
+        {
+            control_point_cache_free_oldest(p_cb);
+        }
     }
     return status;
 }
@@ -553,94 +2401,247 @@ wiced_bt_gatt_status_t wiced_bt_anc_control_required_alerts( uint16_t conn_id ,
 void wiced_bt_anc_write_rsp(wiced_bt_gatt_operation_complete_t *p_data)
 {
     wiced_bt_anc_event_data_t event_data;
-    uint8_t i;
+    anc_lib_cb_t *p_cb = anc_lib_find_conn(p_data->conn_id);
+
+    if ((p_cb == NULL) || !anc_lib_gatt_response(p_cb))
+        return;
 
-    ANC_LIB_TRACE("[%s] state:%02x rc:%d\n", __FUNCTION__, anc_lib_data.anc_current_state, p_data->status);
+    ANC_LIB_TRACE_BIN(ANC_TRACE_LIB_WRITE_RSP, p_data->conn_id, p_cb->anc_current_state, p_data->status, 0);
 
-    anc_lib_data.anc_current_state = ANC_CLIENT_STATE_CONNECTED;
+    p_cb->anc_current_state = ANC_CLIENT_STATE_CONNECTED;
 
     memset(&event_data, 0, sizeof(event_data));
 
-    if (p_data->response_data.handle == anc_lib_data.alert_notify_control_point_value_handle)
+    switch (anc_lib_route(p_cb, p_data->response_data.handle))
     {
+    case ANC_LIB_ROUTE_VALUE(ANC_LIB_CHAR_CONTROL_POINT):
+        if (p_cb->num_cp_write_req == 0)
+            break;
         event_data.control_alerts_result.conn_id = p_data->conn_id;
         event_data.control_alerts_result.status = p_data->status;
-        event_data.control_alerts_result.category_id = anc_lib_data.control_alert_catergory_id;
-        event_data.control_alerts_result.control_point_cmd_id = anc_lib_data.control_alert_cmd_id;
-        anc_lib_data.control_alert_catergory_id = 0;
-        anc_lib_data.control_alert_cmd_id = 0;
-#if 0
-        if (++anc_lib_data.oldest_cp_write_req == MAX_SIMULTANIOUS_CONTROL_POINT_WRITES)
-        {
-            anc_lib_data.oldest_cp_write_req = 0;
-        }
-#endif
-        anc_lib_data.p_callback(WICED_BT_ANC_CONTROL_ALERTS_RESULT, &event_data);
-    }
-    else if (p_data->response_data.handle == anc_lib_data.new_alert_cccd_handle)
-    {
+        event_data.control_alerts_result.category_id = p_cb->control_alert_catergory_id[p_cb->oldest_cp_write_req];
+        event_data.control_alerts_result.control_point_cmd_id = p_cb->control_alert_cmd_id[p_cb->oldest_cp_write_req];
+        control_point_cache_free_oldest(p_cb);
+        anc_lib_notify(WICED_BT_ANC_CONTROL_ALERTS_RESULT, &event_data);
+        break;
+
+    case ANC_LIB_ROUTE_CCCD(ANC_LIB_CHAR_NEW_ALERT):
         event_data.enable_disable_alerts_result.conn_id = p_data->conn_id;
         event_data.enable_disable_alerts_result.status = p_data->status;
-        if (anc_lib_data.enabled_new_alerts)
-            anc_lib_data.p_callback(WICED_BT_ANC_ENABLE_NEW_ALERTS_RESULT, &event_data);
+        if (p_cb->enabled_new_alerts && (p_data->status == WICED_BT_GATT_SUCCESS))
+            anc_lib_setup_subscribed(p_cb);
+        if (p_cb->enabled_new_alerts)
+            anc_lib_notify(WICED_BT_ANC_ENABLE_NEW_ALERTS_RESULT, &event_data);
         else
-            anc_lib_data.p_callback(WICED_BT_ANC_DISABLE_NEW_ALERTS_RESULT, &event_data);
-    }
-    else if (p_data->response_data.handle == anc_lib_data.unread_alert_cccd_handle)
-    {
+            anc_lib_notify(WICED_BT_ANC_DISABLE_NEW_ALERTS_RESULT, &event_data);
+        break;
+
+    case ANC_LIB_ROUTE_CCCD(ANC_LIB_CHAR_UNREAD_ALERT):
         event_data.enable_disable_alerts_result.conn_id = p_data->conn_id;
         event_data.enable_disable_alerts_result.status = p_data->status;
-        if (anc_lib_data.enabled_new_alerts)
-            anc_lib_data.p_callback(WICED_BT_ANC_ENABLE_UNREAD_ALERTS_RESULT, &event_data);
+        if (p_cb->enabled_unread_alerts && (p_data->status == WICED_BT_GATT_SUCCESS))
+            anc_lib_setup_subscribed(p_cb);
+        if (p_cb->enabled_unread_alerts)
+            anc_lib_notify(WICED_BT_ANC_ENABLE_UNREAD_ALERTS_RESULT, &event_data);
         else
-            anc_lib_data.p_callback(WICED_BT_ANC_DISABLE_UNREAD_ALERTS_RESULT, &event_data);
+            anc_lib_notify(WICED_BT_ANC_DISABLE_UNREAD_ALERTS_RESULT, &event_data);
+        break;
+
+    default:
+        // the Service Changed CCCD is in the GATT service, outside of the route map
+        if ((p_data->response_data.handle == p_cb->handles.service_changed_cccd_handle) &&
+            (p_cb->handles.service_changed_cccd_handle != 0))
+        {
+            // not tried again on this connection if the server refused it
+            p_cb->service_changed_subscribed = 1;
+            if (p_data->status == WICED_BT_GATT_SUCCESS)
+                anc_lib_notify_progress(p_cb, WICED_BT_ANC_SERVICE_CHANGED_READY, p_cb->handles.service_changed_cccd_handle);
+        }
+        break;
     }
+
+    /* the bearer is free again, feed the next queued write */
+    anc_lib_send_queued_writes(p_cb);
 }
 
 /*
  * Process read response from the stack.
  * Application passes it here if handle belongs to our service.
  */
+/* Category ID Bit Mask 0 and the optional Bit Mask 1 */
+static wiced_bt_anp_alert_category_enable_t anc_lib_category_mask( wiced_bt_gatt_operation_complete_t *p_data )
+{
+    uint16_t len = p_data->response_data.att_value.len;
+    uint8_t *p = p_data->response_data.att_value.p_data;
+
+    if ( ( p_data->status != WICED_BT_GATT_SUCCESS ) || ( p == NULL ) || ( len == 0 ) )
+        return 0;
+    return ( len >= 2 ) ? ( p[0] | ( p[1] << 8 ) ) : p[0];
+}
+
+/*
+ * Response of the Read Multiple of both supported categories. The values come back to back,
+ * both one or both two bytes long; a rejected request or values of other lengths fall back
+ * to one read after the other.
+ */
+static void anc_lib_read_multiple_rsp( anc_lib_cb_t *p_cb, wiced_bt_gatt_operation_complete_t *p_data )
+{
+    wiced_bt_anc_event_data_t new_data, unread_data;
+    wiced_bt_gatt_status_t status = p_data->status;
+    uint16_t len = p_data->response_data.att_value.len;
+    uint8_t *p = p_data->response_data.att_value.p_data;
+    uint16_t value_len = len / 2;
+
+    p_cb->read_multiple = 0;
+
+    if ( ( status == WICED_BT_GATT_SUCCESS ) && ( p != NULL ) && ( ( len == 2 ) || ( len == 4 ) ) )
+    {
+        new_data.supported_new_alerts_result.supported_alerts =
+            ( value_len == 2 ) ? ( p[0] | ( p[1] << 8 ) ) : p[0];
+        unread_data.supported_unread_alerts_result.supported_alerts =
+            ( value_len == 2 ) ? ( p[2] | ( p[3] << 8 ) ) : p[1];
+    }
+    else
+    {
+        if ( status == WICED_BT_GATT_SUCCESS )
+            status = WICED_BT_GATT_INVALID_ATTR_LEN;
+        new_data.supported_new_alerts_result.supported_alerts = 0;
+        unread_data.supported_unread_alerts_result.supported_alerts = 0;
+    }
+
+    if ( p_cb->p_read_buf != NULL )
+        wiced_bt_free_buffer( p_cb->p_read_buf );
+    p_cb->p_read_buf = NULL;
+
+    if( p_cb->anc_current_state != ANC_CLIENT_STATE_CONNECTED )
+    {
+        ANC_LIB_TRACE("Illegal State: %d\n",p_cb->anc_current_state);
+        p_cb->anc_current_state = ANC_CLIENT_STATE_IDLE;
+        return;
+    }
+
+    /* security errors are the same one by one, the application pairs and reads again; a silent server too */
+    if ( ( status != WICED_BT_GATT_SUCCESS ) && ( status != WICED_BT_GATT_INSUF_AUTHENTICATION ) &&
+         ( status != WICED_BT_GATT_INSUF_ENCRYPTION ) && ( status != WICED_BT_GATT_INSUF_AUTHORIZATION ) &&
+         ( status != WICED_BT_ANC_GATT_TIMEOUT ) )
+    {
+        ANC_LIB_TRACE(" [%s] Read Multiple failed: %d, reading one by one\n",__FUNCTION__,status);
+        p_cb->read_multiple_failed = 1;
+        if ( wiced_bt_anc_read_server_supported_categories( p_cb->conn_id ) == WICED_BT_GATT_SUCCESS )
+            return;
+    }
+
+    new_data.supported_new_alerts_result.conn_id = p_cb->conn_id;
+    new_data.supported_new_alerts_result.status = status;
+    unread_data.supported_unread_alerts_result.conn_id = p_cb->conn_id;
+    unread_data.supported_unread_alerts_result.status = status;
+    anc_lib_cache_categories( p_cb, WICED_BT_ANC_READ_SUPPORTED_NEW_ALERTS_RESULT, &new_data );
+    anc_lib_cache_categories( p_cb, WICED_BT_ANC_READ_SUPPORTED_UNREAD_ALERTS_RESULT, &unread_data );
+    anc_lib_notify(WICED_BT_ANC_READ_SUPPORTED_NEW_ALERTS_RESULT, &new_data);
+    anc_lib_notify(WICED_BT_ANC_READ_SUPPORTED_UNREAD_ALERTS_RESULT, &unread_data);
+
+    anc_lib_send_queued_writes(p_cb);
+}
+
 void wiced_bt_anc_read_rsp(wiced_bt_gatt_operation_complete_t *p_data)
 {
     wiced_bt_anc_event_data_t event_data;
+    wiced_bt_anc_event_t event = ANC_LIB_NO_EVENT;
+    wiced_bt_gatt_status_t unread_status = WICED_BT_GATT_SUCCESS;
+    anc_lib_cb_t *p_cb = anc_lib_find_conn(p_data->conn_id);
+    uint16_t handle = p_data->response_data.att_value.handle;
+    uint16_t char_uuid;
+    uint8_t route;
+
+    if ((p_cb == NULL) || !anc_lib_gatt_response(p_cb))
+        return;
 
-    ANC_LIB_TRACE("[%s] state:%02x rc:%d\n", __FUNCTION__, anc_lib_data.anc_current_state, p_data->status);
+    ANC_LIB_TRACE_BIN(ANC_TRACE_LIB_READ_RSP, p_data->conn_id, p_cb->anc_current_state, p_data->status, 0);
+
+    if ( p_cb->read_multiple )
+    {
+        anc_lib_read_multiple_rsp( p_cb, p_data );
+        return;
+    }
+
+    /* a read by type reports the characteristic it was sent for, and tells its value handle */
+    char_uuid = p_cb->read_by_type_uuid;
+    p_cb->read_by_type_uuid = 0;
+    if ( char_uuid == UUID_CHARACTERISTIC_DATABASE_HASH )
+    {
+        anc_lib_database_hash_rsp( p_cb, p_data );
+        return;
+    }
+    if ( char_uuid != 0 )
+    {
+        /* the characteristic table is in UUID order */
+        route = ANC_LIB_ROUTE_VALUE( char_uuid - ANC_LIB_FIRST_CHAR_UUID );
+        if ( p_data->status == WICED_BT_GATT_SUCCESS )
+        {
+            *anc_lib_handle( p_cb, anc_lib_chars[char_uuid - ANC_LIB_FIRST_CHAR_UUID].value_offset ) = handle;
+            anc_lib_build_route_map( p_cb );
+        }
+    }
+    else
+    {
+        route = anc_lib_route( p_cb, handle );
+    }
 
-    if( anc_lib_data.anc_current_state != ANC_CLIENT_STATE_CONNECTED )
+    if( p_cb->anc_current_state != ANC_CLIENT_STATE_CONNECTED )
     {
-        ANC_LIB_TRACE("Illegal State: %d\n",anc_lib_data.anc_current_state);
-        anc_lib_data.anc_current_state = ANC_CLIENT_STATE_IDLE;
+        ANC_LIB_TRACE("Illegal State: %d\n",p_cb->anc_current_state);
+        p_cb->anc_current_state = ANC_CLIENT_STATE_IDLE;
     }
     else
     {
-        if( p_data->response_data.att_value.handle == anc_lib_data.supported_new_alert_category_value_handle )
+        if( route == ANC_LIB_ROUTE_VALUE( ANC_LIB_CHAR_SUPPORTED_NEW_CATEGORY ) )
         {
-            ANC_LIB_TRACE(" [%s] Read Supported New Alerts: handle: %x\n",__FUNCTION__,p_data->response_data.att_value.handle);
+            ANC_LIB_TRACE(" [%s] Read Supported New Alerts: handle: %x\n",__FUNCTION__,handle);
 
-            if( p_data->response_data.att_value.len == 2 )
-            {
-                event_data.supported_new_alerts_result.supported_alerts =
-                    p_data->response_data.att_value.p_data[0] + (p_data->response_data.att_value.p_data[1] << 8);
-                event_data.supported_new_alerts_result.conn_id = p_data->conn_id;
-                event_data.supported_new_alerts_result.status = p_data->status;
-                anc_lib_data.p_callback(WICED_BT_ANC_READ_SUPPORTED_NEW_ALERTS_RESULT, &event_data);
-            }
+            event_data.supported_new_alerts_result.supported_alerts = anc_lib_category_mask( p_data );
+            event_data.supported_new_alerts_result.conn_id = p_data->conn_id;
+            event_data.supported_new_alerts_result.status = p_data->status;
+            event = WICED_BT_ANC_READ_SUPPORTED_NEW_ALERTS_RESULT;
         }
-        else if( p_data->response_data.att_value.handle == anc_lib_data.supported_unread_alert_category_value_handle )
+        else if( route == ANC_LIB_ROUTE_VALUE( ANC_LIB_CHAR_SUPPORTED_UNREAD_CATEGORY ) )
         {
-            ANC_LIB_TRACE(" [%s] Read Supported Unread Alerts: handle: %x\n",__FUNCTION__,p_data->response_data.att_value.handle);
+            ANC_LIB_TRACE(" [%s] Read Supported Unread Alerts: handle: %x\n",__FUNCTION__,handle);
 
-            if( p_data->response_data.att_value.len == 2 )
-            {
-                event_data.supported_unread_alerts_result.conn_id = p_data->conn_id;
-                event_data.supported_unread_alerts_result.status = p_data->status;
-                event_data.supported_unread_alerts_result.supported_alerts =
-                    p_data->response_data.att_value.p_data[0] + (p_data->response_data.att_value.p_data[1] << 8);
-                anc_lib_data.p_callback(WICED_BT_ANC_READ_SUPPORTED_UNREAD_ALERTS_RESULT, &event_data);
-            }
+            event_data.supported_unread_alerts_result.conn_id = p_data->conn_id;
+            event_data.supported_unread_alerts_result.status = p_data->status;
+            event_data.supported_unread_alerts_result.supported_alerts = anc_lib_category_mask( p_data );
+            event = WICED_BT_ANC_READ_SUPPORTED_UNREAD_ALERTS_RESULT;
         }
     }
+
+    /* the value has been decoded, free the buffer so the callback can start the next read */
+    if ( p_cb->p_read_buf != NULL )
+    {
+        wiced_bt_free_buffer( p_cb->p_read_buf );
+        p_cb->p_read_buf = NULL;
+    }
+
+    /* second half of a combined read done one by one */
+    if ( p_cb->read_unread_next && ( event == WICED_BT_ANC_READ_SUPPORTED_NEW_ALERTS_RESULT ) )
+        unread_status = anc_lib_read_category( p_cb, p_cb->handles.supported_unread_alert_category_value_handle,
+                                               UUID_CHARACTERISTIC_SUPPORTED_UNREAD_ALERT_CATEGORY );
+    p_cb->read_unread_next = 0;
+
+    if ( event != ANC_LIB_NO_EVENT )
+    {
+        anc_lib_cache_categories( p_cb, event, &event_data );
+        anc_lib_notify(event, &event_data);
+    }
+
+    if ( unread_status != WICED_BT_GATT_SUCCESS )
+    {
+        event_data.supported_unread_alerts_result.conn_id = p_cb->conn_id;
+        event_data.supported_unread_alerts_result.status = unread_status;
+        event_data.supported_unread_alerts_result.supported_alerts = 0;
+        anc_lib_notify(WICED_BT_ANC_READ_SUPPORTED_UNREAD_ALERTS_RESULT, &event_data);
+    }
+
+    anc_lib_send_queued_writes(p_cb);
 }
 
 wiced_bt_gatt_status_t wiced_bt_anc_recover_new_alerts_from_conn_loss(uint16_t conn_id, wiced_bt_anp_alert_control_cmd_id_t cmd_id, wiced_bt_anp_alert_category_id_t category)
@@ -667,53 +2668,289 @@ wiced_bt_gatt_status_t wiced_bt_anc_recover_new_unread_alerts_from_conn_loss(uin
     return result;
 }
 
-void wiced_bt_anc_client_process_notification(wiced_bt_gatt_operation_complete_t *p_data)
+/*
+ * Requests of the asynchronous API. They are started one at a time from the oldest, when
+ * nothing else of the library is on the air so that the next result event of their
+ * operation is theirs.
+ */
+static wiced_bool_t anc_lib_idle( anc_lib_cb_t *p_cb )
 {
-    uint16_t handle = p_data->response_data.att_value.handle;
-    uint8_t  *data  = p_data->response_data.att_value.p_data;
-    uint16_t len    = p_data->response_data.att_value.len;
+    return ( p_cb->anc_current_state == ANC_CLIENT_STATE_CONNECTED ) && ( p_cb->p_read_buf == NULL ) &&
+           ( p_cb->num_cp_write_req == 0 ) && ( p_cb->pending_cccd_writes == 0 ) && ( p_cb->changed_s_handle == 0 ) &&
+           ( p_cb->late_responses == 0 );
+}
+
+static void anc_lib_free_oldest_request( anc_lib_cb_t *p_cb )
+{
+    memset( &p_cb->requests[p_cb->oldest_request], 0, sizeof(anc_lib_request_t) );
+    if ( ++p_cb->oldest_request == ANC_LIB_MAX_REQUESTS )
+        p_cb->oldest_request = 0;
+    p_cb->num_requests--;
+}
+
+/* Give a result event to the started request it answers. Returns WICED_FALSE if none waits for it */
+static wiced_bool_t anc_lib_complete_request( anc_lib_cb_t *p_cb, wiced_bt_anc_event_t event, wiced_bt_anc_event_data_t *p_event_data )
+{
+    anc_lib_request_t request = p_cb->requests[p_cb->oldest_request];
+
+    if ( ( p_cb->num_requests == 0 ) || !request.started || ( anc_lib_request_events[request.op] != event ) )
+        return WICED_FALSE;
+
+    anc_lib_free_oldest_request( p_cb );
+    ANC_LIB_TRACE(" [%s] request %d event %d\n", __FUNCTION__, request.id, event);
+
+    if ( request.p_complete != NULL )
+    {
+        /* requests submitted by the completion function are started after it returns */
+        p_cb->completing_request = 1;
+        request.p_complete( request.id, event, p_event_data, request.p_context );
+        p_cb->completing_request = 0;
+    }
+    return WICED_TRUE;
+}
+
+/* Complete the oldest request with the result event of its operation carrying an error */
+static void anc_lib_request_failed( anc_lib_cb_t *p_cb, wiced_bt_gatt_status_t status )
+{
+    anc_lib_request_t *p_req = &p_cb->requests[p_cb->oldest_request];
+    wiced_bt_anc_event_t event = anc_lib_request_events[p_req->op];
     wiced_bt_anc_event_data_t event_data;
 
-    char buffer[20];
+    memset( &event_data, 0, sizeof(event_data) );
+    switch ( event )
+    {
+    case WICED_BT_ANC_READ_SUPPORTED_NEW_ALERTS_RESULT:
+        event_data.supported_new_alerts_result.conn_id = p_cb->conn_id;
+        event_data.supported_new_alerts_result.status = status;
+        break;
+    case WICED_BT_ANC_READ_SUPPORTED_UNREAD_ALERTS_RESULT:
+        event_data.supported_unread_alerts_result.conn_id = p_cb->conn_id;
+        event_data.supported_unread_alerts_result.status = status;
+        break;
+    case WICED_BT_ANC_CONTROL_ALERTS_RESULT:
+        event_data.control_alerts_result.conn_id = p_cb->conn_id;
+        event_data.control_alerts_result.control_point_cmd_id = p_req->cmd_id;
+        event_data.control_alerts_result.category_id = p_req->category;
+        event_data.control_alerts_result.status = status;
+        break;
+    default:
+        event_data.enable_disable_alerts_result.conn_id = p_cb->conn_id;
+        event_data.enable_disable_alerts_result.status = status;
+        break;
+    }
+    p_req->started = 1;
+    anc_lib_complete_request( p_cb, event, &event_data );
+}
+
+/* Complete every request of the connection with an error, the connection or its discovery is gone */
+static void anc_lib_fail_requests( anc_lib_cb_t *p_cb, wiced_bt_gatt_status_t status )
+{
+    while ( p_cb->num_requests != 0 )
+        anc_lib_request_failed( p_cb, status );
+}
+
+static wiced_bt_gatt_status_t anc_lib_run_request( anc_lib_cb_t *p_cb, anc_lib_request_t *p_req )
+{
+    switch ( p_req->op )
+    {
+    case WICED_BT_ANC_OP_READ_SUPPORTED_NEW_ALERTS:
+        return wiced_bt_anc_read_server_supported_new_alerts( p_cb->conn_id );
+    case WICED_BT_ANC_OP_READ_SUPPORTED_UNREAD_ALERTS:
+        return wiced_bt_anc_read_server_supported_unread_alerts( p_cb->conn_id );
+    case WICED_BT_ANC_OP_CONTROL_ALERTS:
+        return wiced_bt_anc_control_required_alerts( p_cb->conn_id, p_req->cmd_id, p_req->category );
+    case WICED_BT_ANC_OP_ENABLE_NEW_ALERTS:
+        return wiced_bt_anc_enable_new_alerts( p_cb->conn_id );
+    case WICED_BT_ANC_OP_DISABLE_NEW_ALERTS:
+        return wiced_bt_anc_disable_new_alerts( p_cb->conn_id );
+    case WICED_BT_ANC_OP_ENABLE_UNREAD_ALERTS:
+        return wiced_bt_anc_enable_unread_alerts( p_cb->conn_id );
+    default:
+        return wiced_bt_anc_disable_unread_alerts( p_cb->conn_id );
+    }
+}
+
+/* Start the oldest requests while the library is idle */
+static void anc_lib_start_requests( anc_lib_cb_t *p_cb )
+{
+    anc_lib_request_t *p_req;
+    wiced_bt_gatt_status_t status;
 
-    if( handle == anc_lib_data.new_alert_char_value_handle )
+    while ( ( p_cb->num_requests != 0 ) && !p_cb->completing_request && anc_lib_idle( p_cb ) )
     {
-        event_data.new_alert_notification.conn_id = p_data->conn_id;
+        p_req = &p_cb->requests[p_cb->oldest_request];
+        if ( p_req->started )
+            return;
+
+        p_req->started = 1;
+        status = anc_lib_run_request( p_cb, p_req );
+
+        /* on the air, or already completed when the answer was known */
+        if ( status == WICED_BT_GATT_SUCCESS )
+            continue;
+
+        /* the stack is busy with a request of the application, tried again with the next response */
+        if ( status == WICED_BT_GATT_BUSY )
+        {
+            p_req->started = 0;
+            return;
+        }
+        anc_lib_request_failed( p_cb, status );
+    }
+}
+
+wiced_bt_gatt_status_t wiced_bt_anc_submit( uint16_t conn_id, const wiced_bt_anc_request_t *p_request,
+        wiced_bt_anc_request_complete_t *p_complete, void *p_context, wiced_bt_anc_request_id_t *p_request_id )
+{
+    anc_lib_cb_t *p_cb = anc_lib_find_conn( conn_id );
+    anc_lib_request_t *p_req;
+
+    if ( ( p_cb == NULL ) || ( p_cb->anc_current_state == ANC_CLIENT_STATE_IDLE ) )
+        return WICED_BT_GATT_ERROR;
+
+    if ( ( p_request == NULL ) || ( p_request->op >= WICED_BT_ANC_NUM_OPS ) || ( p_complete == NULL ) || ( p_request_id == NULL ) )
+        return WICED_BT_GATT_ILLEGAL_PARAMETER;
+
+    if ( p_cb->num_requests == ANC_LIB_MAX_REQUESTS )
+        return WICED_BT_GATT_BUSY;
+
+    p_req = &p_cb->requests[( p_cb->oldest_request + p_cb->num_requests ) % ANC_LIB_MAX_REQUESTS];
+    p_cb->num_requests++;
+
+    if ( ++anc_lib_data.last_request_id == WICED_BT_ANC_INVALID_REQUEST_ID )
+        ++anc_lib_data.last_request_id;
+    p_req->id = anc_lib_data.last_request_id;
+    p_req->op = (uint8_t)p_request->op;
+    p_req->cmd_id = (uint8_t)p_request->cmd_id;
+    p_req->category = (uint8_t)p_request->category;
+    p_req->started = 0;
+    p_req->p_complete = p_complete;
+    p_req->p_context = p_context;
+
+    /* known before the request may complete */
+    *p_request_id = p_req->id;
+    ANC_LIB_TRACE(" [%s] conn %d request %d op %d\n", __FUNCTION__, conn_id, p_req->id, p_req->op);
+
+    anc_lib_start_requests( p_cb );
+    return WICED_BT_GATT_SUCCESS;
+}
+
+wiced_bool_t wiced_bt_anc_cancel( wiced_bt_anc_request_id_t request_id )
+{
+    anc_lib_cb_t *p_cb;
+    uint8_t i, n, idx, next;
+
+    if ( request_id == WICED_BT_ANC_INVALID_REQUEST_ID )
+        return WICED_FALSE;
 
-        if( p_data->response_data.att_value.len )
+    for ( i = 0; i < ANC_LIB_CONN_TABLE_SIZE; i++ )
+    {
+        p_cb = &anc_lib_data.conn[i];
+        for ( n = 0; n < p_cb->num_requests; n++ )
         {
-            /* check if the received alert category is valid */
-            if(p_data->response_data.att_value.p_data[0] <= ANP_ALERT_CATEGORY_ID_INSTANT_MESSAGE)
+            idx = ( p_cb->oldest_request + n ) % ANC_LIB_MAX_REQUESTS;
+            if ( ( p_cb->requests[idx].id != request_id ) || ( p_cb->requests[idx].p_complete == NULL ) )
+                continue;
+
+            /* on the air, the entry stays to take the result event */
+            if ( p_cb->requests[idx].started )
+            {
+                p_cb->requests[idx].p_complete = NULL;
+                return WICED_TRUE;
+            }
+
+            /* queued, the following requests move up */
+            for ( ; n + 1 < p_cb->num_requests; n++ )
             {
-                event_data.new_alert_notification.new_alert_type = p_data->response_data.att_value.p_data[0];
-                /* notify new alert */
-                event_data.new_alert_notification.new_alert_count = p_data->response_data.att_value.p_data[1];
-                event_data.new_alert_notification.p_last_alert_data = buffer;
-                memcpy(event_data.new_alert_notification.p_last_alert_data,
-                        &p_data->response_data.att_value.p_data[2], p_data->response_data.att_value.len - 2 );
-                event_data.new_alert_notification.p_last_alert_data[p_data->response_data.att_value.len - 2] = '\0';
-                anc_lib_data.p_callback(WICED_BT_ANC_EVENT_NEW_ALERT_NOTIFICATION, &event_data);
+                next = ( idx + 1 ) % ANC_LIB_MAX_REQUESTS;
+                p_cb->requests[idx] = p_cb->requests[next];
+                idx = next;
             }
-         }
+            memset( &p_cb->requests[idx], 0, sizeof(anc_lib_request_t) );
+            p_cb->num_requests--;
+            return WICED_TRUE;
+        }
     }
-    else if( handle == anc_lib_data.unread_alert_char_value_handle )
-    {
-        event_data.unread_alert_notification.conn_id = p_data->conn_id;
+    return WICED_FALSE;
+}
+
+/* New Alert: category, count and an optional text */
+static void anc_lib_decode_new_alert( wiced_bt_gatt_operation_complete_t *p_data )
+{
+    uint8_t  *data  = p_data->response_data.att_value.p_data;
+    uint16_t len    = p_data->response_data.att_value.len;
+    wiced_bt_anc_event_data_t event_data;
+    uint16_t text_len;
+
+    event_data.new_alert_notification.conn_id = p_data->conn_id;
 
-        if( p_data->response_data.att_value.len == 2 )
+    /* category and count are mandatory, the text is optional */
+    if( ( data != NULL ) && ( len >= 2 ) )
+    {
+        /* check if the received alert category is valid */
+        if(data[0] <= ANP_ALERT_CATEGORY_ID_INSTANT_MESSAGE)
         {
-            /* check if the received alert category is valid */
-            if(p_data->response_data.att_value.p_data[0] <= ANP_ALERT_CATEGORY_ID_INSTANT_MESSAGE)
+            event_data.new_alert_notification.new_alert_type = data[0];
+            /* notify new alert */
+            event_data.new_alert_notification.new_alert_count = data[1];
+            event_data.new_alert_notification.p_alert_text = &data[2];
+            event_data.new_alert_notification.alert_text_len = len - 2;
+            event_data.new_alert_notification.p_last_alert_data = NULL;
+            ANC_LIB_TRACE_BIN(ANC_TRACE_LIB_NEW_ALERT, p_data->conn_id, data[0], data[1], len - 2);
+
+            /* not on the stack of the BT thread, the copy is only valid during the callback anyway */
+            if (anc_lib_data.alert_text_mode == WICED_BT_ANC_ALERT_TEXT_COPY)
             {
-                /* notify unread alert */
-                event_data.unread_alert_notification.unread_alert_type = p_data->response_data.att_value.p_data[0];
-                event_data.unread_alert_notification.unread_count = p_data->response_data.att_value.p_data[1];
-                anc_lib_data.p_callback(WICED_BT_ANC_EVENT_UNREAD_ALERT_NOTIFICATION, &event_data);
+                text_len = len - 2;
+                if (text_len > ANC_LIB_MAX_ALERT_TEXT_LEN)
+                    text_len = ANC_LIB_MAX_ALERT_TEXT_LEN;
+                memcpy(anc_lib_data.alert_text, &data[2], text_len);
+                anc_lib_data.alert_text[text_len] = '\0';
+                event_data.new_alert_notification.p_last_alert_data = anc_lib_data.alert_text;
             }
-         }
+            anc_lib_notify(WICED_BT_ANC_EVENT_NEW_ALERT_NOTIFICATION, &event_data);
+        }
+    }
+}
+
+/* Unread Alert Status: category and count */
+static void anc_lib_decode_unread_alert( wiced_bt_gatt_operation_complete_t *p_data )
+{
+    uint8_t  *data  = p_data->response_data.att_value.p_data;
+    wiced_bt_anc_event_data_t event_data;
+
+    event_data.unread_alert_notification.conn_id = p_data->conn_id;
+
+    if( p_data->response_data.att_value.len == 2 )
+    {
+        /* check if the received alert category is valid */
+        if(data[0] <= ANP_ALERT_CATEGORY_ID_INSTANT_MESSAGE)
+        {
+            /* notify unread alert */
+            event_data.unread_alert_notification.unread_alert_type = data[0];
+            event_data.unread_alert_notification.unread_count = data[1];
+            ANC_LIB_TRACE_BIN(ANC_TRACE_LIB_UNREAD_ALERT, p_data->conn_id, data[0], data[1], 0);
+            anc_lib_notify(WICED_BT_ANC_EVENT_UNREAD_ALERT_NOTIFICATION, &event_data);
+        }
+    }
+}
+
+void wiced_bt_anc_client_process_notification(wiced_bt_gatt_operation_complete_t *p_data)
+{
+    uint16_t handle = p_data->response_data.att_value.handle;
+    anc_lib_cb_t *p_cb = anc_lib_find_conn(p_data->conn_id);
+    uint8_t route;
+
+    if (p_cb == NULL)
+        return;
+
+    route = anc_lib_route(p_cb, handle);
+    if( ANC_LIB_ROUTE_IS_VALUE( route ) && ( anc_lib_chars[route - ANC_LIB_ROUTE_VALUE( 0 )].p_decoder != NULL ) )
+    {
+        anc_lib_chars[route - ANC_LIB_ROUTE_VALUE( 0 )].p_decoder( p_data );
     }
     else
     {
-        ANC_LIB_TRACE("ANC Notification bad handle:%02x, %d\n", (uint16_t)handle, len);
+        ANC_LIB_TRACE_BIN(ANC_TRACE_LIB_BAD_NOTIFICATION, handle, p_data->response_data.att_value.len, 0, 0);
     }
 }
@@ -57,6 +57,13 @@ extern "C" {
 
 #include "wiced_bt_anp.h"
 
+/** Length of the Database Hash of the GATT server */
+#define WICED_BT_ANC_DATABASE_HASH_LEN      16
+
+/** Status of the result events of operations the server did not answer in time (see \ref wiced_bt_anc_set_gatt_timeout).
+ *  A local status of the stack, outside the range of the ATT errors a server can return */
+#define WICED_BT_ANC_GATT_TIMEOUT           WICED_BT_GATT_PENDING
+
 /**
 * \Brief ANC Events received by the applicaton's ANC callback (see \ref wiced_bt_anc_callback_t)
 *
@@ -73,6 +80,7 @@ typedef enum
     WICED_BT_ANC_DISABLE_UNREAD_ALERTS_RESULT,          /**< ANC Disable Unread Alert Notification Result */
     WICED_BT_ANC_EVENT_NEW_ALERT_NOTIFICATION,          /**< ANC New Alert Notification */
     WICED_BT_ANC_EVENT_UNREAD_ALERT_NOTIFICATION,       /**< ANC Unread Alert Notification */
+    WICED_BT_ANC_DISCOVERY_PROGRESS,                    /**< ANC Discovery found a handle the application can use */
 } wiced_bt_anc_event_t;
 
 /**
@@ -85,6 +93,33 @@ typedef struct
     wiced_bt_gatt_status_t  status;
 } wiced_bt_anc_discovery_result_t;
 
+/**
+* \brief Handles announced by WICED_BT_ANC_DISCOVERY_PROGRESS while the discovery runs.
+*
+*/
+typedef enum
+{
+    WICED_BT_ANC_CONTROL_POINT_READY,       /**< \ref wiced_bt_anc_control_required_alerts can be called */
+    WICED_BT_ANC_NEW_ALERT_CCCD_READY,      /**< \ref wiced_bt_anc_enable_new_alerts can be called */
+    WICED_BT_ANC_UNREAD_ALERT_CCCD_READY,   /**< \ref wiced_bt_anc_enable_unread_alerts can be called */
+    WICED_BT_ANC_SERVICE_CHANGED_READY,     /**< Service Changed indications are enabled, the handle cache is complete */
+    WICED_BT_ANC_DATABASE_HASH_READY,       /**< Database Hash read, the handle cache can be validated on the next connection */
+} wiced_bt_anc_discovery_item_t;
+
+/**
+* \brief Data associated with WICED_BT_ANC_DISCOVERY_PROGRESS.
+*
+* Requests made after this event and before WICED_BT_ANC_DISCOVER_RESULT are queued by the
+* library and sent as soon as the discovery releases the GATT bearer, ahead of the discovery
+* result.
+*/
+typedef struct
+{
+    uint16_t                        conn_id;
+    wiced_bt_anc_discovery_item_t   item;
+    uint16_t                        handle;     /* value handle of the control point, or CCCD handle */
+} wiced_bt_anc_discovery_progress_t;
+
 /**
 * \brief Data associated with  WICED_BT_ANC_READ_SUPPORTED_NEW_ALERTS_RESULT.
 *
@@ -138,9 +173,35 @@ typedef struct
     uint16_t                           conn_id;
     wiced_bt_anp_alert_category_id_t   new_alert_type;
     uint8_t                            new_alert_count;
-    char                               *p_last_alert_data; /* Null terminated string */
+    char                               *p_last_alert_data; /* Null terminated string, NULL in WICED_BT_ANC_ALERT_TEXT_VIEW mode */
+    const uint8_t                      *p_alert_text;      /* Text of the alert in the received packet, not null terminated */
+    uint16_t                           alert_text_len;     /* Length of p_alert_text */
 } wiced_bt_anc_new_alert_notification_t;
 
+/**
+* \brief How the text of a new alert is handed to the application
+*
+* p_alert_text and alert_text_len are always set and are only valid during the callback.
+*/
+typedef enum
+{
+    WICED_BT_ANC_ALERT_TEXT_COPY = 0,   /**< Text is also copied to a null terminated p_last_alert_data (default) */
+    WICED_BT_ANC_ALERT_TEXT_VIEW = 1,   /**< No copy, p_last_alert_data is NULL */
+} wiced_bt_anc_alert_text_mode_t;
+
+/**
+* \brief When the optional Unread Alert Status descriptors are discovered
+*
+* In lazy mode the discovery only looks for the New Alert CCCD; the Unread Alert Status CCCD
+* is searched by the first \ref wiced_bt_anc_enable_unread_alerts on the connection, so
+* applications which never use unread alerts do not pay for it.
+*/
+typedef enum
+{
+    WICED_BT_ANC_DISCOVERY_EAGER = 0,   /**< Everything is discovered before WICED_BT_ANC_DISCOVER_RESULT (default) */
+    WICED_BT_ANC_DISCOVERY_LAZY  = 1,   /**< Optional descriptors are discovered on first use */
+} wiced_bt_anc_discovery_mode_t;
+
 /**
 * \brief  Data associated with WICED_BT_ANC_EVENT_UNREAD_ALERT_NOTIFICATION
 *
@@ -152,7 +213,70 @@ typedef struct
     uint8_t                            unread_count;
 } wiced_bt_anc_unread_alert_notification_t;
 
+/**
+* \brief Attribute handles of the ANS service discovered on a peer.
+*
+* The application can store this structure along with the bonding information of the peer
+* (see \ref wiced_bt_anc_get_handle_cache) and hand it back on reconnection
+* (see \ref wiced_bt_anc_restore_handle_cache) to skip the GATT discovery.
+*/
+typedef struct
+{
+    uint16_t anc_s_handle;                                  /**< ANS service start handle */
+    uint16_t anc_e_handle;                                  /**< ANS service end handle */
+
+    uint16_t new_alert_char_handle;                         /**< New Alert characteristic handle */
+    uint16_t new_alert_char_value_handle;                   /**< New Alert characteristic value handle */
+    uint16_t new_alert_cccd_handle;                         /**< New Alert client configuration descriptor handle */
 
+    uint16_t unread_alert_char_handle;                      /**< Unread Alert Status characteristic handle */
+    uint16_t unread_alert_char_value_handle;                /**< Unread Alert Status characteristic value handle */
+    uint16_t unread_alert_cccd_handle;                      /**< Unread Alert Status client configuration descriptor handle */
+
+    uint16_t alert_notify_control_point_char_handle;        /**< Alert Notification Control Point characteristic handle */
+    uint16_t alert_notify_control_point_value_handle;       /**< Alert Notification Control Point characteristic value handle */
+
+    uint16_t supported_new_alert_category_handle;           /**< Supported New Alert Category characteristic handle */
+    uint16_t supported_new_alert_category_value_handle;     /**< Supported New Alert Category characteristic value handle */
+
+    uint16_t supported_unread_alert_category_handle;        /**< Supported Unread Alert Category characteristic handle */
+    uint16_t supported_unread_alert_category_value_handle;  /**< Supported Unread Alert Category characteristic value handle */
+
+    uint16_t service_changed_value_handle;                  /**< Service Changed characteristic value handle, in the GATT service */
+    uint16_t service_changed_cccd_handle;                   /**< Service Changed client configuration descriptor handle */
+
+    uint8_t  database_hash[WICED_BT_ANC_DATABASE_HASH_LEN]; /**< Database Hash of the server for these handles, all 0 when unknown */
+} wiced_bt_anc_handle_cache_t;
+
+/**
+* \brief Phases of the setup of a connection, timed by the library.
+*
+* See \ref wiced_bt_anc_client_get_setup_stats.
+*/
+typedef enum
+{
+    WICED_BT_ANC_PHASE_MTU_EXCHANGE,        /**< Connection up to the start of the primary service search or the handle cache restore */
+    WICED_BT_ANC_PHASE_SERVICE_SEARCH,      /**< Primary service search done by the application, or Database Hash read of \ref wiced_bt_anc_validate_handle_cache */
+    WICED_BT_ANC_PHASE_CHARACTERISTICS,     /**< ANS characteristic discovery */
+    WICED_BT_ANC_PHASE_DESCRIPTORS,         /**< New Alert and Unread Alert Status CCCD discovery */
+    WICED_BT_ANC_PHASE_FIRST_CCCD_WRITE,    /**< End of discovery to the first CCCD write confirmed by the server */
+    WICED_BT_ANC_NUM_PHASES,
+} wiced_bt_anc_setup_phase_t;
+
+/**
+* \brief Durations and request counts of the setup phases of a connection.
+*
+* A phase skipped on the connection, e.g. the discovery when the handles come from
+* the cache, has a duration of 0. Requests are GATT client requests; a discovery
+* request may take several ATT round trips when the results do not fit in one PDU.
+*/
+typedef struct
+{
+    uint32_t duration_us[WICED_BT_ANC_NUM_PHASES];  /**< Duration of each phase in microseconds */
+    uint16_t num_requests[WICED_BT_ANC_NUM_PHASES]; /**< GATT requests sent during each phase */
+    uint32_t time_to_subscribed_us;                 /**< Connection up to the first CCCD write confirmed, 0 until then */
+    wiced_bool_t handles_from_cache;                /**< Discovery skipped, handles restored from the cache */
+} wiced_bt_anc_setup_stats_t;
 
 /**
 * \brief Union of data associated with ANC events. The ANC library calls the application's
@@ -168,6 +292,7 @@ typedef union
     wiced_bt_anc_enable_disable_alerts_result_t     enable_disable_alerts_result;
     wiced_bt_anc_new_alert_notification_t           new_alert_notification;
     wiced_bt_anc_unread_alert_notification_t        unread_alert_notification;
+    wiced_bt_anc_discovery_progress_t               discovery_progress;
 } wiced_bt_anc_event_data_t;
 
 /**
@@ -183,6 +308,56 @@ typedef union
 */
 typedef void (wiced_bt_anc_callback_t)(wiced_bt_anc_event_t event, wiced_bt_anc_event_data_t *p_data);
 
+/** Identifier of a request submitted with \ref wiced_bt_anc_submit, unique over all connections */
+typedef uint16_t wiced_bt_anc_request_id_t;
+
+/** Never given to a request */
+#define WICED_BT_ANC_INVALID_REQUEST_ID     0
+
+/**
+* \brief Operations of the asynchronous API (see \ref wiced_bt_anc_submit)
+*
+*/
+typedef enum
+{
+    WICED_BT_ANC_OP_READ_SUPPORTED_NEW_ALERTS,      /**< \ref wiced_bt_anc_read_server_supported_new_alerts, completes with WICED_BT_ANC_READ_SUPPORTED_NEW_ALERTS_RESULT */
+    WICED_BT_ANC_OP_READ_SUPPORTED_UNREAD_ALERTS,   /**< \ref wiced_bt_anc_read_server_supported_unread_alerts, completes with WICED_BT_ANC_READ_SUPPORTED_UNREAD_ALERTS_RESULT */
+    WICED_BT_ANC_OP_CONTROL_ALERTS,                 /**< \ref wiced_bt_anc_control_required_alerts, completes with WICED_BT_ANC_CONTROL_ALERTS_RESULT */
+    WICED_BT_ANC_OP_ENABLE_NEW_ALERTS,              /**< \ref wiced_bt_anc_enable_new_alerts, completes with WICED_BT_ANC_ENABLE_NEW_ALERTS_RESULT */
+    WICED_BT_ANC_OP_DISABLE_NEW_ALERTS,             /**< \ref wiced_bt_anc_disable_new_alerts, completes with WICED_BT_ANC_DISABLE_NEW_ALERTS_RESULT */
+    WICED_BT_ANC_OP_ENABLE_UNREAD_ALERTS,           /**< \ref wiced_bt_anc_enable_unread_alerts, completes with WICED_BT_ANC_ENABLE_UNREAD_ALERTS_RESULT */
+    WICED_BT_ANC_OP_DISABLE_UNREAD_ALERTS,          /**< \ref wiced_bt_anc_disable_unread_alerts, completes with WICED_BT_ANC_DISABLE_UNREAD_ALERTS_RESULT */
+    WICED_BT_ANC_NUM_OPS,
+} wiced_bt_anc_op_t;
+
+/**
+* \brief Operation submitted with \ref wiced_bt_anc_submit.
+*
+*/
+typedef struct
+{
+    wiced_bt_anc_op_t                       op;         /**< Operation */
+    wiced_bt_anp_alert_control_cmd_id_t     cmd_id;     /**< Control point command, WICED_BT_ANC_OP_CONTROL_ALERTS only */
+    wiced_bt_anp_alert_category_id_t        category;   /**< Control point category, WICED_BT_ANC_OP_CONTROL_ALERTS only */
+} wiced_bt_anc_request_t;
+
+/**
+* ANC request completion function type wiced_bt_anc_request_complete_t
+*
+*                  Called once per request submitted with \ref wiced_bt_anc_submit, with the
+*                  result event of its operation. The event is not given to the
+*                  \ref wiced_bt_anc_callback_t.
+*
+* \param[in]       request_id : Identifier returned by \ref wiced_bt_anc_submit.
+* \param[in]       event      : Result event of the operation.
+* \param[in]       p_data     : Data associated with the event.
+* \param[in]       p_context  : Context given to \ref wiced_bt_anc_submit.
+*
+* \return NONE.
+*/
+typedef void (wiced_bt_anc_request_complete_t)(wiced_bt_anc_request_id_t request_id, wiced_bt_anc_event_t event,
+        wiced_bt_anc_event_data_t *p_data, void *p_context);
+
 /*****************************************************************************
 *                         Function Prototypes
 *****************************************************************************/
@@ -214,7 +389,8 @@ wiced_result_t wiced_bt_anc_init(wiced_bt_anc_callback_t *p_callback);
 * The application calls this API to Performs ANC characteristics discovery and characteristic
 * descriptor discovery.
 * Once discovery complete, registered application p_op_complete_callback is called with result of
-* operation.
+* operation. Before that, WICED_BT_ANC_DISCOVERY_PROGRESS is sent as soon as the control point and
+* each CCCD are found, so the application can subscribe without waiting for the end of discovery.
 *
 * \param           conn_id      : GATT connection ID.
 * \param           start_handle : Start GATT handle of the ANC service.
@@ -269,6 +445,11 @@ void wiced_bt_anc_client_discovery_complete(wiced_bt_gatt_discovery_complete_t *
 ***************************************************************************//**
 *
 * Once GATT discovery is complete, the Application calls this API to read the supported new alerts.
+* Before discovery, the value is read by type over the ANS range given to
+* \ref wiced_bt_anc_client_service_found, which also records its handle.
+* The value read is kept for the connection: the next calls report it with the same event,
+* given from the stack thread shortly after the call, until \ref wiced_bt_anc_client_service_changed
+* drops it.
 * Upon reception of the GATT operation result, the application must provides GATT operation result
 * through wiced_bt_anc_read_rsp API.
 *
@@ -286,7 +467,9 @@ wiced_bt_gatt_status_t wiced_bt_anc_read_server_supported_new_alerts(uint16_t co
 ***************************************************************************//**
 *
 * Once GATT discovery is complete, the Application call to Read the Value of Supported Unread
-* Alert Categories.
+* Alert Categories. Before discovery, the value is read by type over the ANS range given to
+* \ref wiced_bt_anc_client_service_found, which also records its handle.
+* As for the new alerts, the value read is kept for the connection.
 * Upon reception of the GATT operation result, the application must provides GATT operation result
 * through wiced_bt_anc_read_rsp API.
 *
@@ -297,6 +480,29 @@ wiced_bt_gatt_status_t wiced_bt_anc_read_server_supported_new_alerts(uint16_t co
 *****************************************************************************/
 wiced_bt_gatt_status_t wiced_bt_anc_read_server_supported_unread_alerts(uint16_t conn_id);
 
+/*****************************************************************************
+*
+* Function Name: wiced_bt_anc_read_server_supported_categories
+*
+***************************************************************************//**
+*
+* Once GATT discovery is complete, the Application calls this API to read the Supported New
+* Alert Categories and the Supported Unread Alert Categories in one ATT Read Multiple Request.
+* The result is reported with a WICED_BT_ANC_READ_SUPPORTED_NEW_ALERTS_RESULT event followed by
+* a WICED_BT_ANC_READ_SUPPORTED_UNREAD_ALERTS_RESULT event, as if both were read separately.
+* When the server rejects the request, the values are read one after the other, and so are the
+* next combined reads on this connection. When both values are kept from a previous read, both
+* events are given from the stack thread shortly after the call.
+* Upon reception of the GATT operation result, the application must provides GATT operation result
+* through wiced_bt_anc_read_rsp API.
+*
+* \param           conn_id: GATT connection id.
+*
+* \return          Status of the GATT operation.
+*
+*****************************************************************************/
+wiced_bt_gatt_status_t wiced_bt_anc_read_server_supported_categories(uint16_t conn_id);
+
 /*****************************************************************************
 *
 * Function Name: wiced_bt_anc_control_required_alerts
@@ -305,6 +511,10 @@ wiced_bt_gatt_status_t wiced_bt_anc_read_server_supported_unread_alerts(uint16_t
 *
 * The application use this API to control notifications using Alert notification control point
 * characteristic.
+* Up to MAX_SIMULTANIOUS_CONTROL_POINT_WRITES commands can be queued on a connection, they are
+* written one after the other and each one is reported with its own
+* WICED_BT_ANC_CONTROL_ALERTS_RESULT event, in the order of the calls. A queued command the
+* stack refuses when its turn comes is reported by its event with the error status.
 * Upon reception of the GATT operation result, the application must provides GATT operation result
 * through wiced_bt_anc_read_rsp API.
 *
@@ -312,7 +522,8 @@ wiced_bt_gatt_status_t wiced_bt_anc_read_server_supported_unread_alerts(uint16_t
 * \param           cmd_id   : ANC alert command id.
 * \param           category : ANC alert category id.
 *
-* \return          Status of the GATT operation.
+* \return          WICED_BT_GATT_SUCCESS if the command is sent or queued, error otherwise
+*                  and the command is dropped without event.
 *
 *****************************************************************************/
 wiced_bt_gatt_status_t wiced_bt_anc_control_required_alerts(uint16_t conn_id,
@@ -328,6 +539,8 @@ wiced_bt_gatt_status_t wiced_bt_anc_control_required_alerts(uint16_t conn_id,
 * receiving new alerts).
 * Upon reception of the GATT operation result, the application must provides GATT operation result
 * through wiced_bt_anc_read_rsp API.
+* Called during discovery after WICED_BT_ANC_NEW_ALERT_CCCD_READY, the write is queued and sent
+* when the discovery completes.
 *
 * \param           conn_id: GATT connection id.
 *
@@ -364,6 +577,9 @@ wiced_bt_gatt_status_t wiced_bt_anc_disable_new_alerts(uint16_t conn_id);
 * receiving new unread alerts).
 * Upon reception of the GATT operation result, the application must provides GATT operation result
 * through wiced_bt_anc_read_rsp API.
+* Called during discovery after WICED_BT_ANC_UNREAD_ALERT_CCCD_READY, the write is queued and sent
+* when the discovery completes. If the CCCD has not been searched yet (lazy discovery mode, see
+* \ref wiced_bt_anc_set_discovery_mode) the library searches it first and then writes it.
 *
 * \param           conn_id: GATT connection id.
 *
@@ -471,6 +687,8 @@ void wiced_bt_anc_read_rsp(wiced_bt_gatt_operation_complete_t *p_data);
 *
 * The application should call this function when BLE connection with a peer
 * device has been established.
+* The library keeps a separate context for every connection, up to
+* ANC_LIB_MAX_CONNECTIONS peers can be served at the same time.
 *
 * \param           p_conn_status  : pointer to a wiced_bt_gatt_connection_status_t which includes
 *                                   the address and connection ID.
@@ -487,7 +705,7 @@ void wiced_bt_anc_client_connection_up(wiced_bt_gatt_connection_status_t *p_conn
 ***************************************************************************//**
 *
 * The application should call this function when BLE connection with a peer
-* device has been disconnected.
+* device has been disconnected. The context of the connection is released.
 *
 * \param           p_conn_status  : pointer to a wiced_bt_gatt_connection_status_t which includes
 *                                   the address and connection ID.
@@ -496,6 +714,122 @@ void wiced_bt_anc_client_connection_up(wiced_bt_gatt_connection_status_t *p_conn
 *****************************************************************************/
 void wiced_bt_anc_client_connection_down(wiced_bt_gatt_connection_status_t *p_conn_status);
 
+/*****************************************************************************
+*
+* Function Name: wiced_bt_anc_client_service_search_started
+*
+***************************************************************************//**
+*
+* The application calls this function when it has sent the primary service search
+* used to find the ANS range, so the library can time it (see
+* \ref wiced_bt_anc_client_get_setup_stats). The search ends with \ref wiced_bt_anc_discover.
+* A second search of the same connection, e.g. a fallback to the full primary service
+* search, adds one request to the running phase.
+*
+* \param           conn_id  : GATT connection id.
+*
+* \return          none.
+*
+*****************************************************************************/
+void wiced_bt_anc_client_service_search_started(uint16_t conn_id);
+
+/*****************************************************************************
+*
+* Function Name: wiced_bt_anc_client_service_found
+*
+***************************************************************************//**
+*
+* The application calls this function when the primary service search found the ANS,
+* before \ref wiced_bt_anc_discover. With the range known,
+* \ref wiced_bt_anc_read_server_supported_new_alerts and
+* \ref wiced_bt_anc_read_server_supported_unread_alerts read the category values with a
+* Read By Type Request over the range, without waiting for characteristic discovery.
+*
+* \param           conn_id      : GATT connection id.
+* \param           start_handle : first handle of the ANS.
+* \param           end_handle   : last handle of the ANS.
+*
+* \return          none.
+*
+*****************************************************************************/
+void wiced_bt_anc_client_service_found(uint16_t conn_id, uint16_t start_handle, uint16_t end_handle);
+
+/*****************************************************************************
+*
+* Function Name: wiced_bt_anc_client_service_changed
+*
+***************************************************************************//**
+*
+* The application calls this function when it receives a Service Changed indication from the
+* server, unless it passes the indication to \ref wiced_bt_anc_client_process_indication.
+* When the changed range covers the ANS, the supported categories cached by
+* \ref wiced_bt_anc_read_server_supported_new_alerts and
+* \ref wiced_bt_anc_read_server_supported_unread_alerts are dropped and read again on the
+* next call, and the handles inside the range are discovered again. Handles outside the
+* range are kept, and alerts that were enabled are enabled again on the new descriptors.
+* The rediscovery ends with WICED_BT_ANC_DISCOVER_RESULT.
+*
+* \param           conn_id      : GATT connection id.
+* \param           start_handle : first handle of the changed range.
+* \param           end_handle   : last handle of the changed range.
+*
+* \return          none.
+*
+*****************************************************************************/
+void wiced_bt_anc_client_service_changed(uint16_t conn_id, uint16_t start_handle, uint16_t end_handle);
+
+/*****************************************************************************
+*
+* Function Name: wiced_bt_anc_client_get_setup_stats
+*
+***************************************************************************//**
+*
+* Returns the durations and request counts of the setup phases of a connection,
+* from \ref wiced_bt_anc_client_connection_up to the first CCCD write confirmed by
+* the server. Phases still running report the time spent so far. The library also
+* traces each phase when it ends.
+*
+* \param           conn_id  : GATT connection id.
+* \param           p_stats  : filled with the statistics of the connection.
+*
+* \return          WICED_TRUE if the connection is known.
+*
+*****************************************************************************/
+wiced_bool_t wiced_bt_anc_client_get_setup_stats(uint16_t conn_id, wiced_bt_anc_setup_stats_t *p_stats);
+
+/*****************************************************************************
+*
+* Function Name: wiced_bt_anc_client_set_mtu
+*
+***************************************************************************//**
+*
+* The application should call this function when the ATT MTU exchange started with
+* wiced_bt_gatt_client_configure_mtu completes (GATTC_OPTYPE_CONFIG_MTU).
+* Until then the library assumes the default MTU of 23 bytes.
+*
+* \param           conn_id  : GATT connection id.
+* \param           mtu      : negotiated MTU reported in response_data.mtu.
+*
+* \return          none.
+*
+*****************************************************************************/
+void wiced_bt_anc_client_set_mtu(uint16_t conn_id, uint16_t mtu);
+
+/*****************************************************************************
+*
+* Function Name: wiced_bt_anc_client_get_mtu
+*
+***************************************************************************//**
+*
+* Returns the ATT MTU of the connection as recorded by \ref wiced_bt_anc_client_set_mtu.
+*
+* \param           conn_id  : GATT connection id.
+*
+* \return          MTU of the connection, the default MTU if the connection is unknown.
+*
+*****************************************************************************/
+uint16_t wiced_bt_anc_client_get_mtu(uint16_t conn_id);
+
 /*****************************************************************************
 *
 * Function Name: wiced_bt_anc_client_process_notification
@@ -511,6 +845,192 @@ void wiced_bt_anc_client_connection_down(wiced_bt_gatt_connection_status_t *p_co
 *****************************************************************************/
 void wiced_bt_anc_client_process_notification(wiced_bt_gatt_operation_complete_t *p_data);
 
+/*****************************************************************************
+*
+* Function Name: wiced_bt_anc_client_process_indication
+*
+***************************************************************************//**
+*
+* Once the alerts are enabled, the library enables the Service Changed indications of the
+* server. The application passes the indications it receives to this function, which handles
+* the Service Changed one as \ref wiced_bt_anc_client_service_changed does. Indications of
+* other handles, and all indications until the Service Changed handle is known (see
+* WICED_BT_ANC_SERVICE_CHANGED_READY), are ignored. The application still confirms the indication.
+*
+* \param           p_data  : pointer to a GATT operation complete data structure.
+*
+* \return          none.
+*
+*****************************************************************************/
+void wiced_bt_anc_client_process_indication(wiced_bt_gatt_operation_complete_t *p_data);
+
+/*****************************************************************************
+*
+* Function Name: wiced_bt_anc_get_handle_cache
+*
+***************************************************************************//**
+*
+* The application can call this API once the discovery completed successfully to get the
+* ANS handles of the peer, e.g. to store them in NVRAM with the bonding information.
+*
+* \param           conn_id  : GATT connection id.
+* \param           p_cache  : Filled with the discovered handles.
+*
+* \return          WICED_TRUE if the discovery of the peer is complete, WICED_FALSE otherwise.
+*
+*****************************************************************************/
+wiced_bool_t wiced_bt_anc_get_handle_cache(uint16_t conn_id, wiced_bt_anc_handle_cache_t *p_cache);
+
+/*****************************************************************************
+*
+* Function Name: wiced_bt_anc_restore_handle_cache
+*
+***************************************************************************//**
+*
+* The application can call this API after \ref wiced_bt_anc_client_connection_up instead of
+* \ref wiced_bt_anc_discover when the ANS handles of a bonded peer were saved on a previous
+* connection. On success, alerts can be enabled right away without any discovery.
+*
+* \param           conn_id  : GATT connection id.
+* \param           p_cache  : Handles saved with \ref wiced_bt_anc_get_handle_cache.
+*
+* \return          WICED_BT_GATT_SUCCESS if the handles were accepted, error otherwise.
+*
+*****************************************************************************/
+wiced_bt_gatt_status_t wiced_bt_anc_restore_handle_cache(uint16_t conn_id,
+        const wiced_bt_anc_handle_cache_t *p_cache);
+
+/*****************************************************************************
+*
+* Function Name: wiced_bt_anc_validate_handle_cache
+*
+***************************************************************************//**
+*
+* Same as \ref wiced_bt_anc_restore_handle_cache, but the handles are only used if the
+* Database Hash of the server still matches the one saved with them. The library reads the
+* hash, which takes one request, and reports with WICED_BT_ANC_DISCOVER_RESULT:
+* WICED_BT_GATT_SUCCESS when it matches, the handles are restored; otherwise, e.g.
+* WICED_BT_GATT_DATABASE_OUT_OF_SYNC, the handles are dropped and the application
+* discovers the server. Alerts enabled meanwhile are sent once the handles are known.
+*
+* The hash is read after the subscriptions on every connection and kept in the handle
+* cache, see WICED_BT_ANC_DATABASE_HASH_READY.
+*
+* \param           conn_id  : GATT connection id.
+* \param           p_cache  : Handles saved with \ref wiced_bt_anc_get_handle_cache.
+*
+* \return          WICED_BT_GATT_SUCCESS if the hash is being read, WICED_BT_GATT_ATTRIBUTE_NOT_FOUND
+*                  if the cache has no hash, error otherwise.
+*
+*****************************************************************************/
+wiced_bt_gatt_status_t wiced_bt_anc_validate_handle_cache(uint16_t conn_id,
+        const wiced_bt_anc_handle_cache_t *p_cache);
+
+/*****************************************************************************
+*
+* Function Name: wiced_bt_anc_set_alert_text_mode
+*
+***************************************************************************//**
+*
+* The application can call this API after \ref wiced_bt_anc_init to select how the text of
+* new alert notifications is delivered. In WICED_BT_ANC_ALERT_TEXT_VIEW mode the library does
+* not copy the text, the application reads it from p_alert_text/alert_text_len.
+*
+* \param           mode  : Alert text delivery mode.
+*
+* \return          NONE.
+*
+*****************************************************************************/
+void wiced_bt_anc_set_alert_text_mode(wiced_bt_anc_alert_text_mode_t mode);
+
+/*****************************************************************************
+*
+* Function Name: wiced_bt_anc_set_discovery_mode
+*
+***************************************************************************//**
+*
+* The application can call this API after \ref wiced_bt_anc_init to select whether the
+* Unread Alert Status CCCD is discovered with the rest of the service or on the first
+* \ref wiced_bt_anc_enable_unread_alerts. Applies to the discoveries started afterwards.
+*
+* \param           mode  : Discovery mode.
+*
+* \return          NONE.
+*
+*****************************************************************************/
+void wiced_bt_anc_set_discovery_mode(wiced_bt_anc_discovery_mode_t mode);
+
+/*****************************************************************************
+*
+* Function Name: wiced_bt_anc_submit
+*
+***************************************************************************//**
+*
+* Asynchronous variant of the ANC operations. The request is queued on the connection, up to
+* ANC_LIB_MAX_REQUESTS of them, and sent when the library and the GATT bearer are free, one
+* after the other in submission order. Its result is given to p_complete only, with the
+* request id, so independent application components can use the same connection without
+* getting WICED_BT_GATT_BUSY or each other's results.
+*
+* p_complete is called from the stack thread, also when the supported categories are already
+* known, or before this function returns when the request cannot be sent. Requests still
+* queued or on the air when the connection goes down, or when the discovery fails, complete
+* with an error status.
+*
+* \param           conn_id       : GATT connection id.
+* \param           p_request     : Operation to perform.
+* \param           p_complete    : Called with the result of the operation.
+* \param           p_context     : Given back to p_complete.
+* \param           p_request_id  : Set to the identifier of the request.
+*
+* \return          WICED_BT_GATT_SUCCESS if the request is queued, WICED_BT_GATT_BUSY if the
+*                  request table of the connection is full, error otherwise.
+*
+*****************************************************************************/
+wiced_bt_gatt_status_t wiced_bt_anc_submit(uint16_t conn_id, const wiced_bt_anc_request_t *p_request,
+        wiced_bt_anc_request_complete_t *p_complete, void *p_context, wiced_bt_anc_request_id_t *p_request_id);
+
+/*****************************************************************************
+*
+* Function Name: wiced_bt_anc_cancel
+*
+***************************************************************************//**
+*
+* Cancels a request submitted with \ref wiced_bt_anc_submit, e.g. when the application
+* component which submitted it goes away. A queued request is dropped; a request on the
+* air still completes on the server but its completion function is not called.
+*
+* \param           request_id  : Identifier returned by \ref wiced_bt_anc_submit.
+*
+* \return          WICED_TRUE if the request was pending, WICED_FALSE otherwise.
+*
+*****************************************************************************/
+wiced_bool_t wiced_bt_anc_cancel(wiced_bt_anc_request_id_t request_id);
+
+/*****************************************************************************
+*
+* Function Name: wiced_bt_anc_set_gatt_timeout
+*
+***************************************************************************//**
+*
+* The application can call this API after \ref wiced_bt_anc_init to change how long the
+* library waits for the server to answer a GATT request it sent, 20 seconds by default, below
+* the 30 seconds ATT transaction timeout. A request not answered in timeout_ms completes with
+* WICED_BT_ANC_GATT_TIMEOUT, a discovery ends with WICED_BT_ANC_DISCOVER_RESULT. ATT allows no
+* further request on the link after a transaction timeout, so the library then disconnects it
+* with wiced_bt_gatt_disconnect. Until the GATT_CONNECTION_STATUS_EVT of the disconnection,
+* requests of the application are refused with WICED_BT_GATT_BUSY; the queued ones
+* (\ref wiced_bt_anc_submit, control point commands, pending CCCD writes) fail when the
+* application reports it with \ref wiced_bt_anc_client_connection_down. The application
+* recovers by connecting again, or advertising again if the server connects.
+*
+* \param           timeout_ms  : Time given to the server, 0 to wait forever.
+*
+* \return          NONE.
+*
+*****************************************************************************/
+void wiced_bt_anc_set_gatt_timeout(uint32_t timeout_ms);
+
 #ifdef __cplusplus
 }
 #endif
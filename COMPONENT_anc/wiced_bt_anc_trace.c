@@ -0,0 +1,175 @@
+/*
+ * Copyright 2016-2021, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Binary trace of the ANC alert path, see wiced_bt_anc_trace.h.
+ *
+ * Each thread owns a ring, only that thread writes to it, so recording is a
+ * plain store of the record followed by a release store of the head counter.
+ * The dump copies a ring and then checks the head again: records the writer
+ * may have overwritten during the copy are left out.
+ */
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "wiced_bt_anc_trace.h"
+
+typedef struct
+{
+    uint64_t           head;                /* number of records ever written */
+    anc_trace_record_t record[ANC_TRACE_RING_SIZE];
+} anc_trace_ring_t;
+
+/* Marks a thread that found no free ring, it is not traced */
+#define ANC_TRACE_NO_RING   ((anc_trace_ring_t *)1)
+
+const char * const wiced_bt_anc_trace_fmt[ANC_TRACE_NUM_EVENTS] =
+{
+#define ANC_TRACE_EVENT( id, fmt )  fmt,
+#include "wiced_bt_anc_trace_events.h"
+#undef ANC_TRACE_EVENT
+};
+
+#ifdef ANC_BINARY_TRACE
+static anc_trace_ring_t anc_trace_rings[ANC_TRACE_MAX_THREADS];
+static uint32_t anc_trace_num_rings;
+static __thread anc_trace_ring_t *p_anc_trace_thread_ring;
+
+static anc_trace_ring_t *anc_trace_get_thread_ring( void )
+{
+    uint32_t index;
+
+    if ( p_anc_trace_thread_ring == NULL )
+    {
+        index = __atomic_fetch_add( &anc_trace_num_rings, 1, __ATOMIC_RELAXED );
+        p_anc_trace_thread_ring = ( index < ANC_TRACE_MAX_THREADS ) ? &anc_trace_rings[index] : ANC_TRACE_NO_RING;
+    }
+    return p_anc_trace_thread_ring;
+}
+
+void wiced_bt_anc_trace_record(anc_trace_event_t event, uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3)
+{
+    anc_trace_ring_t   *p_ring = anc_trace_get_thread_ring();
+    anc_trace_record_t *p_record;
+    struct timespec    now;
+
+    if ( p_ring == ANC_TRACE_NO_RING )
+        return;
+
+    clock_gettime( CLOCK_MONOTONIC, &now );
+
+    p_record = &p_ring->record[p_ring->head & ( ANC_TRACE_RING_SIZE - 1 )];
+    p_record->timestamp_ns = (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+    p_record->arg[0]       = a0;
+    p_record->arg[1]       = a1;
+    p_record->arg[2]       = a2;
+    p_record->arg[3]       = a3;
+    p_record->event        = (uint16_t)event;
+    p_record->thread       = (uint16_t)( p_ring - anc_trace_rings );
+    p_record->reserved     = 0;
+
+    __atomic_store_n( &p_ring->head, p_ring->head + 1, __ATOMIC_RELEASE );
+}
+
+int wiced_bt_anc_trace_dump(const char *p_file_name)
+{
+    static anc_trace_record_t copy[ANC_TRACE_RING_SIZE];
+    anc_trace_file_hdr_t file_hdr;
+    anc_trace_ring_hdr_t ring_hdr;
+    uint64_t head, first, first_valid, i;
+    uint32_t ring;
+    FILE *p_file;
+    int rc = 0;
+
+    p_file = fopen( p_file_name, "wb" );
+    if ( p_file == NULL )
+        return -1;
+
+    file_hdr.magic       = ANC_TRACE_FILE_MAGIC;
+    file_hdr.version     = ANC_TRACE_FILE_VERSION;
+    file_hdr.record_size = sizeof(anc_trace_record_t);
+    file_hdr.num_rings   = __atomic_load_n( &anc_trace_num_rings, __ATOMIC_RELAXED );
+    if ( file_hdr.num_rings > ANC_TRACE_MAX_THREADS )
+        file_hdr.num_rings = ANC_TRACE_MAX_THREADS;
+
+    if ( fwrite( &file_hdr, sizeof(file_hdr), 1, p_file ) != 1 )
+        rc = -1;
+
+    for ( ring = 0; ( ring < file_hdr.num_rings ) && ( rc == 0 ); ring++ )
+    {
+        head  = __atomic_load_n( &anc_trace_rings[ring].head, __ATOMIC_ACQUIRE );
+        first = ( head > ANC_TRACE_RING_SIZE ) ? head - ANC_TRACE_RING_SIZE : 0;
+
+        for ( i = first; i < head; i++ )
+            copy[i - first] = anc_trace_rings[ring].record[i & ( ANC_TRACE_RING_SIZE - 1 )];
+
+        /* drop the records the writer went over while they were copied, including
+         * the slot of the record it may be writing right now */
+        first_valid = __atomic_load_n( &anc_trace_rings[ring].head, __ATOMIC_ACQUIRE ) + 1;
+        first_valid = ( first_valid > ANC_TRACE_RING_SIZE ) ? first_valid - ANC_TRACE_RING_SIZE : 0;
+        if ( first_valid < first )
+            first_valid = first;
+        if ( first_valid > head )
+            first_valid = head;
+
+        ring_hdr.thread       = ring;
+        ring_hdr.num_records  = (uint32_t)( head - first_valid );
+        ring_hdr.lost_records = first_valid;
+
+        if ( ( fwrite( &ring_hdr, sizeof(ring_hdr), 1, p_file ) != 1 ) ||
+             ( fwrite( &copy[first_valid - first], sizeof(anc_trace_record_t), ring_hdr.num_records, p_file ) != ring_hdr.num_records ) )
+            rc = -1;
+    }
+
+    if ( fclose( p_file ) != 0 )
+        rc = -1;
+
+    return rc;
+}
+#else
+void wiced_bt_anc_trace_record(anc_trace_event_t event, uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3)
+{
+    (void)event;
+    (void)a0;
+    (void)a1;
+    (void)a2;
+    (void)a3;
+}
+
+int wiced_bt_anc_trace_dump(const char *p_file_name)
+{
+    (void)p_file_name;
+    return -1;
+}
+#endif
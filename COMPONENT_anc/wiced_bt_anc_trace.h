@@ -0,0 +1,158 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/**************************************************************************//**
+* \file
+*
+* \brief Binary trace of the ANC alert path.
+*
+* When ANC_BINARY_TRACE is defined, ANC_TRACE_BIN stores a fixed size record
+* (timestamp, event id and up to four integer arguments) in a ring owned by the
+* calling thread instead of formatting a line of text. The rings keep the last
+* ANC_TRACE_RING_SIZE records of each thread and are written to a file with
+* \ref wiced_bt_anc_trace_dump, the file is turned back into text offline by
+* the anc_trace_decode tool.
+*
+* Without ANC_BINARY_TRACE, ANC_TRACE_BIN prints the same text through
+* WICED_BT_TRACE, which must be defined by the includer.
+*
+******************************************************************************/
+
+#ifndef ANC_TRACE_H
+#define ANC_TRACE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Number of records kept per thread, a power of 2 */
+#ifndef ANC_TRACE_RING_SIZE
+#define ANC_TRACE_RING_SIZE                 1024
+#endif
+
+/* Number of threads that can record at the same time */
+#ifndef ANC_TRACE_MAX_THREADS
+#define ANC_TRACE_MAX_THREADS               8
+#endif
+
+#define ANC_TRACE_NUM_ARGS                  4
+
+/* Dump file layout: anc_trace_file_hdr_t, then for every thread an
+ * anc_trace_ring_hdr_t followed by num_records anc_trace_record_t, oldest first */
+#define ANC_TRACE_FILE_MAGIC                0x54434E41  /* "ANCT" */
+#define ANC_TRACE_FILE_VERSION              1
+
+typedef enum
+{
+#define ANC_TRACE_EVENT( id, fmt )  id,
+#include "wiced_bt_anc_trace_events.h"
+#undef ANC_TRACE_EVENT
+    ANC_TRACE_NUM_EVENTS
+} anc_trace_event_t;
+
+typedef struct
+{
+    uint64_t timestamp_ns;                  /* CLOCK_MONOTONIC */
+    uint32_t arg[ANC_TRACE_NUM_ARGS];
+    uint16_t event;                         /* anc_trace_event_t */
+    uint16_t thread;                        /* index of the ring of the thread */
+    uint32_t reserved;
+} anc_trace_record_t;
+
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;
+    uint32_t num_rings;
+} anc_trace_file_hdr_t;
+
+typedef struct
+{
+    uint32_t thread;
+    uint32_t num_records;
+    uint64_t lost_records;                  /* overwritten before the dump */
+} anc_trace_ring_hdr_t;
+
+/* Format strings indexed by anc_trace_event_t */
+extern const char * const wiced_bt_anc_trace_fmt[ANC_TRACE_NUM_EVENTS];
+
+#ifdef ANC_BINARY_TRACE
+#define ANC_TRACE_BIN( event, a0, a1, a2, a3 ) \
+    wiced_bt_anc_trace_record( (event), (uint32_t)(a0), (uint32_t)(a1), (uint32_t)(a2), (uint32_t)(a3) )
+#else
+#define ANC_TRACE_BIN( event, a0, a1, a2, a3 ) \
+    WICED_BT_TRACE( wiced_bt_anc_trace_fmt[event], (a0), (a1), (a2), (a3) )
+#endif
+
+/*****************************************************************************
+*
+* Function Name: wiced_bt_anc_trace_record
+*
+***************************************************************************//**
+*
+* Stores one record in the ring of the calling thread. Lock free, the oldest
+* record of the thread is overwritten when its ring is full. If more than
+* ANC_TRACE_MAX_THREADS threads record, the extra ones are not traced.
+*
+* \param           event   : event identifier.
+* \param           a0..a3  : arguments of the event format string.
+*
+* \return          none.
+*
+*****************************************************************************/
+void wiced_bt_anc_trace_record(anc_trace_event_t event, uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3);
+
+/*****************************************************************************
+*
+* Function Name: wiced_bt_anc_trace_dump
+*
+***************************************************************************//**
+*
+* Writes the records of all threads to a file which can be read by anc_trace_decode.
+* Records added while the dump runs may or may not be part of it.
+*
+* \param           p_file_name  : path of the dump file.
+*
+* \return          0 on success, -1 if the file could not be written.
+*
+*****************************************************************************/
+int wiced_bt_anc_trace_dump(const char *p_file_name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ANC_TRACE_H */
@@ -0,0 +1,56 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/**************************************************************************//**
+* \file
+*
+* \brief Events of the ANC binary trace. Each line gives the event identifier and
+* the text format used to print its arguments, the list is shared by the
+* library, the application and the offline decoder.
+*
+* Format strings take at most ANC_TRACE_NUM_ARGS integer arguments.
+*
+******************************************************************************/
+
+/* ANC_TRACE_EVENT( id, format ) */
+ANC_TRACE_EVENT( ANC_TRACE_APP_NOTIFICATION,      "Notification Handle:0x%04x len:%u\n" )
+ANC_TRACE_EVENT( ANC_TRACE_APP_WRITE_RSP,         "Write Response handle:%04x status:%u\n" )
+ANC_TRACE_EVENT( ANC_TRACE_APP_READ_RSP,          "Read Response Handle:0x%04x status:%u\n" )
+ANC_TRACE_EVENT( ANC_TRACE_LIB_WRITE_RSP,         "[wiced_bt_anc_write_rsp] conn_id:%04x state:%02x rc:%d\n" )
+ANC_TRACE_EVENT( ANC_TRACE_LIB_READ_RSP,          "[wiced_bt_anc_read_rsp] conn_id:%04x state:%02x rc:%d\n" )
+ANC_TRACE_EVENT( ANC_TRACE_LIB_CP_WRITE,          "Control Point Value handle :0x%02x Command %d Category %d queued %d\n" )
+ANC_TRACE_EVENT( ANC_TRACE_LIB_NEW_ALERT,         "New alert conn_id:%04x type:%u count:%u len:%u\n" )
+ANC_TRACE_EVENT( ANC_TRACE_LIB_UNREAD_ALERT,      "Unread alert conn_id:%04x type:%u count:%u\n" )
+ANC_TRACE_EVENT( ANC_TRACE_LIB_BAD_NOTIFICATION,  "ANC Notification bad handle:%02x, %d\n" )
+ANC_TRACE_EVENT( ANC_TRACE_LIB_SETUP_PHASE,       "ANC setup conn_id:%04x phase:%u %u us requests:%u\n" )
+ANC_TRACE_EVENT( ANC_TRACE_LIB_SUBSCRIBED,        "ANC setup conn_id:%04x subscribed after %u us cached:%u\n" )
@@ -87,17 +87,19 @@ wiced_bt_gatt_status_t wiced_bt_util_set_gatt_client_config_descriptor(uint16_t
 wiced_bt_gatt_status_t wiced_bt_util_send_gatt_discover(uint16_t conn_id, wiced_bt_gatt_discovery_type_t type, uint16_t uuid, uint16_t s_handle, uint16_t e_handle);
 
 /**
- * Function     wiced_bt_gatt_status_t wiced_bt_util_send_gatt_read_by_handle(uint16_t conn_id, uint16_t handle)
+ * Function     wiced_bt_gatt_status_t wiced_bt_util_send_gatt_read_by_handle(uint16_t conn_id, uint16_t handle, uint8_t *p_read_buf, uint16_t len)
  *
  *              Format and send Read By Handle GATT request.
  *
  *  @param[in]  conn_id     : connection identifier.
  *  @param[in]  handle      : Attribute handle of the attribute to read.
+ *  @param[in]  p_read_buf  : Buffer receiving the value, must stay valid until the read completes.
+ *  @param[in]  len         : Size of p_read_buf.
  *
  *  @return @link wiced_bt_gatt_status_e wiced_bt_gatt_status_t @endlink
  *
  */
-wiced_bt_gatt_status_t wiced_bt_util_send_gatt_read_by_handle(uint16_t conn_id, uint16_t handle);
+wiced_bt_gatt_status_t wiced_bt_util_send_gatt_read_by_handle(uint16_t conn_id, uint16_t handle, uint8_t *p_read_buf, uint16_t len);
 
 /**
  * Function       wiced_bt_util_send_gatt_read_by_type
@@ -108,10 +110,27 @@ wiced_bt_gatt_status_t wiced_bt_util_send_gatt_read_by_handle(uint16_t conn_id,
  *  @param[in]  s_handle    : Start handle
  *  @param[in]  e_handle    : End handle
  *  @param[in]  uuid        : UUID of the attribute to read
+ *  @param[in]  p_read_buf  : Buffer receiving the value, must stay valid until the read completes
+ *  @param[in]  len         : Size of p_read_buf
  *
  *  @return @link wiced_bt_gatt_status_e wiced_bt_gatt_status_t @endlink
  */
-wiced_bt_gatt_status_t wiced_bt_util_send_gatt_read_by_type(uint16_t conn_id, uint16_t s_handle, uint16_t e_handle, uint16_t uuid);
+wiced_bt_gatt_status_t wiced_bt_util_send_gatt_read_by_type(uint16_t conn_id, uint16_t s_handle, uint16_t e_handle, uint16_t uuid, uint8_t *p_read_buf, uint16_t len);
+
+/**
+ * Function       wiced_bt_util_send_gatt_read_multiple
+ *
+ *                Format and send Read Multiple GATT request, the values are returned back to back
+ *
+ *  @param[in]  conn_id     : Connection handle
+ *  @param[in]  p_handles   : Handles of the attributes to read
+ *  @param[in]  num_handles : Number of handles, at least 2
+ *  @param[in]  p_read_buf  : Buffer receiving the values, must stay valid until the read completes
+ *  @param[in]  len         : Size of p_read_buf
+ *
+ *  @return @link wiced_bt_gatt_status_e wiced_bt_gatt_status_t @endlink
+ */
+wiced_bt_gatt_status_t wiced_bt_util_send_gatt_read_multiple(uint16_t conn_id, uint16_t *p_handles, int num_handles, uint8_t *p_read_buf, uint16_t len);
 
 /**
  * Function       wiced_bt_util_uuid_cpy
@@ -44,6 +44,7 @@
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <pthread.h>
 #include "wiced_memory.h"
 #include "wiced_bt_stack.h"
 #include "wiced_bt_dev.h"
@@ -58,12 +59,16 @@
 #include "wiced_hal_nvram.h"
 #include "wiced_bt_stack_platform.h"
 #include "app_bt_utils/app_bt_utils.h"
+#include "app_bt_utils/app_bt_event_ring.h"
+#include "app_bt_utils/app_bt_latency_hist.h"
+#include "app_bt_utils/app_bt_gatt_dispatch.h"
 #include "COMPONENT_anc/wiced_bt_anp.h"
 #include "COMPONENT_anc/wiced_bt_anc.h"
 #include "COMPONENT_anc/wiced_bt_gatt_util.h"
 #include "app_bt_config/anc_gatt_db.h"
 #include "app_bt_config/anc_bt_settings.h"
 #include "app_bt_config/anc_gap.h"
+#include "COMPONENT_anc/wiced_bt_anc_trace.h"
 #include "bt_app_anc.h"
 
 /*******************************************************************************
@@ -72,9 +77,24 @@
 #define BT_STACK_HEAP_SIZE (0xF000)
 #define ANC_LOCAL_KEYS_NVRAM_ID (WICED_NVRAM_VSID_START)
 #define ANC_PAIRED_KEYS_NVRAM_ID (WICED_NVRAM_VSID_START + 1)
+#define ANC_HANDLE_CACHE_NVRAM_ID (WICED_NVRAM_VSID_START + 2)
 #define MAX_KEY_SIZE (0x10U)
 #define ANC_DISCOVERY_STATE_SERVICE (0)
 #define ANC_DISCOVERY_STATE_ANC (1)
+#define ANC_DISCOVERY_STATE_MTU (2)
+#define ANC_DISCOVERY_STATE_CATEGORIES (3)
+#define ANC_DISCOVERY_STATE_HASH (4)
+/* Number of ANC events that can wait for the consumer thread, a power of 2. An
+ * event arriving when the ring is full is dropped, counted and reported by the
+ * consumer. 1024 absorbs the anc_bench storm at 100000 notifications per second */
+#ifndef ANC_EVENT_RING_SIZE
+#define ANC_EVENT_RING_SIZE (1024)
+#endif
+/* Longest alert text kept in an event record, one notification at the local MTU */
+#define ANC_EVENT_ALERT_TEXT_LEN (CY_BT_MTU_SIZE - 3 - 2)
+#define ANC_NUM_EVENTS (WICED_BT_ANC_DISCOVERY_PROGRESS + 1)
+/* Record of the event ring asking the consumer thread to save the handle cache it carries */
+#define ANC_APP_EVENT_SAVE_HANDLE_CACHE ((wiced_bt_anc_event_t)ANC_NUM_EVENTS)
 
 /*******************************************************************************
  *                    STRUCTURES AND ENUMERATIONS
@@ -89,6 +109,22 @@ typedef struct
     wiced_bt_ble_address_type_t addr_type;
 } bt_app_anc_app_state_t;
 
+/* ANS handles of the bonded peer, saved next to its link keys */
+typedef struct
+{
+    wiced_bt_device_address_t bd_addr;
+    wiced_bt_anc_handle_cache_t handles;
+} bt_app_anc_handle_cache_t;
+
+/* ANC event handed from the stack thread to the event consumer thread */
+typedef struct
+{
+    wiced_bt_anc_event_t event;
+    wiced_bt_anc_event_data_t data;
+    uint8_t alert_text[ANC_EVENT_ALERT_TEXT_LEN];
+    bt_app_anc_handle_cache_t handle_cache;     /* ANC_APP_EVENT_SAVE_HANDLE_CACHE */
+} bt_app_anc_event_record_t;
+
 /******************************************************************************
  *                                EXTERNS
  ******************************************************************************/
@@ -110,6 +146,53 @@ bt_app_anc_app_state_t anc_app_state;
  */
 uint8_t anc_pending_cmd_context[3] = {0};
 
+/* Look for the ANS with a primary service search by UUID, the search of all
+ * primary services is the fallback
+ */
+static wiced_bool_t anc_service_discovery_by_uuid = WICED_TRUE;
+
+/* Enable New Alert notifications as soon as discovery finds the CCCD */
+static wiced_bool_t anc_subscribe_during_discovery = WICED_FALSE;
+
+/* Read the supported categories by type once the ANS range is known, before
+ * the characteristic discovery
+ */
+static wiced_bool_t anc_read_categories_before_discovery = WICED_FALSE;
+
+/* Events queued by bt_app_anc_callback, drained by bt_app_anc_event_consumer */
+static app_bt_event_ring_t anc_event_ring;
+/* Events handled by the consumer thread */
+static uint32_t anc_events_consumed;
+/* Per ANC event: latency from the GATT event entering bt_app_anc_gatts_callback
+ * to bt_app_anc_callback, and time spent in bt_app_anc_callback */
+static app_bt_latency_hist_t anc_dispatch_latency[ANC_NUM_EVENTS];
+static app_bt_latency_hist_t anc_callback_time[ANC_NUM_EVENTS];
+/* Entry time of the GATT event being dispatched, 0 outside of the GATT callback */
+static uint64_t anc_gatt_event_start_ns;
+static const char *const anc_event_names[ANC_NUM_EVENTS] =
+{
+    "DISCOVER_RESULT",
+    "READ_SUPPORTED_NEW_ALERTS_RESULT",
+    "READ_SUPPORTED_UNREAD_ALERTS_RESULT",
+    "CONTROL_ALERTS_RESULT",
+    "ENABLE_NEW_ALERTS_RESULT",
+    "DISABLE_NEW_ALERTS_RESULT",
+    "ENABLE_UNREAD_ALERTS_RESULT",
+    "DISABLE_UNREAD_ALERTS_RESULT",
+    "EVENT_NEW_ALERT_NOTIFICATION",
+    "EVENT_UNREAD_ALERT_NOTIFICATION",
+    "DISCOVERY_PROGRESS",
+};
+static bt_app_anc_event_record_t anc_event_records[ANC_EVENT_RING_SIZE];
+/* The consumer thread writes the handle cache, the stack thread the keys */
+static pthread_mutex_t anc_nvram_mutex = PTHREAD_MUTEX_INITIALIZER;
+static wiced_bool_t anc_event_consumer_running = WICED_FALSE;
+/* Last handle cache handed to the consumer thread, which may not have written
+ * it to the NVRAM yet when the peer reconnects. It may belong to a peer that is
+ * not bonded, and never be written. Stack thread only */
+static bt_app_anc_handle_cache_t anc_last_handle_cache;
+static wiced_bool_t anc_last_handle_cache_valid = WICED_FALSE;
+
 /*******************************************************************************
  *                           FUNCTION DECLARATIONS
  *******************************************************************************/
@@ -123,21 +206,50 @@ static wiced_bt_gatt_status_t bt_app_anc_gatts_callback(wiced_bt_gatt_evt_t even
 static void bt_app_anc_load_keys_to_addr_resolution_db(void);
 static wiced_bool_t bt_app_anc_save_link_keys(wiced_bt_device_link_keys_t *p_keys);
 static wiced_bool_t bt_app_anc_read_link_keys(wiced_bt_device_link_keys_t *p_keys);
+static wiced_bool_t bt_app_anc_is_bonded(wiced_bt_device_address_t bd_addr);
+static void bt_app_anc_save_handle_cache(void);
+static void bt_app_anc_write_handle_cache(const bt_app_anc_handle_cache_t *p_cache);
+static uint16_t bt_app_anc_read_nvram(uint16_t vs_id, uint16_t data_length, uint8_t *p_data,
+                                      wiced_result_t *p_status);
+static uint16_t bt_app_anc_write_nvram(uint16_t vs_id, uint16_t data_length, uint8_t *p_data,
+                                       wiced_result_t *p_status);
+static wiced_bool_t bt_app_anc_restore_handle_cache(void);
 
 static void bt_app_anc_callback(wiced_bt_anc_event_t event, wiced_bt_anc_event_data_t *p_data);
+static void bt_app_anc_queue_event(wiced_bt_anc_event_t event, wiced_bt_anc_event_data_t *p_data);
+static void *bt_app_anc_event_consumer(void *p_arg);
+static void bt_app_anc_print_event(wiced_bt_anc_event_t event, wiced_bt_anc_event_data_t *p_data);
 
 static void bt_app_anc_set_advertisement_data();
 static wiced_bt_gatt_status_t bt_app_anc_gatt_operation_complete(wiced_bt_gatt_operation_complete_t *p_data);
 static wiced_bt_gatt_status_t bt_app_anc_gatt_discovery_result(wiced_bt_gatt_discovery_result_t *p_data);
 static wiced_bt_gatt_status_t bt_app_anc_gatt_discovery_complete(wiced_bt_gatt_discovery_complete_t *p_data);
 static void bt_app_anc_start_pair(void);
+static void bt_app_anc_start_service_discovery(wiced_bt_gatt_discovery_type_t type);
+static void bt_app_anc_start_discovery(void);
+static void bt_app_anc_start_ans_discovery(void);
 static void bt_app_anc_process_write_rsp(wiced_bt_gatt_operation_complete_t *p_data);
 static void bt_app_anc_process_read_rsp(wiced_bt_gatt_operation_complete_t *p_data);
 static void bt_app_anc_notification_handler(wiced_bt_gatt_operation_complete_t *p_data);
+static void bt_app_anc_indication_handler(wiced_bt_gatt_operation_complete_t *p_data);
+static void bt_app_anc_set_ans_range(uint16_t s_handle, uint16_t e_handle);
+static void bt_app_anc_claim_service_changed(void);
 static void bt_app_anc_trigger_pending_action(void);
 static void bt_app_clear_anc_pending_cmd_context(void);
 static const char *bt_app_alert_type_name(wiced_bt_anp_alert_category_id_t id);
 
+/* GATT client events of the ANS range and of the Service Changed characteristic,
+ * and those no other client claims, go to the ANC library
+ */
+static const app_bt_gatt_dispatch_client_t anc_dispatch_client =
+{
+    .p_read_rsp     = bt_app_anc_process_read_rsp,
+    .p_write_rsp    = bt_app_anc_process_write_rsp,
+    .p_notification = bt_app_anc_notification_handler,
+    .p_indication   = bt_app_anc_indication_handler,
+};
+static uint8_t anc_dispatch_client_id = APP_BT_GATT_DISPATCH_NO_CLIENT;
+
 /*******************************************************************************
  *                       FUNCTION DEFINITIONS
  *******************************************************************************/
@@ -207,11 +319,32 @@ void application_start( void )
 void bt_app_anc_application_init( void )
 {
     wiced_bt_gatt_status_t gatt_status = 0;
+    pthread_t consumer_thread;
+
+    /* ANC events are printed by a separate thread so the stack thread never waits on the console */
+    if (app_bt_event_ring_init(&anc_event_ring, anc_event_records,
+            sizeof(bt_app_anc_event_record_t), ANC_EVENT_RING_SIZE) &&
+        (pthread_create(&consumer_thread, NULL, bt_app_anc_event_consumer, NULL) == 0))
+    {
+        pthread_detach(consumer_thread);
+        anc_event_consumer_running = WICED_TRUE;
+    }
+    else
+    {
+        WICED_BT_TRACE("ANC event consumer thread not started\n");
+    }
 
     WICED_BT_TRACE("wiced_bt_gatt_register: %d\n", gatt_status);
     /* Register with stack to receive GATT callback */
     gatt_status = wiced_bt_gatt_register(bt_app_anc_gatts_callback);
 
+    /* ANC is the first GATT client profile, it also takes the events of no claimed range */
+    if (anc_dispatch_client_id == APP_BT_GATT_DISPATCH_NO_CLIENT)
+    {
+        anc_dispatch_client_id = app_bt_gatt_dispatch_register(&anc_dispatch_client);
+        app_bt_gatt_dispatch_set_default(anc_dispatch_client_id);
+    }
+
     WICED_BT_TRACE("wiced_bt_gatt_db_init %d\n", gatt_status);
 
     /* Allow peer to pair */
@@ -282,7 +415,9 @@ void bt_app_anc_start_advertisement()
  * Function Name: bt_app_anc_callback
  ********************************************************************************
  * Summary:
- *   This is a Callback from the ANC Profile layer
+ *   This is a Callback from the ANC Profile layer. It runs on the stack thread,
+ *   it only keeps the state needed by the stack side (handle cache, pairing)
+ *   and queues the event, printing is done by the event consumer thread.
  *
  * Parameters:
  *   event: ANC callback event from profile
@@ -296,18 +431,316 @@ static void bt_app_anc_callback(wiced_bt_anc_event_t event,
                             wiced_bt_anc_event_data_t *p_data)
 {
     wiced_bt_gatt_status_t result = WICED_BT_GATT_SUCCESS;
+    wiced_bt_anc_handle_cache_t handles;
+    uint64_t entry_ns = app_bt_latency_now_ns();
 
     if (p_data == NULL)
     {
         WICED_BT_TRACE("GATT Callback Event Data is pointing to NULL \n");
         return;
     }
+
+    if ((event < ANC_NUM_EVENTS) && (anc_gatt_event_start_ns != 0))
+    {
+        app_bt_latency_hist_record(&anc_dispatch_latency[event], entry_ns - anc_gatt_event_start_ns);
+    }
+
+    bt_app_anc_queue_event(event, p_data);
+
+    switch (event)
+    {
+    case WICED_BT_ANC_DISCOVER_RESULT:
+        result = p_data->discovery_result.status;
+        if (anc_app_state.discovery_state == ANC_DISCOVERY_STATE_HASH)
+        {
+            anc_app_state.discovery_state = ANC_DISCOVERY_STATE_ANC;
+            /* the library takes down a link whose server did not answer,
+             * the reconnection restores the handles again */
+            if ((result != WICED_BT_GATT_SUCCESS) && (result != WICED_BT_ANC_GATT_TIMEOUT))
+            {
+                /* the database of the peer changed since the handles were saved */
+                bt_app_anc_set_ans_range(0, 0);
+                bt_app_anc_start_service_discovery(anc_service_discovery_by_uuid ?
+                                                   GATT_DISCOVER_SERVICES_BY_UUID : GATT_DISCOVER_SERVICES_ALL);
+            }
+        }
+        if (result == WICED_BT_GATT_SUCCESS)
+        {
+            /* a rediscovery after a Service Changed may have moved the ANS */
+            if (wiced_bt_anc_get_handle_cache(p_data->discovery_result.conn_id, &handles))
+            {
+                bt_app_anc_set_ans_range(handles.anc_s_handle, handles.anc_e_handle);
+            }
+            bt_app_anc_save_handle_cache();
+        }
+        break;
+
+    case WICED_BT_ANC_READ_SUPPORTED_NEW_ALERTS_RESULT:
+        result = p_data->supported_new_alerts_result.status;
+        if ((anc_app_state.discovery_state == ANC_DISCOVERY_STATE_CATEGORIES) &&
+            (wiced_bt_anc_read_server_supported_unread_alerts(anc_app_state.conn_id) != WICED_BT_GATT_SUCCESS))
+        {
+            bt_app_anc_start_ans_discovery();
+        }
+        break;
+
+    case WICED_BT_ANC_READ_SUPPORTED_UNREAD_ALERTS_RESULT:
+        result = p_data->supported_unread_alerts_result.status;
+        if (anc_app_state.discovery_state == ANC_DISCOVERY_STATE_CATEGORIES)
+        {
+            bt_app_anc_start_ans_discovery();
+        }
+        break;
+
+    case WICED_BT_ANC_CONTROL_ALERTS_RESULT:
+        result = p_data->control_alerts_result.status;
+        break;
+
+    case WICED_BT_ANC_ENABLE_NEW_ALERTS_RESULT:
+    case WICED_BT_ANC_DISABLE_NEW_ALERTS_RESULT:
+    case WICED_BT_ANC_ENABLE_UNREAD_ALERTS_RESULT:
+    case WICED_BT_ANC_DISABLE_UNREAD_ALERTS_RESULT:
+        result = p_data->enable_disable_alerts_result.status;
+        break;
+
+    case WICED_BT_ANC_DISCOVERY_PROGRESS:
+        /* the library sends the write when the discovery completes */
+        if (anc_subscribe_during_discovery &&
+            (p_data->discovery_progress.item == WICED_BT_ANC_NEW_ALERT_CCCD_READY))
+        {
+            wiced_bt_anc_enable_new_alerts(p_data->discovery_progress.conn_id);
+        }
+        if (p_data->discovery_progress.item == WICED_BT_ANC_SERVICE_CHANGED_READY)
+        {
+            bt_app_anc_claim_service_changed();
+        }
+        /* found after the discovery result, save it too */
+        if ((p_data->discovery_progress.item == WICED_BT_ANC_UNREAD_ALERT_CCCD_READY) ||
+            (p_data->discovery_progress.item == WICED_BT_ANC_SERVICE_CHANGED_READY) ||
+            (p_data->discovery_progress.item == WICED_BT_ANC_DATABASE_HASH_READY))
+        {
+            bt_app_anc_save_handle_cache();
+        }
+        break;
+
+    default:
+        break;
+    }
+    if (result == WICED_BT_GATT_INSUF_AUTHENTICATION)
+    {
+        bt_app_anc_start_pair();
+    }
+    else if (event != WICED_BT_ANC_DISCOVERY_PROGRESS)
+    {
+        /* Pending command no more valid other 
+           than authentication failure cases */
+        bt_app_clear_anc_pending_cmd_context();
+    }
+
+    if (event < ANC_NUM_EVENTS)
+    {
+        app_bt_latency_hist_record(&anc_callback_time[event], app_bt_latency_now_ns() - entry_ns);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: bt_app_anc_queue_event
+ ********************************************************************************
+ * Summary:
+ *   Copies an ANC event into the event ring. Called on the stack thread, it
+ *   never blocks: if the consumer is too slow the event is dropped and counted.
+ *   The alert text is only valid during the callback so it is copied into the
+ *   record.
+ *
+ * Parameters:
+ *   event: ANC callback event from profile
+ *   p_data: Pointer to the event data
+ *
+ * Return:
+ *  None
+ *
+ *******************************************************************************/
+static void bt_app_anc_queue_event(wiced_bt_anc_event_t event,
+                            wiced_bt_anc_event_data_t *p_data)
+{
+    bt_app_anc_event_record_t *p_record;
+    uint16_t text_len;
+
+    p_record = app_bt_event_ring_reserve(&anc_event_ring);
+    if (p_record == NULL)
+    {
+        return;
+    }
+
+    p_record->event = event;
+    memcpy(&p_record->data, p_data, sizeof(p_record->data));
+
+    if (event == WICED_BT_ANC_EVENT_NEW_ALERT_NOTIFICATION)
+    {
+        text_len = p_data->new_alert_notification.alert_text_len;
+        if (text_len > sizeof(p_record->alert_text))
+        {
+            text_len = sizeof(p_record->alert_text);
+        }
+        memcpy(p_record->alert_text, p_data->new_alert_notification.p_alert_text, text_len);
+        p_record->data.new_alert_notification.p_alert_text = p_record->alert_text;
+        p_record->data.new_alert_notification.alert_text_len = text_len;
+        p_record->data.new_alert_notification.p_last_alert_data = NULL;
+    }
+
+    app_bt_event_ring_commit(&anc_event_ring);
+}
+
+/*******************************************************************************
+ * Function Name: bt_app_anc_event_consumer
+ ********************************************************************************
+ * Summary:
+ *   Thread draining the event ring filled by bt_app_anc_callback
+ *
+ * Parameters:
+ *   p_arg: Unused
+ *
+ * Return:
+ *  None
+ *
+ *******************************************************************************/
+static void *bt_app_anc_event_consumer(void *p_arg)
+{
+    bt_app_anc_event_record_t *p_record;
+    uint32_t dropped = 0;
+
+    (void)p_arg;
+
+    while ((p_record = app_bt_event_ring_wait(&anc_event_ring)) != NULL)
+    {
+        if (p_record->event == ANC_APP_EVENT_SAVE_HANDLE_CACHE)
+        {
+            bt_app_anc_write_handle_cache(&p_record->handle_cache);
+            app_bt_event_ring_release(&anc_event_ring);
+            continue;
+        }
+        bt_app_anc_print_event(p_record->event, &p_record->data);
+        app_bt_event_ring_release(&anc_event_ring);
+        __atomic_store_n(&anc_events_consumed, anc_events_consumed + 1, __ATOMIC_RELEASE);
+
+        if (dropped != app_bt_event_ring_dropped(&anc_event_ring))
+        {
+            dropped = app_bt_event_ring_dropped(&anc_event_ring);
+            WICED_BT_TRACE("ANC events dropped: %u\n", dropped);
+        }
+    }
+    return NULL;
+}
+
+/*******************************************************************************
+ * Function Name: bt_app_anc_get_event_stats
+ ********************************************************************************
+ * Summary:
+ *   Returns the number of ANC events handled by the consumer thread and the
+ *   number dropped because the event ring was full, since the start
+ *
+ * Parameters:
+ *   p_consumed: Events handled by the consumer thread
+ *   p_dropped: Events dropped
+ *
+ * Return:
+ *  None
+ *
+ *******************************************************************************/
+void bt_app_anc_get_event_stats(uint32_t *p_consumed, uint32_t *p_dropped)
+{
+    *p_consumed = __atomic_load_n(&anc_events_consumed, __ATOMIC_ACQUIRE);
+    *p_dropped = app_bt_event_ring_dropped(&anc_event_ring);
+}
+
+/*******************************************************************************
+ * Function Name: bt_app_anc_get_dispatch_latency
+ ********************************************************************************
+ * Summary:
+ *   Returns the histogram of the latency from the GATT event entering
+ *   bt_app_anc_gatts_callback to bt_app_anc_callback for an ANC event. It can
+ *   be read from any thread while events are recorded.
+ *
+ * Parameters:
+ *   event: ANC callback event
+ *
+ * Return:
+ *  Histogram, NULL for an unknown event
+ *
+ *******************************************************************************/
+const app_bt_latency_hist_t *bt_app_anc_get_dispatch_latency(wiced_bt_anc_event_t event)
+{
+    return (event < ANC_NUM_EVENTS) ? &anc_dispatch_latency[event] : NULL;
+}
+
+/*******************************************************************************
+ * Function Name: bt_app_anc_get_callback_time
+ ********************************************************************************
+ * Summary:
+ *   Returns the histogram of the time spent in bt_app_anc_callback for an ANC
+ *   event
+ *
+ * Parameters:
+ *   event: ANC callback event
+ *
+ * Return:
+ *  Histogram, NULL for an unknown event
+ *
+ *******************************************************************************/
+const app_bt_latency_hist_t *bt_app_anc_get_callback_time(wiced_bt_anc_event_t event)
+{
+    return (event < ANC_NUM_EVENTS) ? &anc_callback_time[event] : NULL;
+}
+
+/*******************************************************************************
+ * Function Name: bt_app_anc_print_latency
+ ********************************************************************************
+ * Summary:
+ *   Prints the dispatch latency and callback time of every ANC event seen
+ *
+ * Parameters:
+ *  None
+ *
+ * Return:
+ *  None
+ *
+ *******************************************************************************/
+void bt_app_anc_print_latency(void)
+{
+    char name[64];
+    int event;
+
+    for (event = 0; event < ANC_NUM_EVENTS; event++)
+    {
+        snprintf(name, sizeof(name), "%s dispatch", anc_event_names[event]);
+        app_bt_latency_hist_print(&anc_dispatch_latency[event], name);
+        snprintf(name, sizeof(name), "%s callback", anc_event_names[event]);
+        app_bt_latency_hist_print(&anc_callback_time[event], name);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: bt_app_anc_print_event
+ ********************************************************************************
+ * Summary:
+ *   Prints an ANC event, runs on the event consumer thread
+ *
+ * Parameters:
+ *   event: ANC callback event from profile
+ *   p_data: Pointer to the event data saved in the event ring
+ *
+ * Return:
+ *  None
+ *
+ *******************************************************************************/
+static void bt_app_anc_print_event(wiced_bt_anc_event_t event,
+                            wiced_bt_anc_event_data_t *p_data)
+{
     switch (event)
     {
     case WICED_BT_ANC_DISCOVER_RESULT:
         WICED_BT_TRACE("ANC discover result: %d ", 
                                         p_data->discovery_result.status);
-        result = p_data->discovery_result.status;
         break;
 
     case WICED_BT_ANC_READ_SUPPORTED_NEW_ALERTS_RESULT:
@@ -315,7 +748,6 @@ static void bt_app_anc_callback(wiced_bt_anc_event_t event,
                             p_data->supported_new_alerts_result.status);
         WICED_BT_TRACE("Supported New Alerts on ANS: %d ",
                        p_data->supported_new_alerts_result.supported_alerts);
-        result = p_data->supported_new_alerts_result.status;
         break;
 
     case WICED_BT_ANC_READ_SUPPORTED_UNREAD_ALERTS_RESULT:
@@ -323,11 +755,9 @@ static void bt_app_anc_callback(wiced_bt_anc_event_t event,
                                 p_data->supported_unread_alerts_result.status);
         WICED_BT_TRACE("Supported Unread Alerts on ANS: %d ",
                        p_data->supported_unread_alerts_result.supported_alerts);
-        result = p_data->supported_unread_alerts_result.status;
         break;
 
     case WICED_BT_ANC_CONTROL_ALERTS_RESULT:
-        result = p_data->control_alerts_result.status;
         WICED_BT_TRACE("ANC control alerts result: %d ", 
                                         p_data->control_alerts_result.status);
         break;
@@ -335,32 +765,29 @@ static void bt_app_anc_callback(wiced_bt_anc_event_t event,
     case WICED_BT_ANC_ENABLE_NEW_ALERTS_RESULT:
         WICED_BT_TRACE("ANC enable new alerts result: %d ", 
                                 p_data->enable_disable_alerts_result.status);
-        result = p_data->enable_disable_alerts_result.status;
         break;
 
     case WICED_BT_ANC_DISABLE_NEW_ALERTS_RESULT:
         WICED_BT_TRACE("ANC disable new alerts result: %d ", 
                                 p_data->enable_disable_alerts_result.status);
-        result = p_data->enable_disable_alerts_result.status;
         break;
 
     case WICED_BT_ANC_ENABLE_UNREAD_ALERTS_RESULT:
         WICED_BT_TRACE("ANC enable unread alerts result: %d ", 
                                 p_data->enable_disable_alerts_result.status);
-        result = p_data->enable_disable_alerts_result.status;
         break;
 
     case WICED_BT_ANC_DISABLE_UNREAD_ALERTS_RESULT:
         WICED_BT_TRACE("ANC disable unread alerts result: %d ", 
                                 p_data->enable_disable_alerts_result.status);
-        result = p_data->enable_disable_alerts_result.status;
         break;
 
     case WICED_BT_ANC_EVENT_NEW_ALERT_NOTIFICATION:
-        WICED_BT_TRACE("New Alert type:%s Count:%d Last Alert Data:%s\n",
+        WICED_BT_TRACE("New Alert type:%s Count:%d Last Alert Data:%.*s\n",
             bt_app_alert_type_name(p_data->new_alert_notification.new_alert_type),
             p_data->new_alert_notification.new_alert_count,
-            p_data->new_alert_notification.p_last_alert_data);
+            (int)p_data->new_alert_notification.alert_text_len,
+            (const char *)p_data->new_alert_notification.p_alert_text);
         break;
 
     case WICED_BT_ANC_EVENT_UNREAD_ALERT_NOTIFICATION:
@@ -369,19 +796,14 @@ static void bt_app_anc_callback(wiced_bt_anc_event_t event,
             p_data->unread_alert_notification.unread_count);
         break;
 
+    case WICED_BT_ANC_DISCOVERY_PROGRESS:
+        WICED_BT_TRACE("ANC discovery progress: item %d handle 0x%04x\n",
+                       p_data->discovery_progress.item, p_data->discovery_progress.handle);
+        break;
+
     default:
         break;
     }
-    if (result == WICED_BT_GATT_INSUF_AUTHENTICATION)
-    {
-        bt_app_anc_start_pair();
-    }
-    else
-    {
-        /* Pending command no more valid other 
-           than authentication failure cases */
-        bt_app_clear_anc_pending_cmd_context();
-    }
 }
 
 /******************************************************************************
@@ -432,6 +854,10 @@ wiced_result_t bt_app_anc_management_callback(wiced_bt_management_evt_t event,
 
             /* Perform application-specific initialization */
             wiced_bt_anc_init(&bt_app_anc_callback);
+            /* The alert text is printed straight from the notification, no copy needed */
+            wiced_bt_anc_set_alert_text_mode(WICED_BT_ANC_ALERT_TEXT_VIEW);
+            /* Unread alerts are optional, their CCCD is searched when first enabled */
+            wiced_bt_anc_set_discovery_mode(WICED_BT_ANC_DISCOVERY_LAZY);
             bt_app_anc_application_init();
         }
         else
@@ -527,6 +953,8 @@ wiced_result_t bt_app_anc_management_callback(wiced_bt_management_evt_t event,
             break;
         }
         bt_app_anc_save_link_keys(&p_event_data->paired_device_link_keys_update);
+        /* Discovery may have completed before the peer bonded */
+        bt_app_anc_save_handle_cache();
         break;
 
     case BTM_PAIRED_DEVICE_LINK_KEYS_REQUEST_EVT:
@@ -570,7 +998,7 @@ wiced_result_t bt_app_anc_management_callback(wiced_bt_management_evt_t event,
         }
         /* save keys to NVRAM */
         p_keys = (uint8_t *)&p_event_data->local_identity_keys_update;
-        wiced_hal_write_nvram(ANC_LOCAL_KEYS_NVRAM_ID, 
+        bt_app_anc_write_nvram(ANC_LOCAL_KEYS_NVRAM_ID, 
                     sizeof(wiced_bt_local_identity_keys_t), p_keys, &result);
         WICED_BT_TRACE("Local keys save to NVRAM result: %d \n", result);
         break;
@@ -583,7 +1011,7 @@ wiced_result_t bt_app_anc_management_callback(wiced_bt_management_evt_t event,
         }
         /* read keys from NVRAM */
         p_keys = (uint8_t *)&p_event_data->local_identity_keys_request;
-        wiced_hal_read_nvram(ANC_LOCAL_KEYS_NVRAM_ID, 
+        bt_app_anc_read_nvram(ANC_LOCAL_KEYS_NVRAM_ID, 
                     sizeof(wiced_bt_local_identity_keys_t), p_keys, &result);
         WICED_BT_TRACE("Local keys read from NVRAM result: %d \n", result);
         break;
@@ -670,6 +1098,8 @@ static wiced_bt_gatt_status_t bt_app_anc_gatts_callback(wiced_bt_gatt_evt_t even
         WICED_BT_TRACE("GATT Callback Event Data is pointing to NULL \n");
         return result;
     }
+    anc_gatt_event_start_ns = app_bt_latency_now_ns();
+
     switch (event)
     {
     case GATT_CONNECTION_STATUS_EVT:
@@ -703,6 +1133,7 @@ static wiced_bt_gatt_status_t bt_app_anc_gatts_callback(wiced_bt_gatt_evt_t even
         break;
     }
 
+    anc_gatt_event_start_ns = 0;
     return result;
 }
 
@@ -739,16 +1170,22 @@ void bt_app_anc_connection_up(wiced_bt_gatt_connection_status_t *p_conn_status)
         /* need to notify ANC library that the connection is up */
         wiced_bt_anc_client_connection_up(p_conn_status);
 
-        /* Initialize WICED BT ANC library Start discovery */
-        anc_app_state.discovery_state = ANC_DISCOVERY_STATE_SERVICE;
-        anc_app_state.anc_s_handle = 0;
-        anc_app_state.anc_e_handle = 0;
+        /* Ask for a larger MTU, the exchange is done before discovery so that
+         * discovery responses already carry more entries per PDU */
+        status = wiced_bt_gatt_client_configure_mtu(anc_app_state.conn_id, CY_BT_MTU_SIZE);
+        WICED_BT_TRACE("Configure MTU:%d status:%d\n", CY_BT_MTU_SIZE, status);
 
-        /* perform primary service search */
-        status = wiced_bt_util_send_gatt_discover(anc_app_state.conn_id, 
-                    GATT_DISCOVER_SERVICES_ALL, UUID_ATTRIBUTE_PRIMARY_SERVICE,
-                    1, 0xffff);
-        WICED_BT_TRACE("Start discover status:%d\n", status);
+        bt_app_anc_set_ans_range(0, 0);
+
+        if (status == WICED_BT_GATT_SUCCESS)
+        {
+            /* discovery, or the check of the saved handles, starts when the MTU exchange completes */
+            anc_app_state.discovery_state = ANC_DISCOVERY_STATE_MTU;
+        }
+        else
+        {
+            bt_app_anc_start_discovery();
+        }
     }
     else
     {
@@ -757,38 +1194,184 @@ void bt_app_anc_connection_up(wiced_bt_gatt_connection_status_t *p_conn_status)
 }
 
 /*******************************************************************************
-* Function Name: bt_app_anc_connection_down
+* Function Name: bt_app_anc_start_discovery
 ********************************************************************************
 * Summary:
-*   This function will be called when connection goes down
+*   Use the ANS handles saved for a bonded peer, or discover them
 *
 * Parameters:
-*   p_conn_status  : Current status of the Connection
-
+*  None
+*
 * Return:
 *  None
 *
 *******************************************************************************/
-void bt_app_anc_connection_down(wiced_bt_gatt_connection_status_t *p_conn_status)
+static void bt_app_anc_start_discovery(void)
 {
-    anc_app_state.conn_id = 0;
-    anc_app_state.anc_s_handle = 0;
-    anc_app_state.anc_e_handle = 0;
-    anc_app_state.discovery_state = ANC_DISCOVERY_STATE_SERVICE;
-
-    WICED_BT_TRACE("Connection Down \n");
-    /* pending command no more valid now */
-    bt_app_clear_anc_pending_cmd_context();
-
-    memset(anc_app_state.remote_addr, 0, sizeof(wiced_bt_device_address_t));
-    /* tell library that connection is down */
-    wiced_bt_anc_client_connection_down(p_conn_status);
+    /* Bonded peer with known handles, no need to discover */
+    if (!bt_app_anc_restore_handle_cache())
+    {
+        bt_app_anc_start_service_discovery(anc_service_discovery_by_uuid ?
+                                           GATT_DISCOVER_SERVICES_BY_UUID : GATT_DISCOVER_SERVICES_ALL);
+    }
 }
 
 /*******************************************************************************
- * Function Name: bt_app_anc_gatt_operation_complete
- ********************************************************************************
- * Summary:
+* Function Name: bt_app_anc_start_service_discovery
+********************************************************************************
+* Summary:
+*   Start the primary service search used to find the ANS range. The search
+*   by UUID only returns the ANS, if the peer rejects it the search of all
+*   primary services is used instead.
+*
+* Parameters:
+*   type  : GATT_DISCOVER_SERVICES_BY_UUID or GATT_DISCOVER_SERVICES_ALL
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void bt_app_anc_start_service_discovery(wiced_bt_gatt_discovery_type_t type)
+{
+    wiced_bt_gatt_status_t status;
+
+    /* Initialize WICED BT ANC library Start discovery */
+    anc_app_state.discovery_state = ANC_DISCOVERY_STATE_SERVICE;
+
+    /* perform primary service search */
+    status = wiced_bt_util_send_gatt_discover(anc_app_state.conn_id, type,
+                (type == GATT_DISCOVER_SERVICES_BY_UUID) ? UUID_SERVICE_ALERT_NOTIFICATION :
+                UUID_ATTRIBUTE_PRIMARY_SERVICE, 1, 0xffff);
+    WICED_BT_TRACE("Start discover type:%d status:%d\n", type, status);
+    if (status == WICED_BT_GATT_SUCCESS)
+    {
+        wiced_bt_anc_client_service_search_started(anc_app_state.conn_id);
+    }
+    else if (type == GATT_DISCOVER_SERVICES_BY_UUID)
+    {
+        bt_app_anc_start_service_discovery(GATT_DISCOVER_SERVICES_ALL);
+    }
+}
+
+/*******************************************************************************
+* Function Name: bt_app_anc_set_subscribe_during_discovery
+********************************************************************************
+* Summary:
+*   Select whether New Alert notifications are enabled as soon as the discovery
+*   finds their CCCD, ahead of the discovery result
+*
+* Parameters:
+*   enable  : WICED_TRUE to subscribe during discovery, WICED_FALSE (default)
+*             to wait for the user command
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void bt_app_anc_set_subscribe_during_discovery(wiced_bool_t enable)
+{
+    anc_subscribe_during_discovery = enable;
+}
+
+/*******************************************************************************
+* Function Name: bt_app_anc_set_service_discovery_by_uuid
+********************************************************************************
+* Summary:
+*   Select how the ANS range is searched on the next connections
+*
+* Parameters:
+*   by_uuid  : WICED_TRUE to search the ANS by its UUID (default), WICED_FALSE
+*              to search all primary services
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void bt_app_anc_set_service_discovery_by_uuid(wiced_bool_t by_uuid)
+{
+    anc_service_discovery_by_uuid = by_uuid;
+}
+
+/*******************************************************************************
+* Function Name: bt_app_anc_set_read_categories_before_discovery
+********************************************************************************
+* Summary:
+*   Select whether the Supported New and Unread Alert Categories are read by
+*   type over the ANS range as soon as the service search found it, before the
+*   characteristic discovery
+*
+* Parameters:
+*   enable  : WICED_TRUE to read the categories first, WICED_FALSE (default)
+*             to read them on user command after the discovery
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+void bt_app_anc_set_read_categories_before_discovery(wiced_bool_t enable)
+{
+    anc_read_categories_before_discovery = enable;
+}
+
+/*******************************************************************************
+* Function Name: bt_app_anc_start_ans_discovery
+********************************************************************************
+* Summary:
+*   Starts the ANC library discovery of the ANS range found by the service
+*   search
+*
+* Parameters:
+*   None
+*
+* Return:
+*  None
+*
+*******************************************************************************/
+static void bt_app_anc_start_ans_discovery(void)
+{
+    wiced_bt_gatt_status_t status;
+
+    anc_app_state.discovery_state = ANC_DISCOVERY_STATE_ANC;
+    status = wiced_bt_anc_discover(anc_app_state.conn_id, anc_app_state.anc_s_handle,
+                                   anc_app_state.anc_e_handle);
+    if (status != WICED_BT_GATT_SUCCESS)
+    {
+        WICED_BT_TRACE("ANC discover failed: %d\n", status);
+    }
+}
+
+/*******************************************************************************
+* Function Name: bt_app_anc_connection_down
+********************************************************************************
+* Summary:
+*   This function will be called when connection goes down
+*
+* Parameters:
+*   p_conn_status  : Current status of the Connection
+
+* Return:
+*  None
+*
+*******************************************************************************/
+void bt_app_anc_connection_down(wiced_bt_gatt_connection_status_t *p_conn_status)
+{
+    bt_app_anc_set_ans_range(0, 0);
+    anc_app_state.conn_id = 0;
+    anc_app_state.discovery_state = ANC_DISCOVERY_STATE_SERVICE;
+
+    WICED_BT_TRACE("Connection Down \n");
+    /* pending command no more valid now */
+    bt_app_clear_anc_pending_cmd_context();
+
+    memset(anc_app_state.remote_addr, 0, sizeof(wiced_bt_device_address_t));
+    /* tell library that connection is down */
+    wiced_bt_anc_client_connection_down(p_conn_status);
+}
+
+/*******************************************************************************
+ * Function Name: bt_app_anc_gatt_operation_complete
+ ********************************************************************************
+ * Summary:
  *   GATT operation started by the client has been completed
  *
  * Parameters:
@@ -808,26 +1391,26 @@ static wiced_bt_gatt_status_t bt_app_anc_gatt_operation_complete(wiced_bt_gatt_o
     }
     switch (p_data->op)
     {
-    case GATTC_OPTYPE_WRITE_WITH_RSP:
-    case GATTC_OPTYPE_WRITE_NO_RSP:
-        bt_app_anc_process_write_rsp(p_data);
-        break;
-
     case GATTC_OPTYPE_CONFIG_MTU:
-        WICED_BT_TRACE("This app does not support op:%d\n", p_data->op);
-        break;
-
-    case GATTC_OPTYPE_NOTIFICATION:
-        bt_app_anc_notification_handler(p_data);
-        break;
-
-    case GATTC_OPTYPE_READ_HANDLE:
-    case GATTC_OPTYPE_READ_BY_TYPE:
-        bt_app_anc_process_read_rsp(p_data);
+        WICED_BT_TRACE("MTU exchange status:%d mtu:%d\n", p_data->status, p_data->response_data.mtu);
+        if (p_data->status == WICED_BT_GATT_SUCCESS)
+        {
+            wiced_bt_anc_client_set_mtu(p_data->conn_id, p_data->response_data.mtu);
+        }
+        if (anc_app_state.discovery_state == ANC_DISCOVERY_STATE_MTU)
+        {
+            bt_app_anc_start_discovery();
+        }
         break;
 
-    case GATTC_OPTYPE_INDICATION:
-        WICED_BT_TRACE("This app does not support op:%d\n", p_data->op);
+    default:
+        /* Responses, notifications and indications go to the client owning the handle */
+        if (!app_bt_gatt_dispatch_operation_complete(p_data) &&
+            (p_data->op == GATTC_OPTYPE_INDICATION))
+        {
+            wiced_bt_gatt_client_send_indication_confirm(p_data->conn_id,
+                                                         p_data->response_data.att_value.handle);
+        }
         break;
     }
     return WICED_BT_GATT_SUCCESS;
@@ -862,7 +1445,8 @@ static wiced_bt_gatt_status_t bt_app_anc_gatt_discovery_result(wiced_bt_gatt_dis
         break;
 
     default:
-        if (p_data->discovery_type == GATT_DISCOVER_SERVICES_ALL)
+        if ((p_data->discovery_type == GATT_DISCOVER_SERVICES_ALL) ||
+            (p_data->discovery_type == GATT_DISCOVER_SERVICES_BY_UUID))
         {
             if (p_data->discovery_data.group_value.service_type.len == LEN_UUID_16)
             {
@@ -875,8 +1459,8 @@ static wiced_bt_gatt_status_t bt_app_anc_gatt_discovery_result(wiced_bt_gatt_dis
                     WICED_BT_TRACE("ANS Service found. Start Handle: %04x End Handle: %04x\n",
                                    p_data->discovery_data.group_value.s_handle,
                                    p_data->discovery_data.group_value.e_handle);
-                    anc_app_state.anc_s_handle = p_data->discovery_data.group_value.s_handle;
-                    anc_app_state.anc_e_handle = p_data->discovery_data.group_value.e_handle;
+                    bt_app_anc_set_ans_range(p_data->discovery_data.group_value.s_handle,
+                                             p_data->discovery_data.group_value.e_handle);
                 }
             }
         }
@@ -922,7 +1506,8 @@ static wiced_bt_gatt_status_t bt_app_anc_gatt_discovery_complete(wiced_bt_gatt_d
         break;
 
     default:
-        if (p_data->discovery_type == GATT_DISCOVER_SERVICES_ALL)
+        if ((p_data->discovery_type == GATT_DISCOVER_SERVICES_ALL) ||
+            (p_data->discovery_type == GATT_DISCOVER_SERVICES_BY_UUID))
         {
             WICED_BT_TRACE("ANS:Start Handle 0x%04x- End Handle 0x%04x\n",
                            anc_app_state.anc_s_handle, anc_app_state.anc_e_handle);
@@ -932,12 +1517,25 @@ static wiced_bt_gatt_status_t bt_app_anc_gatt_discovery_complete(wiced_bt_gatt_d
              */
             if ((anc_app_state.anc_s_handle != 0) && (anc_app_state.anc_e_handle != 0))
             {
-                anc_app_state.discovery_state = ANC_DISCOVERY_STATE_ANC;
-                if (wiced_bt_anc_discover(anc_app_state.conn_id, anc_app_state.anc_s_handle,
-                                          anc_app_state.anc_e_handle))
+                wiced_bt_anc_client_service_found(anc_app_state.conn_id, anc_app_state.anc_s_handle,
+                                                  anc_app_state.anc_e_handle);
+
+                /* the discovery starts once both categories are read */
+                if (anc_read_categories_before_discovery)
                 {
-                    break;
+                    anc_app_state.discovery_state = ANC_DISCOVERY_STATE_CATEGORIES;
+                    if (wiced_bt_anc_read_server_supported_new_alerts(anc_app_state.conn_id) == WICED_BT_GATT_SUCCESS)
+                    {
+                        break;
+                    }
                 }
+                bt_app_anc_start_ans_discovery();
+            }
+            else if (p_data->discovery_type == GATT_DISCOVER_SERVICES_BY_UUID)
+            {
+                /* some peers do not answer the search by UUID, look at all services */
+                WICED_BT_TRACE("ANS not found by UUID, searching all primary services\n");
+                bt_app_anc_start_service_discovery(GATT_DISCOVER_SERVICES_ALL);
             }
         }
         else
@@ -953,7 +1551,7 @@ static wiced_bt_gatt_status_t bt_app_anc_gatt_discovery_complete(wiced_bt_gatt_d
  * Function Name: bt_app_anc_process_write_rsp
  ********************************************************************************
  * Summary:
- *   Pass write response to appropriate client based on the attribute handle
+ *   Pass a write response dispatched to the ANC client to the library
  *
  * Parameters:
  *  p_data     Pointer to GATT Operation Data
@@ -964,21 +1562,17 @@ static wiced_bt_gatt_status_t bt_app_anc_gatt_discovery_complete(wiced_bt_gatt_d
  *******************************************************************************/
 static void bt_app_anc_process_write_rsp(wiced_bt_gatt_operation_complete_t *p_data)
 {
-    WICED_BT_TRACE("Write Response handle:%04x\n", p_data->response_data.handle);
+    ANC_TRACE_BIN(ANC_TRACE_APP_WRITE_RSP, p_data->response_data.handle, p_data->status, 0, 0);
 
-    /* Verify that write response is for our service */
-    if ((p_data->response_data.handle >= anc_app_state.anc_s_handle) &&
-        (p_data->response_data.handle <= anc_app_state.anc_e_handle))
-    {
-        wiced_bt_anc_write_rsp(p_data);
-    }
+    /* Inside the ANS, or the Service Changed CCCD which no client claims */
+    wiced_bt_anc_write_rsp(p_data);
 }
 
 /*******************************************************************************
  * Function Name: bt_app_anc_process_read_rsp
  ********************************************************************************
  * Summary:
- *   Pass read response to appropriate client based on the attribute handle
+ *   Pass a read response dispatched to the ANC client to the library
  *
  * Parameters:
  *  p_data     Pointer to GATT Operation Data
@@ -990,21 +1584,19 @@ static void bt_app_anc_process_write_rsp(wiced_bt_gatt_operation_complete_t *p_d
  *******************************************************************************/
 static void bt_app_anc_process_read_rsp(wiced_bt_gatt_operation_complete_t *p_data)
 {
-    WICED_BT_TRACE("Read Response Handle:0x%04x\n", p_data->response_data.handle);
+    ANC_TRACE_BIN(ANC_TRACE_APP_READ_RSP, p_data->response_data.handle, p_data->status, 0, 0);
 
-    /* Verify that write response is for our service */
-    if ((p_data->response_data.handle >= anc_app_state.anc_s_handle) &&
-        (p_data->response_data.handle <= anc_app_state.anc_e_handle))
-    {
-        wiced_bt_anc_read_rsp(p_data);
-    }
+    /* Read by handle inside the ANS, or by type and multiple handles which only
+     * the ANC library sends
+     */
+    wiced_bt_anc_read_rsp(p_data);
 }
 
 /*******************************************************************************
  * Function Name: bt_app_anc_notification_handler
  ********************************************************************************
  * Summary:
- *   Pass notification to appropriate client based on the attribute handle
+ *   Pass a notification dispatched to the ANC client to the library
  *
  * Parameters:
  *  p_data     Pointer to GATT Operation Data
@@ -1015,15 +1607,103 @@ static void bt_app_anc_process_read_rsp(wiced_bt_gatt_operation_complete_t *p_da
  *******************************************************************************/
 static void bt_app_anc_notification_handler(wiced_bt_gatt_operation_complete_t *p_data)
 {
-    WICED_BT_TRACE("Notification Handle:0x%04x\n", p_data->response_data.att_value.handle);
+    ANC_TRACE_BIN(ANC_TRACE_APP_NOTIFICATION, p_data->response_data.att_value.handle,
+                  p_data->response_data.att_value.len, 0, 0);
 
-    /* Verify that notification is for ANCS service and if true pass to
-     * the library for processing
-     */
-    if ((p_data->response_data.att_value.handle >= anc_app_state.anc_s_handle) &&
-        (p_data->response_data.att_value.handle < anc_app_state.anc_e_handle))
+    /* Only notifications inside the ANS are dispatched here */
+    wiced_bt_anc_client_process_notification(p_data);
+}
+
+/*******************************************************************************
+ * Function Name: bt_app_anc_indication_handler
+ ********************************************************************************
+ * Summary:
+ *   Passes an indication to the library, which handles Service Changed, and
+ *   confirms it
+ *
+ * Parameters:
+ *  p_data     Pointer to GATT Operation Data
+ *
+ * Return:
+ *  None
+ *
+ *******************************************************************************/
+static void bt_app_anc_indication_handler(wiced_bt_gatt_operation_complete_t *p_data)
+{
+    WICED_BT_TRACE("Indication handle:0x%04x len:%d\n", p_data->response_data.att_value.handle,
+                   p_data->response_data.att_value.len);
+
+    wiced_bt_anc_client_process_indication(p_data);
+    wiced_bt_gatt_client_send_indication_confirm(p_data->conn_id, p_data->response_data.att_value.handle);
+}
+
+/*******************************************************************************
+ * Function Name: bt_app_anc_set_ans_range
+ ********************************************************************************
+ * Summary:
+ *   Keep the ANS range of the connection and claim it in the GATT client
+ *   dispatch, a range of 0 drops the claim
+ *
+ * Parameters:
+ *  s_handle   ANS start handle
+ *  e_handle   ANS end handle
+ *
+ * Return:
+ *  None
+ *
+ *******************************************************************************/
+static void bt_app_anc_set_ans_range(uint16_t s_handle, uint16_t e_handle)
+{
+    app_bt_gatt_dispatch_release(anc_dispatch_client_id, anc_app_state.conn_id);
+
+    anc_app_state.anc_s_handle = s_handle;
+    anc_app_state.anc_e_handle = e_handle;
+
+    if ((s_handle != 0) &&
+        !app_bt_gatt_dispatch_claim(anc_dispatch_client_id, anc_app_state.conn_id, s_handle, e_handle))
+    {
+        WICED_BT_TRACE("ANS range 0x%04x-0x%04x not claimed\n", s_handle, e_handle);
+    }
+    if (s_handle != 0)
     {
-        wiced_bt_anc_client_process_notification(p_data);
+        bt_app_anc_claim_service_changed();
+    }
+}
+
+/*******************************************************************************
+ * Function Name: bt_app_anc_claim_service_changed
+ ********************************************************************************
+ * Summary:
+ *   Claim the Service Changed characteristic of the connection for the ANC
+ *   library once its handle is known, so that its indications do not depend on
+ *   the ANC client being the default client of the GATT client dispatch
+ *
+ * Parameters:
+ *  None
+ *
+ * Return:
+ *  None
+ *
+ *******************************************************************************/
+static void bt_app_anc_claim_service_changed(void)
+{
+    wiced_bt_anc_handle_cache_t handles;
+    uint16_t handle;
+
+    if (!wiced_bt_anc_get_handle_cache(anc_app_state.conn_id, &handles) ||
+        (handles.service_changed_value_handle == 0))
+    {
+        return;
+    }
+
+    /* already claimed when the ANS range is set again */
+    handle = handles.service_changed_value_handle;
+    if (app_bt_gatt_dispatch_owner(anc_app_state.conn_id, handle) != anc_dispatch_client_id)
+    {
+        if (!app_bt_gatt_dispatch_claim(anc_dispatch_client_id, anc_app_state.conn_id, handle, handle))
+        {
+            WICED_BT_TRACE("Service Changed handle 0x%04x not claimed\n", handle);
+        }
     }
 }
 
@@ -1109,6 +1789,10 @@ wiced_bt_gatt_status_t bt_app_handle_usr_cmd(uint8_t cmd, uint8_t cmd_id,
         gatt_status = wiced_bt_anc_read_server_supported_unread_alerts(anc_app_state.conn_id);
         break;
 
+    case USR_ANC_COMMAND_READ_SERVER_SUPPORTED_CATEGORIES:
+        gatt_status = wiced_bt_anc_read_server_supported_categories(anc_app_state.conn_id);
+        break;
+
     case USR_ANC_COMMAND_CONTROL_ALERTS:
         gatt_status = wiced_bt_anc_control_required_alerts(anc_app_state.conn_id,
                                     (wiced_bt_anp_alert_control_cmd_id_t)cmd_id,
@@ -1255,7 +1939,7 @@ void bt_app_anc_load_keys_to_addr_resolution_db( void )
     wiced_result_t result;
     wiced_bt_device_link_keys_t keys;
 
-    bytes_read = wiced_hal_read_nvram(ANC_PAIRED_KEYS_NVRAM_ID, sizeof(keys), 
+    bytes_read = bt_app_anc_read_nvram(ANC_PAIRED_KEYS_NVRAM_ID, sizeof(keys), 
                                                     (uint8_t *)&keys, &result);
 
     WICED_BT_TRACE(" [%s] Read status %d bytes read %d \n", __FUNCTION__, 
@@ -1286,7 +1970,7 @@ wiced_bool_t bt_app_anc_save_link_keys(wiced_bt_device_link_keys_t *p_keys)
     uint8_t bytes_written;
     wiced_result_t result;
 
-    bytes_written = wiced_hal_write_nvram(ANC_PAIRED_KEYS_NVRAM_ID, 
+    bytes_written = bt_app_anc_write_nvram(ANC_PAIRED_KEYS_NVRAM_ID, 
             sizeof(wiced_bt_device_link_keys_t), (uint8_t *)p_keys, &result);
     WICED_BT_TRACE("Saved %d bytes at id:%d \n", bytes_written, 
                                                     ANC_PAIRED_KEYS_NVRAM_ID);
@@ -1310,9 +1994,243 @@ wiced_bool_t bt_app_anc_read_link_keys(wiced_bt_device_link_keys_t *p_keys)
     uint8_t bytes_read;
     wiced_result_t result;
 
-    bytes_read = wiced_hal_read_nvram(ANC_PAIRED_KEYS_NVRAM_ID, 
+    bytes_read = bt_app_anc_read_nvram(ANC_PAIRED_KEYS_NVRAM_ID, 
                  sizeof(wiced_bt_device_link_keys_t), (uint8_t *)p_keys, &result);
     WICED_BT_TRACE("Read %d bytes at id:%d \n", bytes_read, ANC_PAIRED_KEYS_NVRAM_ID);
     return (bytes_read == sizeof(wiced_bt_device_link_keys_t));
 }
+/******************************************************************************
+ * Function Name : bt_app_anc_is_bonded
+ * ****************************************************************************
+ * Summary :
+ *    Check if the link keys stored in the NVRAM belong to the given device
+ *
+ * Parameters:
+ *    bd_addr: Address of the peer device
+ *
+ * Return:
+ *    wiced_bool_t: 1 if True and 0 if false
+ *****************************************************************************/
+static wiced_bool_t bt_app_anc_is_bonded(wiced_bt_device_address_t bd_addr)
+{
+    wiced_bt_device_link_keys_t keys;
+
+    if (!bt_app_anc_read_link_keys(&keys))
+    {
+        return WICED_FALSE;
+    }
+    return (memcmp(keys.bd_addr, bd_addr, sizeof(wiced_bt_device_address_t)) == 0);
+}
+
+/******************************************************************************
+ * Function Name : bt_app_anc_save_handle_cache
+ * ****************************************************************************
+ * Summary :
+ *    Hand the ANS handles discovered on the connected peer to the event
+ *    consumer thread, which saves them to the NVRAM so that the discovery can
+ *    be skipped on the next connection. Called on the stack thread, it does
+ *    not wait on the NVRAM.
+ *
+ * Parameters:
+ *    None
+ *
+ * Return:
+ *    None
+ *****************************************************************************/
+static void bt_app_anc_save_handle_cache(void)
+{
+    bt_app_anc_handle_cache_t cache;
+    bt_app_anc_event_record_t *p_record;
+
+    memset(&cache, 0, sizeof(cache));
+    if ((anc_app_state.conn_id == 0) ||
+        !wiced_bt_anc_get_handle_cache(anc_app_state.conn_id, &cache.handles))
+    {
+        return;
+    }
+    memcpy(cache.bd_addr, anc_app_state.remote_addr, sizeof(cache.bd_addr));
+
+    if (!anc_event_consumer_running)
+    {
+        bt_app_anc_write_handle_cache(&cache);
+        return;
+    }
+
+    p_record = app_bt_event_ring_reserve(&anc_event_ring);
+    if (p_record == NULL)
+    {
+        WICED_BT_TRACE("ANS handles not saved, event ring full\n");
+        return;
+    }
+    p_record->event = ANC_APP_EVENT_SAVE_HANDLE_CACHE;
+    memcpy(&p_record->handle_cache, &cache, sizeof(cache));
+    app_bt_event_ring_commit(&anc_event_ring);
+
+    memcpy(&anc_last_handle_cache, &cache, sizeof(cache));
+    anc_last_handle_cache_valid = WICED_TRUE;
+}
+
+/******************************************************************************
+ * Function Name : bt_app_anc_write_handle_cache
+ * ****************************************************************************
+ * Summary :
+ *    Write the ANS handles of a peer to the NVRAM, on the event consumer
+ *    thread. Handles are only kept for the bonded peer, and only written when
+ *    they differ from those already saved.
+ *
+ * Parameters:
+ *    p_cache: handles and address of the peer
+ *
+ * Return:
+ *    None
+ *****************************************************************************/
+static void bt_app_anc_write_handle_cache(const bt_app_anc_handle_cache_t *p_cache)
+{
+    bt_app_anc_handle_cache_t stored;
+    uint16_t bytes;
+    wiced_result_t result;
+
+    if (!bt_app_anc_is_bonded((uint8_t *)p_cache->bd_addr))
+    {
+        return;
+    }
+
+    bytes = bt_app_anc_read_nvram(ANC_HANDLE_CACHE_NVRAM_ID, sizeof(stored),
+                                  (uint8_t *)&stored, &result);
+    if ((result == WICED_SUCCESS) && (bytes == sizeof(stored)) &&
+        (memcmp(&stored, p_cache, sizeof(stored)) == 0))
+    {
+        return;
+    }
+
+    bytes = bt_app_anc_write_nvram(ANC_HANDLE_CACHE_NVRAM_ID, sizeof(*p_cache),
+                                   (uint8_t *)p_cache, &result);
+    if ((result != WICED_SUCCESS) || (bytes != sizeof(*p_cache)))
+    {
+        WICED_BT_TRACE("Failed to save ANS handles at id:%d result:%d\n",
+                       ANC_HANDLE_CACHE_NVRAM_ID, result);
+        return;
+    }
+    WICED_BT_TRACE("Saved ANS handles %d bytes at id:%d \n", bytes,
+                                                    ANC_HANDLE_CACHE_NVRAM_ID);
+}
+
+/******************************************************************************
+ * Function Name : bt_app_anc_read_nvram
+ * ****************************************************************************
+ * Summary :
+ *    wiced_hal_read_nvram, serialized with the NVRAM accesses of the other
+ *    thread
+ *
+ * Parameters:
+ *    vs_id, data_length, p_data, p_status: see wiced_hal_read_nvram
+ *
+ * Return:
+ *    uint16_t: number of bytes read
+ *****************************************************************************/
+static uint16_t bt_app_anc_read_nvram(uint16_t vs_id, uint16_t data_length, uint8_t *p_data,
+                                      wiced_result_t *p_status)
+{
+    uint16_t bytes;
+
+    pthread_mutex_lock(&anc_nvram_mutex);
+    bytes = wiced_hal_read_nvram(vs_id, data_length, p_data, p_status);
+    pthread_mutex_unlock(&anc_nvram_mutex);
+    return bytes;
+}
+
+/******************************************************************************
+ * Function Name : bt_app_anc_write_nvram
+ * ****************************************************************************
+ * Summary :
+ *    wiced_hal_write_nvram, serialized with the NVRAM accesses of the other
+ *    thread
+ *
+ * Parameters:
+ *    vs_id, data_length, p_data, p_status: see wiced_hal_write_nvram
+ *
+ * Return:
+ *    uint16_t: number of bytes written
+ *****************************************************************************/
+static uint16_t bt_app_anc_write_nvram(uint16_t vs_id, uint16_t data_length, uint8_t *p_data,
+                                       wiced_result_t *p_status)
+{
+    uint16_t bytes;
+
+    pthread_mutex_lock(&anc_nvram_mutex);
+    bytes = wiced_hal_write_nvram(vs_id, data_length, p_data, p_status);
+    pthread_mutex_unlock(&anc_nvram_mutex);
+    return bytes;
+}
+
+/******************************************************************************
+ * Function Name : bt_app_anc_restore_handle_cache
+ * ****************************************************************************
+ * Summary :
+ *    Hand the ANS handles saved for the connected peer to the ANC library.
+ *    Handles saved with the Database Hash of the peer are only used once the
+ *    library checked the hash, the result comes with WICED_BT_ANC_DISCOVER_RESULT.
+ *
+ * Parameters:
+ *    None
+ *
+ * Return:
+ *    wiced_bool_t: 1 if the handles were restored and discovery is not
+ *    needed, 0 otherwise
+ *****************************************************************************/
+static wiced_bool_t bt_app_anc_restore_handle_cache(void)
+{
+    bt_app_anc_handle_cache_t cache;
+    uint16_t bytes_read;
+    wiced_result_t result;
+    wiced_bt_gatt_status_t status;
+
+    if (!bt_app_anc_is_bonded(anc_app_state.remote_addr))
+    {
+        return WICED_FALSE;
+    }
+
+    if (anc_last_handle_cache_valid &&
+        (memcmp(anc_last_handle_cache.bd_addr, anc_app_state.remote_addr, sizeof(cache.bd_addr)) == 0))
+    {
+        /* newer than the NVRAM, or the same. Otherwise the last peer was
+         * another one and the NVRAM has the handles of the bonded peer */
+        memcpy(&cache, &anc_last_handle_cache, sizeof(cache));
+    }
+    else
+    {
+        bytes_read = bt_app_anc_read_nvram(ANC_HANDLE_CACHE_NVRAM_ID, sizeof(cache),
+                                          (uint8_t *)&cache, &result);
+        if ((result != WICED_SUCCESS) || (bytes_read != sizeof(cache)))
+        {
+            return WICED_FALSE;
+        }
+    }
+    if (memcmp(cache.bd_addr, anc_app_state.remote_addr, sizeof(cache.bd_addr)) != 0)
+    {
+        return WICED_FALSE;
+    }
+
+    status = wiced_bt_anc_validate_handle_cache(anc_app_state.conn_id, &cache.handles);
+    if (status == WICED_BT_GATT_SUCCESS)
+    {
+        anc_app_state.discovery_state = ANC_DISCOVERY_STATE_HASH;
+    }
+    else if ((status == WICED_BT_GATT_ATTRIBUTE_NOT_FOUND) &&
+             (wiced_bt_anc_restore_handle_cache(anc_app_state.conn_id, &cache.handles) ==
+                                                            WICED_BT_GATT_SUCCESS))
+    {
+        /* saved before the hash of the peer was known */
+        anc_app_state.discovery_state = ANC_DISCOVERY_STATE_ANC;
+    }
+    else
+    {
+        return WICED_FALSE;
+    }
+
+    bt_app_anc_set_ans_range(cache.handles.anc_s_handle, cache.handles.anc_e_handle);
+    WICED_BT_TRACE("ANS handles restored from NVRAM: Start Handle 0x%04x End Handle 0x%04x\n",
+                   anc_app_state.anc_s_handle, anc_app_state.anc_e_handle);
+    return WICED_TRUE;
+}
 /* END OF FILE [] */
@@ -51,6 +51,7 @@
 #include "app_bt_utils/app_bt_utils.h"
 #include "utils_arg_parser.h"
 #include "bt_app_anc.h"
+#include "wiced_bt_anc_trace.h"
 
 /******************************************************************************
  *                               MACROS
@@ -61,6 +62,12 @@
 #define INVALID_IP_CMD (15)
 #define EXP_IP_RET_VAL (1)
 #define INVALID_SCAN   (0)
+/* Menu option after the ANC commands */
+#define PRINT_LATENCY_CMD (9)
+/* File receiving the binary trace on exit, decode it with anc_trace_decode */
+#ifndef ANC_TRACE_DUMP_FILE
+#define ANC_TRACE_DUMP_FILE "anc_trace.bin"
+#endif
 
 /******************************************************************************
  *                    STRUCTURES AND ENUMERATIONS
@@ -82,8 +89,10 @@ static const char bt_app_anc_app_menu[] = "\n\
     6.  Enable Unread Alert Status Notification \n\
     7.  Disable New Alerts Notification \n\
     8.  Disable Unread Alerts Status Notification \n\
+    9.  Print ANC Event Latency \n\
+    10. Read Supported New and Unread Alert Categories \n\
  =============================================================\n\
- Choose option (0-8): ";
+ Choose option (0-10): ";
 
 static const char alert_ids[] = "\
     ----------------------------- \n\
@@ -236,6 +245,7 @@ int main(int argc, char *argv[])
             /* Fall through as it is the same function called to execute command */
         case USR_ANC_COMMAND_READ_SERVER_SUPPORTED_NEW_ALERTS:
         case USR_ANC_COMMAND_READ_SERVER_SUPPORTED_UNREAD_ALERTS:
+        case USR_ANC_COMMAND_READ_SERVER_SUPPORTED_CATEGORIES:
         case USR_ANC_COMMAND_ENABLE_NTF_NEW_ALERTS:
         case USR_ANC_COMMAND_ENABLE_NTF_UNREAD_ALERT_STATUS:
         case USR_ANC_COMMAND_DISABLE_NTF_NEW_ALERTS:
@@ -276,6 +286,10 @@ int main(int argc, char *argv[])
             }
             break;
 
+        case PRINT_LATENCY_CMD:
+            bt_app_anc_print_latency();
+            break;
+
         default:
             fprintf(stdout,
                     "Unknown ANC Command. Choose option from the Menu \n");
@@ -290,6 +304,13 @@ int main(int argc, char *argv[])
     } while (ip != 0);
 
     fprintf(stdout, "Exiting...\n");
+    bt_app_anc_print_latency();
+#ifdef ANC_BINARY_TRACE
+    if (wiced_bt_anc_trace_dump(ANC_TRACE_DUMP_FILE) == 0)
+    {
+        fprintf(stdout, "ANC trace written to %s\n", ANC_TRACE_DUMP_FILE);
+    }
+#endif
     wiced_bt_delete_heap(p_default_heap);
     wiced_bt_stack_deinit();
 
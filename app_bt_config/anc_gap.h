@@ -58,8 +58,11 @@
 
 /* Maximum attribute length */
 #define CY_BT_MAX_ATTR_LEN                                    512
-/* Maximum attribute MTU size */
-#define CY_BT_MTU_SIZE                                        23
+/* Maximum attribute MTU size, requested from the server at connection up.
+ * Should be between 23 and (CY_BT_MAX_ATTR_LEN + 5) */
+#ifndef CY_BT_MTU_SIZE
+#define CY_BT_MTU_SIZE                                        247
+#endif
 
 /* RX PDU size */
 #define CY_BT_RX_PDU_SIZE                                     512
@@ -0,0 +1,203 @@
+/******************************************************************************
+ * (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+ *******************************************************************************
+ * This software, including source code, documentation and related materials
+ * ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software ("EULA").
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress's integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ ******************************************************************************/
+/******************************************************************************
+ * File Name:   app_bt_event_ring.c
+ *
+ * Description: Bounded single producer / single consumer ring of fixed size
+ *              records. head and tail are free running counters, the slot of
+ *              a counter is (counter & mask). Each side publishes its counter
+ *              with a release store and reads the other one with an acquire
+ *              load, so a record is always completely written before the
+ *              consumer can see it.
+ *
+ * Related Document: See Readme.md
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *                                INCLUDES
+ *****************************************************************************/
+#include <errno.h>
+#include "app_bt_event_ring.h"
+
+/****************************************************************************
+ *                                FUNCTION DEFINITIONS
+ ***************************************************************************/
+/******************************************************************************
+ * Function Name: app_bt_event_ring_init()
+ *******************************************************************************
+ * Summary:
+ *   Initialize a ring over storage provided by the caller
+ *
+ * Parameters:
+ *   app_bt_event_ring_t *p_ring         : ring to initialize
+ *   void *p_storage                     : num_records * record_size bytes
+ *   uint32_t record_size                : size of one record
+ *   uint32_t num_records                : number of records, a power of 2
+ *
+ * Return:
+ *  wiced_bool_t                         : WICED_FALSE on invalid parameters
+ *
+ ******************************************************************************/
+wiced_bool_t app_bt_event_ring_init( app_bt_event_ring_t *p_ring, void *p_storage,
+                                     uint32_t record_size, uint32_t num_records )
+{
+    if ( ( p_ring == NULL ) || ( p_storage == NULL ) || ( record_size == 0 ) ||
+         ( num_records == 0 ) || ( num_records & ( num_records - 1 ) ) )
+    {
+        return WICED_FALSE;
+    }
+
+    p_ring->head        = 0;
+    p_ring->tail        = 0;
+    p_ring->dropped     = 0;
+    p_ring->mask        = num_records - 1;
+    p_ring->record_size = record_size;
+    p_ring->p_records   = (uint8_t *)p_storage;
+
+    return ( sem_init( &p_ring->records_available, 0, 0 ) == 0 ) ? WICED_TRUE : WICED_FALSE;
+}
+
+/******************************************************************************
+ * Function Name: app_bt_event_ring_reserve()
+ *******************************************************************************
+ * Summary:
+ *   Producer side. Returns the next free slot to be filled in place, the slot
+ *   is handed to the consumer by app_bt_event_ring_commit(). Never blocks, if
+ *   the ring is full the record is counted as dropped.
+ *
+ * Parameters:
+ *   app_bt_event_ring_t *p_ring         : ring
+ *
+ * Return:
+ *  void *                               : free slot, NULL if the ring is full
+ *
+ ******************************************************************************/
+void *app_bt_event_ring_reserve( app_bt_event_ring_t *p_ring )
+{
+    uint32_t head = p_ring->head;
+    uint32_t tail = __atomic_load_n( &p_ring->tail, __ATOMIC_ACQUIRE );
+
+    if ( ( head - tail ) > p_ring->mask )
+    {
+        __atomic_store_n( &p_ring->dropped, p_ring->dropped + 1, __ATOMIC_RELAXED );
+        return NULL;
+    }
+
+    return &p_ring->p_records[( head & p_ring->mask ) * p_ring->record_size];
+}
+
+/******************************************************************************
+ * Function Name: app_bt_event_ring_commit()
+ *******************************************************************************
+ * Summary:
+ *   Producer side. Publishes the slot returned by app_bt_event_ring_reserve()
+ *   and wakes up the consumer.
+ *
+ * Parameters:
+ *   app_bt_event_ring_t *p_ring         : ring
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void app_bt_event_ring_commit( app_bt_event_ring_t *p_ring )
+{
+    __atomic_store_n( &p_ring->head, p_ring->head + 1, __ATOMIC_RELEASE );
+    sem_post( &p_ring->records_available );
+}
+
+/******************************************************************************
+ * Function Name: app_bt_event_ring_wait()
+ *******************************************************************************
+ * Summary:
+ *   Consumer side. Blocks until a record is available and returns it, the
+ *   record stays valid until app_bt_event_ring_release() is called.
+ *
+ * Parameters:
+ *   app_bt_event_ring_t *p_ring         : ring
+ *
+ * Return:
+ *  void *                               : oldest record
+ *
+ ******************************************************************************/
+void *app_bt_event_ring_wait( app_bt_event_ring_t *p_ring )
+{
+    uint32_t tail = p_ring->tail;
+
+    while ( __atomic_load_n( &p_ring->head, __ATOMIC_ACQUIRE ) == tail )
+    {
+        if ( ( sem_wait( &p_ring->records_available ) != 0 ) && ( errno != EINTR ) )
+        {
+            return NULL;
+        }
+    }
+
+    return &p_ring->p_records[( tail & p_ring->mask ) * p_ring->record_size];
+}
+
+/******************************************************************************
+ * Function Name: app_bt_event_ring_release()
+ *******************************************************************************
+ * Summary:
+ *   Consumer side. Gives the record returned by app_bt_event_ring_wait() back
+ *   to the producer.
+ *
+ * Parameters:
+ *   app_bt_event_ring_t *p_ring         : ring
+ *
+ * Return:
+ *  void
+ *
+ ******************************************************************************/
+void app_bt_event_ring_release( app_bt_event_ring_t *p_ring )
+{
+    __atomic_store_n( &p_ring->tail, p_ring->tail + 1, __ATOMIC_RELEASE );
+}
+
+/******************************************************************************
+ * Function Name: app_bt_event_ring_dropped()
+ *******************************************************************************
+ * Summary:
+ *   Number of records the producer could not queue because the ring was full
+ *
+ * Parameters:
+ *   app_bt_event_ring_t *p_ring         : ring
+ *
+ * Return:
+ *  uint32_t                             : dropped records
+ *
+ ******************************************************************************/
+uint32_t app_bt_event_ring_dropped( app_bt_event_ring_t *p_ring )
+{
+    return __atomic_load_n( &p_ring->dropped, __ATOMIC_RELAXED );
+}
@@ -0,0 +1,91 @@
+/******************************************************************************
+ * (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+ *******************************************************************************
+ * This software, including source code, documentation and related materials
+ * ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software ("EULA").
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress's integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ ******************************************************************************/
+/******************************************************************************
+ * File Name:   app_bt_event_ring.h
+ *
+ * Description: Bounded single producer / single consumer ring of fixed size
+ *              records. The producer side never blocks and never takes a lock
+ *              so it can be used from the Bluetooth stack callback thread, the
+ *              consumer side can block until a record is available.
+ *
+ * Related Document: See Readme.md
+ *
+ ******************************************************************************/
+
+#ifndef __APP_BT_EVENT_RING_H__
+#define __APP_BT_EVENT_RING_H__
+
+/******************************************************************************
+ *                                INCLUDES
+ *****************************************************************************/
+#include <stdint.h>
+#include <semaphore.h>
+#include "wiced_bt_types.h"
+
+/******************************************************************************
+ *                                MACROS
+ *****************************************************************************/
+/* Keeps the producer and consumer indexes on different cache lines */
+#define APP_BT_EVENT_RING_CACHE_LINE    64
+
+/******************************************************************************
+ *                    STRUCTURES AND ENUMERATIONS
+ *****************************************************************************/
+typedef struct
+{
+    /* Producer side */
+    uint32_t head;              /* next slot to write, only written by the producer */
+    uint32_t dropped;           /* records lost because the ring was full */
+    uint8_t  pad_head[APP_BT_EVENT_RING_CACHE_LINE - 2 * sizeof(uint32_t)];
+
+    /* Consumer side */
+    uint32_t tail;              /* next slot to read, only written by the consumer */
+    uint8_t  pad_tail[APP_BT_EVENT_RING_CACHE_LINE - sizeof(uint32_t)];
+
+    uint32_t mask;              /* number of slots - 1, the number of slots is a power of 2 */
+    uint32_t record_size;       /* size of one slot in bytes */
+    uint8_t  *p_records;        /* storage of (mask + 1) * record_size bytes */
+    sem_t    records_available; /* posted once per committed record */
+} app_bt_event_ring_t;
+
+/****************************************************************************
+ *                              FUNCTION DECLARATIONS
+ ***************************************************************************/
+wiced_bool_t app_bt_event_ring_init( app_bt_event_ring_t *p_ring, void *p_storage,
+                                     uint32_t record_size, uint32_t num_records );
+void *app_bt_event_ring_reserve( app_bt_event_ring_t *p_ring );
+void app_bt_event_ring_commit( app_bt_event_ring_t *p_ring );
+void *app_bt_event_ring_wait( app_bt_event_ring_t *p_ring );
+void app_bt_event_ring_release( app_bt_event_ring_t *p_ring );
+uint32_t app_bt_event_ring_dropped( app_bt_event_ring_t *p_ring );
+
+#endif /*__APP_BT_EVENT_RING_H__ */
@@ -0,0 +1,347 @@
+/******************************************************************************
+ * (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+ *******************************************************************************
+ * This software, including source code, documentation and related materials
+ * ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software ("EULA").
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress's integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ ******************************************************************************/
+/******************************************************************************
+ * File Name:   app_bt_gatt_dispatch.c
+ *
+ * Description: Dispatch of the GATT client events to the profile clients.
+ *              A claimed range is keyed by (conn_id << 16 | start handle) and
+ *              the ranges are kept sorted on that key, they never overlap on
+ *              a connection. The owner of a handle is the range with the
+ *              largest key not above (conn_id << 16 | handle), if the handle
+ *              is not past its end.
+ *
+ * Related Document: See Readme.md
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *                                INCLUDES
+ *****************************************************************************/
+#include <string.h>
+#include "app_bt_gatt_dispatch.h"
+
+/******************************************************************************
+ *                    STRUCTURES AND ENUMERATIONS
+ *****************************************************************************/
+typedef struct
+{
+    uint32_t key;               /* conn_id << 16 | start handle */
+    uint16_t e_handle;
+    uint8_t  client_id;
+} app_bt_gatt_dispatch_range_t;
+
+/*******************************************************************************
+ *                           GLOBAL VARIABLES
+ *******************************************************************************/
+static const app_bt_gatt_dispatch_client_t *dispatch_clients[APP_BT_GATT_DISPATCH_MAX_CLIENTS];
+static uint8_t dispatch_num_clients;
+static uint8_t dispatch_default_client = APP_BT_GATT_DISPATCH_NO_CLIENT;
+
+static app_bt_gatt_dispatch_range_t dispatch_ranges[APP_BT_GATT_DISPATCH_MAX_RANGES];
+static uint8_t dispatch_num_ranges;
+
+/****************************************************************************
+ *                                FUNCTION DEFINITIONS
+ ***************************************************************************/
+/******************************************************************************
+ * Function Name: app_bt_gatt_dispatch_key()
+ *******************************************************************************
+ * Summary:
+ *   Sort key of a handle on a connection
+ *
+ ******************************************************************************/
+static uint32_t app_bt_gatt_dispatch_key( uint16_t conn_id, uint16_t handle )
+{
+    return ( (uint32_t)conn_id << 16 ) | handle;
+}
+
+/******************************************************************************
+ * Function Name: app_bt_gatt_dispatch_search()
+ *******************************************************************************
+ * Summary:
+ *   Number of ranges with a key not above key, the range before that index is
+ *   the only one that can hold key
+ *
+ ******************************************************************************/
+static uint8_t app_bt_gatt_dispatch_search( uint32_t key )
+{
+    uint8_t low = 0;
+    uint8_t high = dispatch_num_ranges;
+    uint8_t mid;
+
+    while ( low < high )
+    {
+        mid = (uint8_t)( ( low + high ) / 2 );
+        if ( dispatch_ranges[mid].key <= key )
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return low;
+}
+
+/******************************************************************************
+ * Function Name: app_bt_gatt_dispatch_register()
+ *******************************************************************************
+ * Summary:
+ *   Register the handlers of a profile client
+ *
+ * Parameters:
+ *   const app_bt_gatt_dispatch_client_t *p_client : handlers, kept by reference
+ *
+ * Return:
+ *  uint8_t : client id, APP_BT_GATT_DISPATCH_NO_CLIENT when the registry is full
+ *
+ ******************************************************************************/
+uint8_t app_bt_gatt_dispatch_register( const app_bt_gatt_dispatch_client_t *p_client )
+{
+    if ( ( p_client == NULL ) || ( dispatch_num_clients == APP_BT_GATT_DISPATCH_MAX_CLIENTS ) )
+        return APP_BT_GATT_DISPATCH_NO_CLIENT;
+
+    dispatch_clients[dispatch_num_clients] = p_client;
+    return dispatch_num_clients++;
+}
+
+/******************************************************************************
+ * Function Name: app_bt_gatt_dispatch_set_default()
+ *******************************************************************************
+ * Summary:
+ *   Client given the events that no claimed range owns: read by type and read
+ *   multiple responses, failed reads whose handle is 0 or outside of the
+ *   claimed ranges, write responses and indications outside of the claimed
+ *   ranges. Notifications outside of the
+ *   claimed ranges are dropped.
+ *
+ * Parameters:
+ *   uint8_t client_id : registered client, APP_BT_GATT_DISPATCH_NO_CLIENT for none
+ *
+ * Return:
+ *  None
+ *
+ ******************************************************************************/
+void app_bt_gatt_dispatch_set_default( uint8_t client_id )
+{
+    dispatch_default_client = ( client_id < dispatch_num_clients ) ? client_id : APP_BT_GATT_DISPATCH_NO_CLIENT;
+}
+
+/******************************************************************************
+ * Function Name: app_bt_gatt_dispatch_claim()
+ *******************************************************************************
+ * Summary:
+ *   Route the events of a handle range on a connection to a client
+ *
+ * Parameters:
+ *   uint8_t client_id  : registered client
+ *   uint16_t conn_id   : connection
+ *   uint16_t s_handle  : first handle of the range
+ *   uint16_t e_handle  : last handle of the range
+ *
+ * Return:
+ *  wiced_bool_t : WICED_FALSE if the range is invalid, overlaps a claimed range
+ *                 or the registry is full
+ *
+ ******************************************************************************/
+wiced_bool_t app_bt_gatt_dispatch_claim( uint8_t client_id, uint16_t conn_id,
+                                         uint16_t s_handle, uint16_t e_handle )
+{
+    uint32_t key = app_bt_gatt_dispatch_key( conn_id, s_handle );
+    uint8_t idx;
+
+    if ( ( client_id >= dispatch_num_clients ) || ( s_handle == 0 ) || ( e_handle < s_handle ) ||
+         ( dispatch_num_ranges == APP_BT_GATT_DISPATCH_MAX_RANGES ) )
+    {
+        return WICED_FALSE;
+    }
+
+    idx = app_bt_gatt_dispatch_search( key );
+
+    /* the range before ends before s_handle, the range after starts after e_handle */
+    if ( ( idx > 0 ) && ( ( dispatch_ranges[idx - 1].key >> 16 ) == conn_id ) &&
+         ( dispatch_ranges[idx - 1].e_handle >= s_handle ) )
+    {
+        return WICED_FALSE;
+    }
+    if ( ( idx < dispatch_num_ranges ) &&
+         ( dispatch_ranges[idx].key <= app_bt_gatt_dispatch_key( conn_id, e_handle ) ) )
+    {
+        return WICED_FALSE;
+    }
+
+    memmove( &dispatch_ranges[idx + 1], &dispatch_ranges[idx],
+             ( dispatch_num_ranges - idx ) * sizeof(dispatch_ranges[0]) );
+    dispatch_ranges[idx].key = key;
+    dispatch_ranges[idx].e_handle = e_handle;
+    dispatch_ranges[idx].client_id = client_id;
+    dispatch_num_ranges++;
+
+    return WICED_TRUE;
+}
+
+/******************************************************************************
+ * Function Name: app_bt_gatt_dispatch_release()
+ *******************************************************************************
+ * Summary:
+ *   Drop the ranges a client claimed on a connection
+ *
+ * Parameters:
+ *   uint8_t client_id  : registered client
+ *   uint16_t conn_id   : connection
+ *
+ * Return:
+ *  None
+ *
+ ******************************************************************************/
+void app_bt_gatt_dispatch_release( uint8_t client_id, uint16_t conn_id )
+{
+    uint8_t i, kept = 0;
+
+    for ( i = 0; i < dispatch_num_ranges; i++ )
+    {
+        if ( ( dispatch_ranges[i].client_id == client_id ) && ( ( dispatch_ranges[i].key >> 16 ) == conn_id ) )
+            continue;
+        dispatch_ranges[kept++] = dispatch_ranges[i];
+    }
+    dispatch_num_ranges = kept;
+}
+
+/******************************************************************************
+ * Function Name: app_bt_gatt_dispatch_owner()
+ *******************************************************************************
+ * Summary:
+ *   Client owning a handle on a connection
+ *
+ * Parameters:
+ *   uint16_t conn_id   : connection
+ *   uint16_t handle    : attribute handle
+ *
+ * Return:
+ *  uint8_t : client id, APP_BT_GATT_DISPATCH_NO_CLIENT when no range holds the handle
+ *
+ ******************************************************************************/
+uint8_t app_bt_gatt_dispatch_owner( uint16_t conn_id, uint16_t handle )
+{
+    uint8_t idx = app_bt_gatt_dispatch_search( app_bt_gatt_dispatch_key( conn_id, handle ) );
+
+    if ( ( idx == 0 ) || ( ( dispatch_ranges[idx - 1].key >> 16 ) != conn_id ) ||
+         ( dispatch_ranges[idx - 1].e_handle < handle ) )
+    {
+        return APP_BT_GATT_DISPATCH_NO_CLIENT;
+    }
+    return dispatch_ranges[idx - 1].client_id;
+}
+
+/******************************************************************************
+ * Function Name: app_bt_gatt_dispatch_operation_complete()
+ *******************************************************************************
+ * Summary:
+ *   Pass a read or write response, a notification or an indication to the
+ *   client owning its handle, see app_bt_gatt_dispatch_set_default for the
+ *   events without an owner
+ *
+ * Parameters:
+ *   wiced_bt_gatt_operation_complete_t *p_data : GATT operation data
+ *
+ * Return:
+ *  wiced_bool_t : WICED_FALSE if no client took the event
+ *
+ ******************************************************************************/
+wiced_bool_t app_bt_gatt_dispatch_operation_complete( wiced_bt_gatt_operation_complete_t *p_data )
+{
+    const app_bt_gatt_dispatch_client_t *p_client;
+    app_bt_gatt_dispatch_handler_t *p_handler;
+    uint8_t client_id;
+    uint16_t handle;
+    wiced_bool_t use_default;
+
+    switch ( p_data->op )
+    {
+    case GATTC_OPTYPE_WRITE_WITH_RSP:
+    case GATTC_OPTYPE_WRITE_NO_RSP:
+        handle = p_data->response_data.handle;
+        use_default = WICED_TRUE;
+        break;
+
+    case GATTC_OPTYPE_READ_HANDLE:
+        /* the client that sent a failed read waits for it, whatever its handle */
+        handle = p_data->response_data.att_value.handle;
+        use_default = ( p_data->status != WICED_BT_GATT_SUCCESS ) ? WICED_TRUE : WICED_FALSE;
+        break;
+
+    case GATTC_OPTYPE_READ_BY_TYPE:
+    case GATTC_OPTYPE_READ_MULTIPLE:
+    case GATTC_OPTYPE_INDICATION:
+        handle = p_data->response_data.att_value.handle;
+        use_default = WICED_TRUE;
+        break;
+
+    case GATTC_OPTYPE_NOTIFICATION:
+        handle = p_data->response_data.att_value.handle;
+        use_default = WICED_FALSE;
+        break;
+
+    default:
+        return WICED_FALSE;
+    }
+
+    client_id = app_bt_gatt_dispatch_owner( p_data->conn_id, handle );
+    if ( ( client_id == APP_BT_GATT_DISPATCH_NO_CLIENT ) && use_default )
+        client_id = dispatch_default_client;
+    if ( client_id == APP_BT_GATT_DISPATCH_NO_CLIENT )
+        return WICED_FALSE;
+
+    p_client = dispatch_clients[client_id];
+    switch ( p_data->op )
+    {
+    case GATTC_OPTYPE_WRITE_WITH_RSP:
+    case GATTC_OPTYPE_WRITE_NO_RSP:
+        p_handler = p_client->p_write_rsp;
+        break;
+
+    case GATTC_OPTYPE_NOTIFICATION:
+        p_handler = p_client->p_notification;
+        break;
+
+    case GATTC_OPTYPE_INDICATION:
+        p_handler = p_client->p_indication;
+        break;
+
+    default:
+        p_handler = p_client->p_read_rsp;
+        break;
+    }
+
+    if ( p_handler == NULL )
+        return WICED_FALSE;
+
+    p_handler( p_data );
+    return WICED_TRUE;
+}
@@ -0,0 +1,97 @@
+/******************************************************************************
+ * (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+ *******************************************************************************
+ * This software, including source code, documentation and related materials
+ * ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software ("EULA").
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress's integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ ******************************************************************************/
+/******************************************************************************
+ * File Name:   app_bt_gatt_dispatch.h
+ *
+ * Description: Dispatch of the GATT client events to the profile clients of
+ *              the application. Each client registers its handlers and claims
+ *              the handle ranges of its service on a connection. The ranges
+ *              are kept sorted so the owner of an event is found with a binary
+ *              search, whatever the number of clients. Events without an owner
+ *              go to the default client. The registry is used from the
+ *              Bluetooth stack callback thread only.
+ *
+ * Related Document: See Readme.md
+ *
+ ******************************************************************************/
+
+#ifndef __APP_BT_GATT_DISPATCH_H__
+#define __APP_BT_GATT_DISPATCH_H__
+
+/******************************************************************************
+ *                                INCLUDES
+ *****************************************************************************/
+#include <stdint.h>
+#include "wiced_bt_gatt.h"
+
+/******************************************************************************
+ *                                MACROS
+ *****************************************************************************/
+/* Number of profile clients that can register */
+#ifndef APP_BT_GATT_DISPATCH_MAX_CLIENTS
+#define APP_BT_GATT_DISPATCH_MAX_CLIENTS    4
+#endif
+
+/* Number of handle ranges claimed over all clients and connections */
+#ifndef APP_BT_GATT_DISPATCH_MAX_RANGES
+#define APP_BT_GATT_DISPATCH_MAX_RANGES     16
+#endif
+
+/* Returned by app_bt_gatt_dispatch_register when the registry is full */
+#define APP_BT_GATT_DISPATCH_NO_CLIENT      0xFF
+
+/******************************************************************************
+ *                    STRUCTURES AND ENUMERATIONS
+ *****************************************************************************/
+typedef void (app_bt_gatt_dispatch_handler_t)( wiced_bt_gatt_operation_complete_t *p_data );
+
+/* Handlers of a profile client, NULL for the events it does not take */
+typedef struct
+{
+    app_bt_gatt_dispatch_handler_t *p_read_rsp;     /* read by handle, by type or multiple */
+    app_bt_gatt_dispatch_handler_t *p_write_rsp;    /* write with or without response */
+    app_bt_gatt_dispatch_handler_t *p_notification;
+    app_bt_gatt_dispatch_handler_t *p_indication;   /* confirmed by the handler */
+} app_bt_gatt_dispatch_client_t;
+
+/****************************************************************************
+ *                              FUNCTION DECLARATIONS
+ ***************************************************************************/
+uint8_t app_bt_gatt_dispatch_register( const app_bt_gatt_dispatch_client_t *p_client );
+void app_bt_gatt_dispatch_set_default( uint8_t client_id );
+wiced_bool_t app_bt_gatt_dispatch_claim( uint8_t client_id, uint16_t conn_id,
+                                         uint16_t s_handle, uint16_t e_handle );
+void app_bt_gatt_dispatch_release( uint8_t client_id, uint16_t conn_id );
+uint8_t app_bt_gatt_dispatch_owner( uint16_t conn_id, uint16_t handle );
+wiced_bool_t app_bt_gatt_dispatch_operation_complete( wiced_bt_gatt_operation_complete_t *p_data );
+
+#endif /*__APP_BT_GATT_DISPATCH_H__ */
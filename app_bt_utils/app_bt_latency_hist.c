@@ -0,0 +1,269 @@
+/******************************************************************************
+ * (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+ *******************************************************************************
+ * This software, including source code, documentation and related materials
+ * ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software ("EULA").
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress's integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ ******************************************************************************/
+/******************************************************************************
+ * File Name:   app_bt_latency_hist.c
+ *
+ * Description: HDR style latency histogram. A value v below 2^(B+1), with B
+ *              the sub bucket bits, has its own bucket. Above, with e the
+ *              index of the highest bit of v and s = e - B, the bucket is
+ *              s * 2^B + (v >> s): the B bits under the highest one select one
+ *              of 2^B buckets of width 2^s.
+ *
+ * Related Document: See Readme.md
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *                                INCLUDES
+ *****************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "app_bt_latency_hist.h"
+
+/******************************************************************************
+ *                                MACROS
+ *****************************************************************************/
+#define SUB_BUCKET_BITS     APP_BT_LATENCY_HIST_SUB_BUCKET_BITS
+#define LINEAR_LIMIT        ( 1ULL << ( SUB_BUCKET_BITS + 1 ) )
+#define MAX_VALUE_NS        ( ( 1ULL << ( APP_BT_LATENCY_HIST_MAX_MAGNITUDE + 1 ) ) - 1 )
+
+/****************************************************************************
+ *                                FUNCTION DEFINITIONS
+ ***************************************************************************/
+/******************************************************************************
+ * Function Name: app_bt_latency_hist_index()
+ *******************************************************************************
+ * Summary:
+ *   Bucket of a value
+ *
+ * Parameters:
+ *   uint64_t value_ns                   : value, at most MAX_VALUE_NS
+ *
+ * Return:
+ *  uint32_t                             : bucket index
+ *
+ ******************************************************************************/
+static uint32_t app_bt_latency_hist_index( uint64_t value_ns )
+{
+    uint32_t shift;
+
+    if ( value_ns < LINEAR_LIMIT )
+    {
+        return (uint32_t)value_ns;
+    }
+    shift = 63 - __builtin_clzll( value_ns ) - SUB_BUCKET_BITS;
+    return ( shift << SUB_BUCKET_BITS ) + (uint32_t)( value_ns >> shift );
+}
+
+/******************************************************************************
+ * Function Name: app_bt_latency_hist_highest()
+ *******************************************************************************
+ * Summary:
+ *   Highest value counted in a bucket
+ *
+ * Parameters:
+ *   uint32_t index                      : bucket index
+ *
+ * Return:
+ *  uint64_t                             : value in ns
+ *
+ ******************************************************************************/
+static uint64_t app_bt_latency_hist_highest( uint32_t index )
+{
+    uint32_t shift;
+
+    if ( index < LINEAR_LIMIT )
+    {
+        return index;
+    }
+    shift = ( index >> SUB_BUCKET_BITS ) - 1;
+    return ( ( (uint64_t)( index - ( shift << SUB_BUCKET_BITS ) ) + 1 ) << shift ) - 1;
+}
+
+/******************************************************************************
+ * Function Name: app_bt_latency_now_ns()
+ *******************************************************************************
+ * Summary:
+ *   Monotonic clock in nanoseconds
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *  uint64_t                             : CLOCK_MONOTONIC in ns
+ *
+ ******************************************************************************/
+uint64_t app_bt_latency_now_ns( void )
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/******************************************************************************
+ * Function Name: app_bt_latency_hist_reset()
+ *******************************************************************************
+ * Summary:
+ *   Empty a histogram. Only the writer may reset it.
+ *
+ * Parameters:
+ *   app_bt_latency_hist_t *p_hist       : histogram
+ *
+ * Return:
+ *  None
+ *
+ ******************************************************************************/
+void app_bt_latency_hist_reset( app_bt_latency_hist_t *p_hist )
+{
+    memset( p_hist, 0, sizeof( *p_hist ) );
+    p_hist->min_ns = UINT64_MAX;
+}
+
+/******************************************************************************
+ * Function Name: app_bt_latency_hist_record()
+ *******************************************************************************
+ * Summary:
+ *   Count one value, values above the range are counted in the last bucket
+ *
+ * Parameters:
+ *   app_bt_latency_hist_t *p_hist       : histogram
+ *   uint64_t value_ns                   : value in ns
+ *
+ * Return:
+ *  None
+ *
+ ******************************************************************************/
+void app_bt_latency_hist_record( app_bt_latency_hist_t *p_hist, uint64_t value_ns )
+{
+    uint32_t index;
+
+    if ( value_ns > MAX_VALUE_NS )
+    {
+        value_ns = MAX_VALUE_NS;
+    }
+    index = app_bt_latency_hist_index( value_ns );
+
+    /* single writer: plain read, relaxed store so readers never see a torn value */
+    __atomic_store_n( &p_hist->buckets[index], p_hist->buckets[index] + 1, __ATOMIC_RELAXED );
+    __atomic_store_n( &p_hist->sum_ns, p_hist->sum_ns + value_ns, __ATOMIC_RELAXED );
+    if ( ( p_hist->count == 0 ) || ( value_ns < p_hist->min_ns ) )
+    {
+        __atomic_store_n( &p_hist->min_ns, value_ns, __ATOMIC_RELAXED );
+    }
+    if ( value_ns > p_hist->max_ns )
+    {
+        __atomic_store_n( &p_hist->max_ns, value_ns, __ATOMIC_RELAXED );
+    }
+    __atomic_store_n( &p_hist->count, p_hist->count + 1, __ATOMIC_RELEASE );
+}
+
+/******************************************************************************
+ * Function Name: app_bt_latency_hist_percentile()
+ *******************************************************************************
+ * Summary:
+ *   Value under which a given share of the recorded values fall, reported as
+ *   the highest value of its bucket and capped to the largest value recorded
+ *
+ * Parameters:
+ *   const app_bt_latency_hist_t *p_hist : histogram
+ *   double percentile                   : 0 to 100, e.g. 99.9
+ *
+ * Return:
+ *  uint64_t                             : value in ns, 0 if nothing recorded
+ *
+ ******************************************************************************/
+uint64_t app_bt_latency_hist_percentile( const app_bt_latency_hist_t *p_hist, double percentile )
+{
+    uint64_t count = __atomic_load_n( &p_hist->count, __ATOMIC_ACQUIRE );
+    uint64_t max_ns = __atomic_load_n( &p_hist->max_ns, __ATOMIC_RELAXED );
+    uint64_t target, seen = 0;
+    uint32_t index;
+
+    if ( count == 0 )
+    {
+        return 0;
+    }
+    if ( percentile > 100.0 )
+    {
+        percentile = 100.0;
+    }
+    target = (uint64_t)( percentile * count / 100.0 + 0.5 );
+    if ( target == 0 )
+    {
+        target = 1;
+    }
+
+    for ( index = 0; index < APP_BT_LATENCY_HIST_NUM_BUCKETS; index++ )
+    {
+        seen += __atomic_load_n( &p_hist->buckets[index], __ATOMIC_RELAXED );
+        if ( seen >= target )
+        {
+            return ( app_bt_latency_hist_highest( index ) < max_ns ) ?
+                   app_bt_latency_hist_highest( index ) : max_ns;
+        }
+    }
+    return max_ns;
+}
+
+/******************************************************************************
+ * Function Name: app_bt_latency_hist_print()
+ *******************************************************************************
+ * Summary:
+ *   Print count, min, mean, p50, p99, p99.9 and max of a histogram in one line
+ *
+ * Parameters:
+ *   const app_bt_latency_hist_t *p_hist : histogram
+ *   const char *p_name                  : label of the line
+ *
+ * Return:
+ *  None
+ *
+ ******************************************************************************/
+void app_bt_latency_hist_print( const app_bt_latency_hist_t *p_hist, const char *p_name )
+{
+    uint64_t count = __atomic_load_n( &p_hist->count, __ATOMIC_ACQUIRE );
+
+    if ( count == 0 )
+    {
+        return;
+    }
+    printf( "%-48s n:%-8llu min:%-8llu mean:%-8llu p50:%-8llu p99:%-8llu p99.9:%-8llu max:%llu ns\n",
+            p_name, (unsigned long long)count,
+            (unsigned long long)p_hist->min_ns,
+            (unsigned long long)( p_hist->sum_ns / count ),
+            (unsigned long long)app_bt_latency_hist_percentile( p_hist, 50.0 ),
+            (unsigned long long)app_bt_latency_hist_percentile( p_hist, 99.0 ),
+            (unsigned long long)app_bt_latency_hist_percentile( p_hist, 99.9 ),
+            (unsigned long long)p_hist->max_ns );
+}
@@ -0,0 +1,84 @@
+/******************************************************************************
+ * (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+ *******************************************************************************
+ * This software, including source code, documentation and related materials
+ * ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software ("EULA").
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress's integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ ******************************************************************************/
+/******************************************************************************
+ * File Name:   app_bt_latency_hist.h
+ *
+ * Description: HDR style latency histogram. Values in nanoseconds are counted
+ *              in log-linear buckets: exact below 64 ns, then 32 buckets per
+ *              power of 2, so any percentile is within 1/32 of the true value
+ *              up to 2^41 ns, about 36 minutes. Recording is a few instructions and
+ *              never allocates. A histogram has a single writer, it can be
+ *              read from any thread at any time.
+ *
+ * Related Document: See Readme.md
+ *
+ ******************************************************************************/
+
+#ifndef __APP_BT_LATENCY_HIST_H__
+#define __APP_BT_LATENCY_HIST_H__
+
+/******************************************************************************
+ *                                INCLUDES
+ *****************************************************************************/
+#include <stdint.h>
+
+/******************************************************************************
+ *                                MACROS
+ *****************************************************************************/
+#define APP_BT_LATENCY_HIST_SUB_BUCKET_BITS  5
+#define APP_BT_LATENCY_HIST_MAX_MAGNITUDE    40     /* highest bit of the largest value */
+#define APP_BT_LATENCY_HIST_NUM_BUCKETS      \
+    ( ( APP_BT_LATENCY_HIST_MAX_MAGNITUDE - APP_BT_LATENCY_HIST_SUB_BUCKET_BITS + 2 ) << \
+      APP_BT_LATENCY_HIST_SUB_BUCKET_BITS )
+
+/******************************************************************************
+ *                    STRUCTURES AND ENUMERATIONS
+ *****************************************************************************/
+typedef struct
+{
+    uint64_t count;
+    uint64_t sum_ns;
+    uint64_t min_ns;
+    uint64_t max_ns;
+    uint32_t buckets[APP_BT_LATENCY_HIST_NUM_BUCKETS];
+} app_bt_latency_hist_t;
+
+/****************************************************************************
+ *                              FUNCTION DECLARATIONS
+ ***************************************************************************/
+uint64_t app_bt_latency_now_ns( void );
+void app_bt_latency_hist_reset( app_bt_latency_hist_t *p_hist );
+void app_bt_latency_hist_record( app_bt_latency_hist_t *p_hist, uint64_t value_ns );
+uint64_t app_bt_latency_hist_percentile( const app_bt_latency_hist_t *p_hist, double percentile );
+void app_bt_latency_hist_print( const app_bt_latency_hist_t *p_hist, const char *p_name );
+
+#endif /*__APP_BT_LATENCY_HIST_H__ */
@@ -50,6 +50,7 @@
 #include "platform_linux.h"
 #include "COMPONENT_anc/wiced_bt_anp.h"
 #include "COMPONENT_anc/wiced_bt_anc.h"
+#include "app_bt_utils/app_bt_latency_hist.h"
 
 /*******************************************************************************
 *                                   MACROS
@@ -74,6 +75,8 @@ typedef enum
      USR_ANC_COMMAND_ENABLE_NTF_UNREAD_ALERT_STATUS,
      USR_ANC_COMMAND_DISABLE_NTF_NEW_ALERTS,
      USR_ANC_COMMAND_DISABLE_NTF_UNREAD_ALERT_STATUS,
+     /* 9 prints the ANC event latency */
+     USR_ANC_COMMAND_READ_SERVER_SUPPORTED_CATEGORIES = 10,
 }bt_app_anc_cmd;
 
 /******************************************************************************
@@ -87,4 +90,11 @@ extern uint8_t anc_bd_address[];
 void application_start( void );
 void bt_app_anc_start_advertisement();
 wiced_bt_gatt_status_t bt_app_handle_usr_cmd(uint8_t cmd, uint8_t cmd_id, uint8_t alert_categ);
+void bt_app_anc_set_service_discovery_by_uuid(wiced_bool_t by_uuid);
+void bt_app_anc_set_subscribe_during_discovery(wiced_bool_t enable);
+void bt_app_anc_set_read_categories_before_discovery(wiced_bool_t enable);
+void bt_app_anc_get_event_stats(uint32_t *p_consumed, uint32_t *p_dropped);
+const app_bt_latency_hist_t *bt_app_anc_get_dispatch_latency(wiced_bt_anc_event_t event);
+const app_bt_latency_hist_t *bt_app_anc_get_callback_time(wiced_bt_anc_event_t event);
+void bt_app_anc_print_latency(void);
 #endif /* _BT_APP_ANC_H_ */
@@ -0,0 +1,333 @@
+/******************************************************************************
+ * (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software ("EULA").
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress's integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ ******************************************************************************/
+/******************************************************************************
+ * File Name: anc_bench.c
+ *
+ * Description: Entry file of the anc_bench target. Plays a remote Alert
+ *              Notification server on the mock stack and sends a storm of New
+ *              Alert and Unread Alert Status notifications to the client, then
+ *              reports the throughput and the CPU cost per notification of the
+ *              stack thread (GATT callback, ANC library, bt_app_anc_callback)
+ *              and of the whole process (with the event consumer thread).
+ *
+ * Usage: anc_bench [-n notifications] [-r rate per second, 0 for no pacing]
+ *                  [-c category mask] [-u percent of unread alert status]
+ *                  [-t alert text length] [-a ANS start handle]
+ *                  [-s number of services in front of the ANS]
+ *                  [-f search all primary services instead of the ANS UUID]
+ *
+ ******************************************************************************/
+/******************************************************************************
+ *                               INCLUDES
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "wiced_memory.h"
+#include "wiced_bt_cfg.h"
+#include "wiced_bt_stack.h"
+#include "wiced_bt_uuid.h"
+#include "bt_app_anc.h"
+#include "mock_btstack.h"
+
+/******************************************************************************
+ *                               MACROS
+ ******************************************************************************/
+#define BENCH_DEFAULT_NOTIFICATIONS (100000U)
+#define BENCH_DEFAULT_TEXT_LEN      (18U)
+#define BENCH_NUM_CATEGORIES        (10U)
+#define BENCH_NS_PER_S              (1000000000ULL)
+/* Longest wait for the event consumer thread to catch up at the end */
+#define BENCH_DRAIN_TIMEOUT_NS      (2 * BENCH_NS_PER_S)
+/* Time given to the consumer thread to print the connection events */
+#define BENCH_SETTLE_US             (100000U)
+/* Largest alert text in one notification, server MTU of 247 */
+#define BENCH_MAX_TEXT_LEN          (247U - 3U - 2U)
+
+/******************************************************************************
+ *                           GLOBAL VARIABLES
+ ******************************************************************************/
+wiced_bt_heap_t *p_default_heap = NULL;
+uint8_t anc_bd_address[LOCAL_BDA_LEN] = {0x11, 0x12, 0x13, 0x51, 0x52, 0x53};
+const wiced_bt_cfg_settings_t wiced_bt_cfg_settings =
+{
+    .device_name = (uint8_t *)"ANC bench",
+};
+
+static const wiced_bt_device_address_t bench_peer_addr = {0x20, 0x21, 0x22, 0x61, 0x62, 0x63};
+
+/******************************************************************************
+ *                       FUNCTION DEFINITIONS
+ ******************************************************************************/
+
+/*******************************************************************************
+ * Function Name: bench_now_ns()
+ ********************************************************************************
+ * Summary:
+ *   Reads a clock in nanoseconds
+ *
+ * Parameters:
+ *   clockid_t clock     : CLOCK_MONOTONIC or a CPU time clock
+ *
+ * Return:
+ *   uint64_t            : time in nanoseconds
+ *
+ *******************************************************************************/
+static uint64_t bench_now_ns(clockid_t clock)
+{
+    struct timespec ts;
+
+    clock_gettime(clock, &ts);
+    return (uint64_t)ts.tv_sec * BENCH_NS_PER_S + (uint64_t)ts.tv_nsec;
+}
+
+/*******************************************************************************
+ * Function Name: bench_pace()
+ ********************************************************************************
+ * Summary:
+ *   Sleeps until the wall clock reaches a deadline
+ *
+ * Parameters:
+ *   uint64_t deadline_ns : CLOCK_MONOTONIC deadline in nanoseconds
+ *
+ * Return:
+ *   None
+ *
+ *******************************************************************************/
+static void bench_pace(uint64_t deadline_ns)
+{
+    struct timespec ts;
+
+    if (bench_now_ns(CLOCK_MONOTONIC) >= deadline_ns)
+    {
+        return;
+    }
+    ts.tv_sec = deadline_ns / BENCH_NS_PER_S;
+    ts.tv_nsec = deadline_ns % BENCH_NS_PER_S;
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) != 0)
+    {
+    }
+}
+
+/*******************************************************************************
+ * Function Name: bench_connect()
+ ********************************************************************************
+ * Summary:
+ *   Connects the remote server, lets the client discover it and enables both
+ *   notifications and all alert categories, New Alerts during the discovery
+ *
+ * Parameters:
+ *   None
+ *
+ * Return:
+ *   uint16_t            : connection id
+ *
+ *******************************************************************************/
+static uint16_t bench_connect(void)
+{
+    uint16_t conn_id;
+
+    application_start();
+    mock_btstack_run();
+
+    /* New Alerts are enabled as soon as discovery finds their CCCD */
+    bt_app_anc_set_subscribe_during_discovery(WICED_TRUE);
+    conn_id = mock_btstack_connect(bench_peer_addr);
+    mock_btstack_run();
+
+    bt_app_handle_usr_cmd(USR_ANC_COMMAND_ENABLE_NTF_UNREAD_ALERT_STATUS, 0, 0);
+    mock_btstack_run();
+    bt_app_handle_usr_cmd(USR_ANC_COMMAND_CONTROL_ALERTS, ANP_ALERT_CONTROL_CMD_ENABLE_NEW_ALERTS,
+                          ANP_ALERT_CATEGORY_ID_ALL_CONFIGURED);
+    mock_btstack_run();
+    bt_app_handle_usr_cmd(USR_ANC_COMMAND_CONTROL_ALERTS, ANP_ALERT_CONTROL_CMD_ENABLE_UNREAD_STATUS,
+                          ANP_ALERT_CATEGORY_ID_ALL_CONFIGURED);
+    mock_btstack_run();
+
+    return conn_id;
+}
+
+/*******************************************************************************
+ * Function Name: main()
+ ********************************************************************************
+ * Summary:
+ *   Application entry function
+ *
+ * Parameters:
+ *   int argc            : argument count
+ *   char *argv[]        : list of arguments
+ *
+ * Return:
+ *   None
+ *
+ *******************************************************************************/
+int main(int argc, char *argv[])
+{
+    unsigned long num_notifications = BENCH_DEFAULT_NOTIFICATIONS;
+    unsigned long rate = 0;
+    unsigned long category_mask = (1U << BENCH_NUM_CATEGORIES) - 1;
+    unsigned long unread_percent = 50;
+    unsigned long text_len = BENCH_DEFAULT_TEXT_LEN;
+    unsigned long ans_handle = MOCK_BTSTACK_ANS_SERVICE_HANDLE;
+    unsigned long num_other_services = 0;
+    uint8_t categories[BENCH_NUM_CATEGORIES];
+    uint8_t num_categories = 0;
+    uint8_t alert[2 + BENCH_MAX_TEXT_LEN];
+    uint16_t new_alert_handle;
+    uint16_t unread_alert_handle;
+    uint16_t conn_id;
+    unsigned long num_new = 0;
+    unsigned long num_unread = 0;
+    unsigned long i;
+    uint64_t start_wall, start_thread, start_process;
+    uint64_t wall_ns, thread_ns, process_ns, deadline;
+    uint64_t pace_start, pace_ns = 0;
+    uint32_t consumed_base, dropped_base, consumed, dropped;
+    wiced_bt_anc_setup_stats_t setup_stats;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:r:c:u:t:a:s:fk")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n': num_notifications = strtoul(optarg, NULL, 0); break;
+        case 'r': rate = strtoul(optarg, NULL, 0); break;
+        case 'c': category_mask = strtoul(optarg, NULL, 0); break;
+        case 'u': unread_percent = strtoul(optarg, NULL, 0); break;
+        case 't': text_len = strtoul(optarg, NULL, 0); break;
+        case 'a': ans_handle = strtoul(optarg, NULL, 0); break;
+        case 's': num_other_services = strtoul(optarg, NULL, 0); break;
+        case 'f': bt_app_anc_set_service_discovery_by_uuid(WICED_FALSE); break;
+        case 'k': bt_app_anc_set_read_categories_before_discovery(WICED_TRUE); break;
+        default:
+            fprintf(stderr, "Usage: %s [-n notifications] [-r rate] [-c category mask] [-u unread percent]"
+                    " [-t text length] [-a ANS handle] [-s other services] [-f] [-k]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    for (i = 0; i < BENCH_NUM_CATEGORIES; i++)
+    {
+        if (category_mask & (1U << i))
+        {
+            categories[num_categories++] = (uint8_t)i;
+        }
+    }
+    if ((num_categories == 0) || (unread_percent > 100) || (num_notifications == 0))
+    {
+        fprintf(stderr, "Bad category mask, unread percent or number of notifications\n");
+        return EXIT_FAILURE;
+    }
+    if (text_len > BENCH_MAX_TEXT_LEN)
+    {
+        text_len = BENCH_MAX_TEXT_LEN;
+    }
+    memset(&alert[2], 'a', text_len);
+
+    mock_btstack_set_layout((uint16_t)ans_handle, (uint16_t)num_other_services);
+    conn_id = bench_connect();
+    new_alert_handle = mock_btstack_find_value_handle(UUID_CHARACTERISTIC_NEW_ALERT);
+    unread_alert_handle = mock_btstack_find_value_handle(UUID_CHARACTERISTIC_UNREAD_ALERT_STATUS);
+    usleep(BENCH_SETTLE_US);
+    bt_app_anc_get_event_stats(&consumed_base, &dropped_base);
+
+    start_wall = bench_now_ns(CLOCK_MONOTONIC);
+    start_thread = bench_now_ns(CLOCK_THREAD_CPUTIME_ID);
+    start_process = bench_now_ns(CLOCK_PROCESS_CPUTIME_ID);
+
+    for (i = 0; i < num_notifications; i++)
+    {
+        if (rate != 0)
+        {
+            /* the time spent pacing is not part of the cost of a notification */
+            pace_start = bench_now_ns(CLOCK_THREAD_CPUTIME_ID);
+            bench_pace(start_wall + i * BENCH_NS_PER_S / rate);
+            pace_ns += bench_now_ns(CLOCK_THREAD_CPUTIME_ID) - pace_start;
+        }
+
+        alert[0] = categories[i % num_categories];
+        alert[1] = 1;
+        /* spread the unread status evenly over the storm */
+        if ((i * unread_percent) % 100 + unread_percent >= 100)
+        {
+            mock_btstack_notify(conn_id, unread_alert_handle, alert, 2);
+            num_unread++;
+        }
+        else
+        {
+            mock_btstack_notify(conn_id, new_alert_handle, alert, (uint16_t)(2 + text_len));
+            num_new++;
+        }
+        mock_btstack_run();
+    }
+
+    thread_ns = bench_now_ns(CLOCK_THREAD_CPUTIME_ID) - start_thread - pace_ns;
+    wall_ns = bench_now_ns(CLOCK_MONOTONIC) - start_wall;
+
+    /* wait for the consumer thread to handle or drop every event */
+    deadline = bench_now_ns(CLOCK_MONOTONIC) + BENCH_DRAIN_TIMEOUT_NS;
+    do
+    {
+        bt_app_anc_get_event_stats(&consumed, &dropped);
+        consumed -= consumed_base;
+        dropped -= dropped_base;
+    } while ((consumed + dropped < num_notifications) && (bench_now_ns(CLOCK_MONOTONIC) < deadline) &&
+             (usleep(100) == 0));
+    process_ns = bench_now_ns(CLOCK_PROCESS_CPUTIME_ID) - start_process - pace_ns;
+
+    fprintf(stdout, "Notifications: %lu (new alert %lu, unread alert status %lu)\n",
+            num_notifications, num_new, num_unread);
+    fprintf(stdout, "Categories: %u, alert text: %lu bytes, ANS at 0x%04x after %lu services\n",
+            num_categories, text_len, (unsigned int)ans_handle, num_other_services);
+    if (wiced_bt_anc_client_get_setup_stats(conn_id, &setup_stats))
+    {
+        fprintf(stdout, "Service search: %u us, %u requests, subscribed after %u us\n",
+                setup_stats.duration_us[WICED_BT_ANC_PHASE_SERVICE_SEARCH],
+                setup_stats.num_requests[WICED_BT_ANC_PHASE_SERVICE_SEARCH], setup_stats.time_to_subscribed_us);
+    }
+    fprintf(stdout, "Rate: requested %lu/s, sustained %.0f/s over %.3f s\n",
+            rate, num_notifications * (double)BENCH_NS_PER_S / wall_ns, wall_ns / (double)BENCH_NS_PER_S);
+    fprintf(stdout, "Stack thread CPU: %.1f ns per notification\n", thread_ns / (double)num_notifications);
+    fprintf(stdout, "Process CPU: %.1f ns per notification\n", process_ns / (double)num_notifications);
+    fprintf(stdout, "Consumer: %u events handled, %u dropped\n", consumed, dropped);
+    bt_app_anc_print_latency();
+
+    mock_btstack_disconnect(conn_id);
+    mock_btstack_run();
+    wiced_bt_delete_heap(p_default_heap);
+    wiced_bt_stack_deinit();
+
+    return EXIT_SUCCESS;
+}
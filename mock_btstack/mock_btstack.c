@@ -0,0 +1,1277 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * In-process stand-in for the AIROC BTSTACK, see mock_btstack.h.
+ *
+ * Every ATT request costs MOCK_BTSTACK_ROUND_TRIP_US of virtual time per PDU
+ * exchanged, with PDUs sized from the negotiated MTU, so request counts and
+ * elapsed virtual time follow what a real link would need.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "wiced_bt_types.h"
+#include "wiced_bt_dev.h"
+#include "wiced_bt_ble.h"
+#include "wiced_bt_gatt.h"
+#include "wiced_bt_stack.h"
+#include "wiced_bt_uuid.h"
+#include "wiced_memory.h"
+#include "wiced_timer.h"
+#include "wiced_hal_nvram.h"
+#include "mock_btstack.h"
+
+/* One ATT request / response exchange, two connection events at 7.5 ms */
+#ifndef MOCK_BTSTACK_ROUND_TRIP_US
+#define MOCK_BTSTACK_ROUND_TRIP_US          15000
+#endif
+
+#define MOCK_BTSTACK_MAX_ATTRS              256
+#define MOCK_BTSTACK_MAX_OTHER_SERVICES     64
+#define MOCK_BTSTACK_MAX_VALUE              64
+#define MOCK_BTSTACK_MAX_CONNS              4
+#define MOCK_BTSTACK_MAX_NVRAM              16
+#define MOCK_BTSTACK_MAX_MTU                517
+
+/* ANS command not supported, Alert Notification Service application error */
+#define MOCK_BTSTACK_ANS_CMD_NOT_SUPPORTED  0xA0
+
+/* Characteristic properties */
+#define MOCK_PROP_READ                      0x02
+#define MOCK_PROP_WRITE                     0x08
+#define MOCK_PROP_NOTIFY                    0x10
+#define MOCK_PROP_INDICATE                  0x20
+
+typedef struct
+{
+    uint16_t handle;
+    uint16_t type;                          /* 16 bit attribute type */
+    uint16_t len;
+    uint8_t  value[MOCK_BTSTACK_MAX_VALUE];
+} mock_attr_t;
+
+typedef struct
+{
+    uint16_t                  conn_id;      /* 0 for a free entry */
+    wiced_bt_device_address_t bd_addr;
+    uint16_t                  mtu;
+    wiced_bool_t              busy;         /* an ATT request is pending */
+    wiced_bool_t              encrypted;
+    uint64_t                  next_response_delay_us;   /* added to the response of the next request */
+    uint64_t                  response_delay_us;        /* added to the response of the pending request */
+    uint16_t                  cccd[MOCK_BTSTACK_MAX_ATTRS];
+} mock_conn_t;
+
+enum
+{
+    MOCK_EVENT_GATT,
+    MOCK_EVENT_MGMT,
+};
+
+typedef struct mock_event_s
+{
+    struct mock_event_s         *p_next;
+    uint64_t                    due_us;
+    uint8_t                     kind;
+    uint16_t                    conn_id;
+    wiced_bool_t                completes_request;
+    wiced_bt_gatt_evt_t         gatt_event;
+    wiced_bt_management_evt_t   mgmt_event;
+    union
+    {
+        wiced_bt_gatt_event_data_t      gatt;
+        wiced_bt_management_evt_data_t  mgmt;
+    } data;
+    wiced_bt_device_address_t   bd_addr;    /* storage for the bd_addr pointers of data */
+    uint8_t                     *p_read_buf;
+    uint16_t                    read_buf_len;
+    uint16_t                    value_len;
+    uint8_t                     value[MOCK_BTSTACK_MAX_MTU];
+} mock_event_t;
+
+typedef struct
+{
+    uint16_t id;
+    uint16_t len;
+    uint8_t  data[512];
+} mock_nvram_t;
+
+static wiced_bt_management_cback_t *p_mock_mgmt_cback;
+static wiced_bt_gatt_cback_t       *p_mock_gatt_cback;
+static mock_attr_t                 mock_db[MOCK_BTSTACK_MAX_ATTRS];
+static uint16_t                    mock_db_size;
+static mock_conn_t                 mock_conns[MOCK_BTSTACK_MAX_CONNS];
+static mock_event_t                *p_mock_events;
+static wiced_timer_t               *p_mock_timers;
+static uint64_t                    mock_now_us;
+static uint16_t                    mock_server_mtu = 247;
+static uint16_t                    mock_ans_handle = MOCK_BTSTACK_ANS_SERVICE_HANDLE;
+static uint16_t                    mock_num_other_services;
+static wiced_bool_t                mock_require_encryption;
+static wiced_bool_t                mock_read_multiple_unsupported;
+static wiced_bt_device_address_t   mock_paired_addr;
+static wiced_bool_t                mock_paired;
+static mock_nvram_t                mock_nvram[MOCK_BTSTACK_MAX_NVRAM];
+static mock_btstack_stats_t        mock_stats;
+static struct wiced_bt_heap        { int unused; } mock_heap;
+
+/******************************************************
+ *               Remote GATT database
+ ******************************************************/
+static mock_attr_t *mock_db_add( uint16_t handle, uint16_t type, const uint8_t *p_value, uint16_t len )
+{
+    mock_attr_t *p_attr = &mock_db[mock_db_size++];
+
+    p_attr->handle = handle;
+    p_attr->type   = type;
+    p_attr->len    = len;
+    if ( len )
+        memcpy( p_attr->value, p_value, len );
+    return p_attr;
+}
+
+static void mock_db_add_service( uint16_t handle, uint16_t uuid )
+{
+    uint8_t value[2] = { uuid & 0xff, uuid >> 8 };
+
+    mock_db_add( handle, UUID_ATTRIBUTE_PRIMARY_SERVICE, value, sizeof(value) );
+}
+
+/* Declaration at handle, value at handle + 1 */
+static void mock_db_add_char( uint16_t handle, uint8_t properties, uint16_t uuid, const uint8_t *p_value, uint16_t len )
+{
+    uint8_t decl[5] = { properties, ( handle + 1 ) & 0xff, ( handle + 1 ) >> 8, uuid & 0xff, uuid >> 8 };
+
+    mock_db_add( handle, UUID_ATTRIBUTE_CHARACTERISTIC, decl, sizeof(decl) );
+    mock_db_add( handle + 1, uuid, p_value, len );
+}
+
+static void mock_db_add_cccd( uint16_t handle )
+{
+    mock_db_add( handle, UUID_DESCRIPTOR_CLIENT_CHARACTERISTIC_CONFIGURATION, NULL, 0 );
+}
+
+/* Stand-in for the AES-CMAC of the specification: two FNV-1a over the handle and type
+ * of every attribute, and the value of the service and characteristic declarations */
+static void mock_db_hash( uint8_t *p_hash )
+{
+    uint64_t h[2] = { 0xcbf29ce484222325ULL, 0x84222325cbf29ce4ULL };
+    uint8_t  bytes[4 + MOCK_BTSTACK_MAX_VALUE];
+    uint16_t len;
+    int i, j, k;
+
+    for ( i = 0; i < mock_db_size; i++ )
+    {
+        bytes[0] = mock_db[i].handle & 0xff;
+        bytes[1] = mock_db[i].handle >> 8;
+        bytes[2] = mock_db[i].type & 0xff;
+        bytes[3] = mock_db[i].type >> 8;
+        len = 4;
+        if ( ( mock_db[i].type == UUID_ATTRIBUTE_PRIMARY_SERVICE ) || ( mock_db[i].type == UUID_ATTRIBUTE_CHARACTERISTIC ) )
+        {
+            memcpy( &bytes[4], mock_db[i].value, mock_db[i].len );
+            len += mock_db[i].len;
+        }
+        for ( k = 0; k < 2; k++ )
+            for ( j = 0; j < len; j++ )
+                h[k] = ( h[k] ^ bytes[j] ) * 0x100000001b3ULL;
+    }
+    for ( k = 0; k < 2; k++ )
+        for ( j = 0; j < 8; j++ )
+            p_hash[k * 8 + j] = (uint8_t)( h[k] >> ( 8 * j ) );
+}
+
+static void mock_db_build( void )
+{
+    static const uint8_t device_name[] = "ANS mock";
+    static const uint8_t service_changed[4] = { 0 };
+    static const uint8_t supported_categories[2] = { 0xff, 0x03 };
+    static const uint8_t no_alert[2] = { 0 };
+    uint8_t hash[16] = { 0 };
+    uint16_t handle, step, i, hash_index;
+
+    mock_db_size = 0;
+
+    mock_db_add_service( MOCK_BTSTACK_GAP_SERVICE_HANDLE, UUID_SERVICE_GENERIC_ACCESS );
+    mock_db_add_char( 0x0002, MOCK_PROP_READ, UUID_CHARACTERISTIC_DEVICE_NAME, device_name, sizeof(device_name) - 1 );
+
+    mock_db_add_service( MOCK_BTSTACK_GATT_SERVICE_HANDLE, UUID_SERVICE_GENERIC_ATTRIBUTE );
+    mock_db_add_char( MOCK_BTSTACK_SERVICE_CHANGED_VALUE_HANDLE - 1, MOCK_PROP_INDICATE, UUID_CHARACTERISTIC_SERVICE_CHANGED,
+                      service_changed, sizeof(service_changed) );
+    mock_db_add_cccd( MOCK_BTSTACK_SERVICE_CHANGED_VALUE_HANDLE + 1 );
+    hash_index = mock_db_size + 1;
+    mock_db_add_char( MOCK_BTSTACK_DATABASE_HASH_VALUE_HANDLE - 1, MOCK_PROP_READ, UUID_CHARACTERISTIC_DATABASE_HASH,
+                      hash, sizeof(hash) );
+
+    /* Device Information services spread between the GATT service and the ANS */
+    step = ( mock_num_other_services != 0 ) ?
+           ( mock_ans_handle - MOCK_BTSTACK_DATABASE_HASH_VALUE_HANDLE - 1 ) / mock_num_other_services : 0;
+    for ( i = 0; i < mock_num_other_services; i++ )
+    {
+        handle = MOCK_BTSTACK_DATABASE_HASH_VALUE_HANDLE + 1 + i * step;
+        mock_db_add_service( handle, UUID_SERVICE_DEVICE_INFORMATION );
+        mock_db_add_char( handle + 1, MOCK_PROP_READ, UUID_CHARACTERISTIC_MANUFACTURER_NAME_STRING,
+                          device_name, sizeof(device_name) - 1 );
+    }
+
+    handle = mock_ans_handle;
+    mock_db_add_service( handle, UUID_SERVICE_ALERT_NOTIFICATION );
+    mock_db_add_char( handle + 0x01, MOCK_PROP_READ, UUID_CHARACTERISTIC_SUPPORTED_NEW_ALERT_CATEGORY,
+                      supported_categories, sizeof(supported_categories) );
+    mock_db_add_char( handle + 0x03, MOCK_PROP_NOTIFY, UUID_CHARACTERISTIC_NEW_ALERT, no_alert, sizeof(no_alert) );
+    mock_db_add_cccd( handle + 0x05 );
+    mock_db_add_char( handle + 0x06, MOCK_PROP_READ, UUID_CHARACTERISTIC_SUPPORTED_UNREAD_ALERT_CATEGORY,
+                      supported_categories, sizeof(supported_categories) );
+    mock_db_add_char( handle + 0x08, MOCK_PROP_NOTIFY, UUID_CHARACTERISTIC_UNREAD_ALERT_STATUS, no_alert, sizeof(no_alert) );
+    mock_db_add_cccd( handle + 0x0a );
+    mock_db_add_char( handle + 0x0b, MOCK_PROP_WRITE, UUID_CHARACTERISTIC_ALERT_NOTIFICATION_CONTROL_POINT, NULL, 0 );
+
+    mock_db_hash( mock_db[hash_index].value );
+}
+
+static int mock_db_find( uint16_t handle )
+{
+    int i;
+
+    for ( i = 0; i < mock_db_size; i++ )
+        if ( mock_db[i].handle == handle )
+            return i;
+    return -1;
+}
+
+/* Last handle of the service declared at index */
+static uint16_t mock_db_service_end( int index )
+{
+    int i;
+
+    for ( i = index + 1; i < mock_db_size; i++ )
+        if ( mock_db[i].type == UUID_ATTRIBUTE_PRIMARY_SERVICE )
+            return mock_db[i - 1].handle;
+    return mock_db[mock_db_size - 1].handle;
+}
+
+/* Index of the CCCD of the characteristic whose value is at value_index, -1 if none */
+static int mock_db_find_cccd( int value_index )
+{
+    int i;
+
+    for ( i = value_index + 1; i < mock_db_size; i++ )
+    {
+        if ( ( mock_db[i].type == UUID_ATTRIBUTE_CHARACTERISTIC ) || ( mock_db[i].type == UUID_ATTRIBUTE_PRIMARY_SERVICE ) )
+            break;
+        if ( mock_db[i].type == UUID_DESCRIPTOR_CLIENT_CHARACTERISTIC_CONFIGURATION )
+            return i;
+    }
+    return -1;
+}
+
+/******************************************************
+ *               Event queue and virtual time
+ ******************************************************/
+static mock_conn_t *mock_find_conn( uint16_t conn_id )
+{
+    int i;
+
+    for ( i = 0; ( conn_id != 0 ) && ( i < MOCK_BTSTACK_MAX_CONNS ); i++ )
+        if ( mock_conns[i].conn_id == conn_id )
+            return &mock_conns[i];
+    return NULL;
+}
+
+static mock_event_t *mock_event_alloc( uint8_t kind, uint16_t conn_id, uint64_t delay_us )
+{
+    mock_event_t *p_event = calloc( 1, sizeof(mock_event_t) );
+
+    if ( p_event == NULL )
+    {
+        fprintf( stderr, "mock_btstack: out of memory\n" );
+        exit( EXIT_FAILURE );
+    }
+    p_event->kind    = kind;
+    p_event->conn_id = conn_id;
+    p_event->due_us  = mock_now_us + delay_us;
+    return p_event;
+}
+
+/* Events are kept in due time order, events due at the same time in posting order. Responses,
+ * the only GATT events not due at once, are held back as long as asked for their request */
+static void mock_event_post( mock_event_t *p_event )
+{
+    mock_event_t **pp = &p_mock_events;
+    mock_conn_t *p_conn = mock_find_conn( p_event->conn_id );
+
+    if ( ( p_event->kind == MOCK_EVENT_GATT ) && ( p_event->due_us > mock_now_us ) && ( p_conn != NULL ) )
+        p_event->due_us += p_conn->response_delay_us;
+
+    while ( ( *pp != NULL ) && ( ( *pp )->due_us <= p_event->due_us ) )
+        pp = &( *pp )->p_next;
+    p_event->p_next = *pp;
+    *pp = p_event;
+}
+
+static void mock_post_mgmt( wiced_bt_management_evt_t event, mock_event_t *p_event )
+{
+    p_event->mgmt_event = event;
+    mock_event_post( p_event );
+}
+
+static void mock_event_deliver( mock_event_t *p_event )
+{
+    mock_conn_t *p_conn = mock_find_conn( p_event->conn_id );
+    wiced_bt_gatt_data_t *p_att;
+
+    if ( p_event->kind == MOCK_EVENT_MGMT )
+    {
+        if ( p_mock_mgmt_cback != NULL )
+            p_mock_mgmt_cback( p_event->mgmt_event, &p_event->data.mgmt );
+        return;
+    }
+
+    if ( p_event->completes_request && ( p_conn != NULL ) )
+        p_conn->busy = WICED_FALSE;
+
+    /* read data lands in the application buffer when the response arrives */
+    if ( ( p_event->gatt_event == GATT_OPERATION_CPLT_EVT ) && ( p_event->p_read_buf != NULL ) )
+    {
+        p_att = &p_event->data.gatt.operation_complete.response_data.att_value;
+        if ( p_event->value_len > p_event->read_buf_len )
+            p_event->value_len = p_event->read_buf_len;
+        memcpy( p_event->p_read_buf, p_event->value, p_event->value_len );
+        p_att->p_data = p_event->p_read_buf;
+        p_att->len    = p_event->value_len;
+    }
+    else if ( p_event->gatt_event == GATT_OPERATION_CPLT_EVT )
+    {
+        p_event->data.gatt.operation_complete.response_data.att_value.p_data = p_event->value;
+    }
+
+    if ( p_mock_gatt_cback != NULL )
+        p_mock_gatt_cback( p_event->gatt_event, &p_event->data.gatt );
+}
+
+static wiced_timer_t *mock_next_timer( void )
+{
+    wiced_timer_t *p_timer, *p_next = NULL;
+
+    for ( p_timer = p_mock_timers; p_timer != NULL; p_timer = p_timer->p_next )
+        if ( ( p_next == NULL ) || ( p_timer->expiry_us < p_next->expiry_us ) )
+            p_next = p_timer;
+    return p_next;
+}
+
+static wiced_bool_t mock_one_shot_timer_pending( void )
+{
+    wiced_timer_t *p_timer;
+
+    for ( p_timer = p_mock_timers; p_timer != NULL; p_timer = p_timer->p_next )
+        if ( ( p_timer->type == WICED_SECONDS_TIMER ) || ( p_timer->type == WICED_MILLI_SECONDS_TIMER ) )
+            return WICED_TRUE;
+    return WICED_FALSE;
+}
+
+static uint64_t mock_timer_period_us( wiced_timer_t *p_timer )
+{
+    if ( ( p_timer->type == WICED_SECONDS_TIMER ) || ( p_timer->type == WICED_SECONDS_PERIODIC_TIMER ) )
+        return (uint64_t)p_timer->timeout * 1000000;
+    return (uint64_t)p_timer->timeout * 1000;
+}
+
+void mock_btstack_run( void )
+{
+    mock_event_t  *p_event;
+    wiced_timer_t *p_timer;
+
+    for ( ;; )
+    {
+        p_event = p_mock_events;
+        p_timer = mock_next_timer();
+
+        /* periodic timers alone do not keep the run going */
+        if ( ( p_event == NULL ) && !mock_one_shot_timer_pending() )
+            break;
+
+        if ( ( p_event != NULL ) && ( ( p_timer == NULL ) || ( p_event->due_us <= p_timer->expiry_us ) ) )
+        {
+            p_mock_events = p_event->p_next;
+            if ( p_event->due_us > mock_now_us )
+                mock_now_us = p_event->due_us;
+            mock_event_deliver( p_event );
+            free( p_event );
+        }
+        else
+        {
+            if ( p_timer->expiry_us > mock_now_us )
+                mock_now_us = p_timer->expiry_us;
+            wiced_stop_timer( p_timer );
+            if ( ( p_timer->type == WICED_SECONDS_PERIODIC_TIMER ) || ( p_timer->type == WICED_MILLI_SECONDS_PERIODIC_TIMER ) )
+                wiced_start_timer( p_timer, p_timer->timeout );
+            p_timer->cback( p_timer->cback_param );
+        }
+    }
+}
+
+uint64_t mock_btstack_now_us( void )
+{
+    return mock_now_us;
+}
+
+/******************************************************
+ *               Driver side
+ ******************************************************/
+uint16_t mock_btstack_connect( const wiced_bt_device_address_t bd_addr )
+{
+    mock_conn_t  *p_conn = NULL;
+    mock_event_t *p_event;
+    int i;
+
+    for ( i = 0; i < MOCK_BTSTACK_MAX_CONNS; i++ )
+    {
+        if ( mock_conns[i].conn_id == 0 )
+        {
+            p_conn = &mock_conns[i];
+            break;
+        }
+    }
+    if ( p_conn == NULL )
+        return 0;
+
+    memset( p_conn, 0, sizeof(*p_conn) );
+    p_conn->conn_id = i + 1;
+    p_conn->mtu     = GATT_DEF_BLE_MTU_SIZE;
+    memcpy( p_conn->bd_addr, bd_addr, BD_ADDR_LEN );
+
+    p_event = mock_event_alloc( MOCK_EVENT_GATT, p_conn->conn_id, 0 );
+    memcpy( p_event->bd_addr, bd_addr, BD_ADDR_LEN );
+    p_event->gatt_event = GATT_CONNECTION_STATUS_EVT;
+    p_event->data.gatt.connection_status.bd_addr   = p_event->bd_addr;
+    p_event->data.gatt.connection_status.addr_type = BLE_ADDR_PUBLIC;
+    p_event->data.gatt.connection_status.conn_id   = p_conn->conn_id;
+    p_event->data.gatt.connection_status.connected = WICED_TRUE;
+    p_event->data.gatt.connection_status.transport = BT_TRANSPORT_LE;
+    mock_event_post( p_event );
+
+    /* a bonded peer encrypts the link with the stored keys */
+    if ( mock_paired && ( memcmp( mock_paired_addr, bd_addr, BD_ADDR_LEN ) == 0 ) )
+    {
+        p_conn->encrypted = WICED_TRUE;
+        p_event = mock_event_alloc( MOCK_EVENT_MGMT, p_conn->conn_id, MOCK_BTSTACK_ROUND_TRIP_US );
+        memcpy( p_event->bd_addr, bd_addr, BD_ADDR_LEN );
+        p_event->data.mgmt.encryption_status.bd_addr = p_event->bd_addr;
+        p_event->data.mgmt.encryption_status.result  = WICED_BT_SUCCESS;
+        mock_post_mgmt( BTM_ENCRYPTION_STATUS_EVT, p_event );
+    }
+    return p_conn->conn_id;
+}
+
+static void mock_disconnect( mock_conn_t *p_conn, uint16_t conn_id, uint8_t reason )
+{
+    mock_event_t **pp = &p_mock_events;
+    mock_event_t *p_event;
+
+    /* responses still on the air are lost */
+    while ( *pp != NULL )
+    {
+        if ( ( *pp )->conn_id == conn_id )
+        {
+            p_event = *pp;
+            *pp = p_event->p_next;
+            free( p_event );
+        }
+        else
+        {
+            pp = &( *pp )->p_next;
+        }
+    }
+
+    p_event = mock_event_alloc( MOCK_EVENT_GATT, 0, 0 );
+    memcpy( p_event->bd_addr, p_conn->bd_addr, BD_ADDR_LEN );
+    p_event->gatt_event = GATT_CONNECTION_STATUS_EVT;
+    p_event->data.gatt.connection_status.bd_addr   = p_event->bd_addr;
+    p_event->data.gatt.connection_status.addr_type = BLE_ADDR_PUBLIC;
+    p_event->data.gatt.connection_status.conn_id   = conn_id;
+    p_event->data.gatt.connection_status.connected = WICED_FALSE;
+    p_event->data.gatt.connection_status.reason    = reason;
+    p_event->data.gatt.connection_status.transport = BT_TRANSPORT_LE;
+    mock_event_post( p_event );
+
+    memset( p_conn, 0, sizeof(*p_conn) );
+}
+
+void mock_btstack_disconnect( uint16_t conn_id )
+{
+    mock_conn_t *p_conn = mock_find_conn( conn_id );
+
+    if ( p_conn != NULL )
+        mock_disconnect( p_conn, conn_id, GATT_CONN_TERMINATE_PEER_USER );
+}
+
+wiced_bool_t mock_btstack_notify( uint16_t conn_id, uint16_t handle, const uint8_t *p_data, uint16_t len )
+{
+    mock_conn_t  *p_conn = mock_find_conn( conn_id );
+    mock_event_t *p_event;
+    int index = mock_db_find( handle );
+    int cccd;
+
+    if ( ( p_conn == NULL ) || ( index < 0 ) )
+        return WICED_FALSE;
+
+    cccd = mock_db_find_cccd( index );
+    if ( ( cccd < 0 ) || ( ( p_conn->cccd[cccd] & ( GATT_CLIENT_CONFIG_NOTIFICATION | GATT_CLIENT_CONFIG_INDICATION ) ) == 0 ) )
+        return WICED_FALSE;
+
+    /* the server truncates the value to what fits in one PDU */
+    if ( len > p_conn->mtu - 3 )
+        len = p_conn->mtu - 3;
+
+    p_event = mock_event_alloc( MOCK_EVENT_GATT, conn_id, 0 );
+    p_event->gatt_event = GATT_OPERATION_CPLT_EVT;
+    p_event->data.gatt.operation_complete.conn_id = conn_id;
+    p_event->data.gatt.operation_complete.op      = ( p_conn->cccd[cccd] & GATT_CLIENT_CONFIG_NOTIFICATION ) ?
+                                                    GATTC_OPTYPE_NOTIFICATION : GATTC_OPTYPE_INDICATION;
+    p_event->data.gatt.operation_complete.status  = WICED_BT_GATT_SUCCESS;
+    p_event->data.gatt.operation_complete.response_data.att_value.handle = handle;
+    p_event->data.gatt.operation_complete.response_data.att_value.len    = len;
+    memcpy( p_event->value, p_data, len );
+    p_event->value_len = len;
+    mock_event_post( p_event );
+
+    mock_stats.notifications++;
+    return WICED_TRUE;
+}
+
+uint16_t mock_btstack_find_value_handle( uint16_t char_uuid )
+{
+    int i;
+
+    for ( i = 0; i < mock_db_size; i++ )
+        if ( ( mock_db[i].type == char_uuid ) && ( i > 0 ) && ( mock_db[i - 1].type == UUID_ATTRIBUTE_CHARACTERISTIC ) )
+            return mock_db[i].handle;
+    return 0;
+}
+
+void mock_btstack_set_server_mtu( uint16_t mtu )
+{
+    if ( ( mtu >= GATT_DEF_BLE_MTU_SIZE ) && ( mtu <= MOCK_BTSTACK_MAX_MTU ) )
+        mock_server_mtu = mtu;
+}
+
+void mock_btstack_set_layout( uint16_t ans_service_handle, uint16_t num_other_services )
+{
+    uint16_t first = MOCK_BTSTACK_DATABASE_HASH_VALUE_HANDLE + 1;
+
+    if ( ( ans_service_handle < first ) || ( ans_service_handle > 0xffff - 0x0b ) )
+        return;
+
+    /* each other service takes 3 handles */
+    if ( num_other_services > MOCK_BTSTACK_MAX_OTHER_SERVICES )
+        num_other_services = MOCK_BTSTACK_MAX_OTHER_SERVICES;
+    if ( num_other_services > ( ans_service_handle - first ) / 3 )
+        num_other_services = ( ans_service_handle - first ) / 3;
+
+    mock_ans_handle         = ans_service_handle;
+    mock_num_other_services = num_other_services;
+
+    /* already built by the stack init */
+    if ( mock_db_size != 0 )
+        mock_db_build();
+}
+
+void mock_btstack_set_require_encryption( wiced_bool_t require )
+{
+    mock_require_encryption = require;
+}
+
+void mock_btstack_set_read_multiple_supported( wiced_bool_t supported )
+{
+    mock_read_multiple_unsupported = !supported;
+}
+
+void mock_btstack_delay_next_response( uint16_t conn_id, uint64_t delay_us )
+{
+    mock_conn_t *p_conn = mock_find_conn( conn_id );
+
+    if ( p_conn != NULL )
+        p_conn->next_response_delay_us = delay_us;
+}
+
+void mock_btstack_get_stats( mock_btstack_stats_t *p_stats )
+{
+    *p_stats = mock_stats;
+}
+
+/******************************************************
+ *               GATT client
+ ******************************************************/
+wiced_bt_gatt_status_t wiced_bt_gatt_register( wiced_bt_gatt_cback_t *p_gatt_cback )
+{
+    p_mock_gatt_cback = p_gatt_cback;
+    return WICED_BT_GATT_SUCCESS;
+}
+
+/* Checks that a request can be sent on the connection and marks it pending */
+static wiced_bt_gatt_status_t mock_start_request( mock_conn_t *p_conn )
+{
+    if ( p_conn == NULL )
+        return WICED_BT_GATT_ILLEGAL_PARAMETER;
+    if ( p_conn->busy )
+    {
+        mock_stats.busy++;
+        return WICED_BT_GATT_BUSY;
+    }
+    p_conn->busy = WICED_TRUE;
+    p_conn->response_delay_us = p_conn->next_response_delay_us;
+    p_conn->next_response_delay_us = 0;
+    return WICED_BT_GATT_SUCCESS;
+}
+
+/* Number of PDUs to get n entries of entry_len bytes, plus the final empty one
+ * when the last entry does not end the range */
+static uint32_t mock_pdu_count( mock_conn_t *p_conn, uint32_t n, uint32_t entry_len, wiced_bool_t range_done )
+{
+    uint32_t per_pdu = ( p_conn->mtu - 2 ) / entry_len;
+
+    return ( n + per_pdu - 1 ) / per_pdu + ( range_done ? 0 : 1 );
+}
+
+wiced_bt_gatt_status_t wiced_bt_gatt_client_send_discover( uint16_t conn_id,
+        wiced_bt_gatt_discovery_type_t discovery_type, wiced_bt_gatt_discovery_param_t *p_discovery_param )
+{
+    mock_conn_t *p_conn = mock_find_conn( conn_id );
+    wiced_bt_gatt_status_t status = mock_start_request( p_conn );
+    wiced_bt_gatt_discovery_data_t *p_result;
+    mock_event_t *p_event;
+    uint16_t s_handle = p_discovery_param->s_handle;
+    uint16_t e_handle = p_discovery_param->e_handle;
+    uint16_t last_handle = 0;
+    uint32_t entry_len, n = 0, per_pdu, pdus;
+    int i;
+
+    if ( status != WICED_BT_GATT_SUCCESS )
+        return status;
+
+    switch ( discovery_type )
+    {
+    case GATT_DISCOVER_SERVICES_ALL:
+    case GATT_DISCOVER_SERVICES_BY_UUID:
+        entry_len = ( discovery_type == GATT_DISCOVER_SERVICES_ALL ) ? 6 : 4;
+        mock_stats.discover_services++;
+        break;
+    case GATT_DISCOVER_CHARACTERISTICS:
+        entry_len = 7;
+        mock_stats.discover_characteristics++;
+        break;
+    case GATT_DISCOVER_CHARACTERISTIC_DESCRIPTORS:
+        entry_len = 4;
+        mock_stats.discover_descriptors++;
+        break;
+    default:
+        p_conn->busy = WICED_FALSE;
+        return WICED_BT_GATT_REQ_NOT_SUPPORTED;
+    }
+    per_pdu = ( p_conn->mtu - 2 ) / entry_len;
+
+    for ( i = 0; i < mock_db_size; i++ )
+    {
+        mock_attr_t *p_attr = &mock_db[i];
+
+        if ( ( p_attr->handle < s_handle ) || ( p_attr->handle > e_handle ) )
+            continue;
+
+        p_event  = mock_event_alloc( MOCK_EVENT_GATT, conn_id, 0 );
+        p_result = &p_event->data.gatt.discovery_result.discovery_data;
+
+        if ( ( discovery_type == GATT_DISCOVER_SERVICES_ALL ) || ( discovery_type == GATT_DISCOVER_SERVICES_BY_UUID ) )
+        {
+            if ( ( p_attr->type != UUID_ATTRIBUTE_PRIMARY_SERVICE ) ||
+                 ( ( discovery_type == GATT_DISCOVER_SERVICES_BY_UUID ) &&
+                   ( ( p_attr->value[0] | ( p_attr->value[1] << 8 ) ) != p_discovery_param->uuid.uu.uuid16 ) ) )
+            {
+                free( p_event );
+                continue;
+            }
+            p_result->group_value.s_handle = p_attr->handle;
+            p_result->group_value.e_handle = mock_db_service_end( i );
+            p_result->group_value.service_type.len = LEN_UUID_16;
+            p_result->group_value.service_type.uu.uuid16 = p_attr->value[0] | ( p_attr->value[1] << 8 );
+            last_handle = p_result->group_value.e_handle;
+        }
+        else if ( discovery_type == GATT_DISCOVER_CHARACTERISTICS )
+        {
+            if ( p_attr->type != UUID_ATTRIBUTE_CHARACTERISTIC )
+            {
+                free( p_event );
+                continue;
+            }
+            p_result->characteristic_declaration.handle = p_attr->handle;
+            p_result->characteristic_declaration.characteristic_properties = p_attr->value[0];
+            p_result->characteristic_declaration.val_handle = p_attr->value[1] | ( p_attr->value[2] << 8 );
+            p_result->characteristic_declaration.char_uuid.len = LEN_UUID_16;
+            p_result->characteristic_declaration.char_uuid.uu.uuid16 = p_attr->value[3] | ( p_attr->value[4] << 8 );
+            last_handle = p_result->characteristic_declaration.val_handle;
+        }
+        else
+        {
+            /* Find Information returns every attribute of the range */
+            p_result->char_descr_info.handle = p_attr->handle;
+            p_result->char_descr_info.type.len = LEN_UUID_16;
+            p_result->char_descr_info.type.uu.uuid16 = p_attr->type;
+            last_handle = p_attr->handle;
+        }
+
+        /* a result arrives with the response PDU that carries it */
+        p_event->due_us     = mock_now_us + ( n / per_pdu + 1 ) * MOCK_BTSTACK_ROUND_TRIP_US;
+        p_event->gatt_event = GATT_DISCOVERY_RESULT_EVT;
+        p_event->data.gatt.discovery_result.conn_id = conn_id;
+        p_event->data.gatt.discovery_result.discovery_type = discovery_type;
+        mock_event_post( p_event );
+        n++;
+    }
+
+    pdus = mock_pdu_count( p_conn, n, entry_len, ( n != 0 ) && ( last_handle >= e_handle ) );
+    p_event = mock_event_alloc( MOCK_EVENT_GATT, conn_id, pdus * MOCK_BTSTACK_ROUND_TRIP_US );
+    p_event->completes_request = WICED_TRUE;
+    p_event->gatt_event = GATT_DISCOVERY_CPLT_EVT;
+    p_event->data.gatt.discovery_complete.conn_id = conn_id;
+    p_event->data.gatt.discovery_complete.discovery_type = discovery_type;
+    p_event->data.gatt.discovery_complete.status = WICED_BT_GATT_SUCCESS;
+    mock_event_post( p_event );
+
+    return WICED_BT_GATT_SUCCESS;
+}
+
+static mock_event_t *mock_read_event( uint16_t conn_id, wiced_bt_gatt_optype_t op, uint16_t handle,
+                                      void *p_read_buf, uint16_t len )
+{
+    mock_event_t *p_event = mock_event_alloc( MOCK_EVENT_GATT, conn_id, MOCK_BTSTACK_ROUND_TRIP_US );
+
+    p_event->completes_request = WICED_TRUE;
+    p_event->gatt_event = GATT_OPERATION_CPLT_EVT;
+    p_event->p_read_buf = p_read_buf;
+    p_event->read_buf_len = len;
+    p_event->data.gatt.operation_complete.conn_id = conn_id;
+    p_event->data.gatt.operation_complete.op = op;
+    p_event->data.gatt.operation_complete.response_data.att_value.handle = handle;
+    return p_event;
+}
+
+wiced_bt_gatt_status_t wiced_bt_gatt_client_send_read_handle( uint16_t conn_id, uint16_t handle,
+        uint16_t offset, void *p_read_buf, uint16_t len, wiced_bt_gatt_auth_req_t auth_req )
+{
+    mock_conn_t *p_conn = mock_find_conn( conn_id );
+    wiced_bt_gatt_status_t status = mock_start_request( p_conn );
+    mock_event_t *p_event;
+    int index = mock_db_find( handle );
+
+    if ( status != WICED_BT_GATT_SUCCESS )
+        return status;
+
+    mock_stats.read_handle++;
+    p_event = mock_read_event( conn_id, GATTC_OPTYPE_READ_HANDLE, handle, p_read_buf, len );
+    if ( index < 0 )
+    {
+        p_event->data.gatt.operation_complete.status = WICED_BT_GATT_INVALID_HANDLE;
+    }
+    else if ( offset < mock_db[index].len )
+    {
+        p_event->value_len = mock_db[index].len - offset;
+        if ( p_event->value_len > p_conn->mtu - 1 )
+            p_event->value_len = p_conn->mtu - 1;
+        memcpy( p_event->value, &mock_db[index].value[offset], p_event->value_len );
+    }
+    mock_event_post( p_event );
+    return WICED_BT_GATT_SUCCESS;
+}
+
+/* Only the first attribute of the type in the range is returned */
+wiced_bt_gatt_status_t wiced_bt_gatt_client_send_read_by_type( uint16_t conn_id, uint16_t s_handle,
+        uint16_t e_handle, wiced_bt_uuid_t *p_uuid, uint8_t *p_read_buf, uint16_t len,
+        wiced_bt_gatt_auth_req_t auth_req )
+{
+    mock_conn_t *p_conn = mock_find_conn( conn_id );
+    wiced_bt_gatt_status_t status = mock_start_request( p_conn );
+    mock_event_t *p_event;
+    int i;
+
+    if ( status != WICED_BT_GATT_SUCCESS )
+        return status;
+
+    mock_stats.read_by_type++;
+    p_event = mock_read_event( conn_id, GATTC_OPTYPE_READ_BY_TYPE, 0, p_read_buf, len );
+    p_event->data.gatt.operation_complete.status = WICED_BT_GATT_ATTRIBUTE_NOT_FOUND;
+    for ( i = 0; i < mock_db_size; i++ )
+    {
+        if ( ( mock_db[i].handle >= s_handle ) && ( mock_db[i].handle <= e_handle ) &&
+             ( p_uuid->len == LEN_UUID_16 ) && ( mock_db[i].type == p_uuid->uu.uuid16 ) )
+        {
+            p_event->data.gatt.operation_complete.status = WICED_BT_GATT_SUCCESS;
+            p_event->data.gatt.operation_complete.response_data.att_value.handle = mock_db[i].handle;
+            p_event->value_len = mock_db[i].len;
+            if ( p_event->value_len > p_conn->mtu - 4 )
+                p_event->value_len = p_conn->mtu - 4;
+            memcpy( p_event->value, mock_db[i].value, p_event->value_len );
+            break;
+        }
+    }
+    mock_event_post( p_event );
+    return WICED_BT_GATT_SUCCESS;
+}
+
+wiced_bt_gatt_status_t wiced_bt_gatt_client_send_read_multiple( uint16_t conn_id,
+        wiced_bt_gatt_opcode_t opcode, uint16_t *p_handle_list, int num_handles,
+        uint8_t *p_read_buf, uint16_t len, wiced_bt_gatt_auth_req_t auth_req )
+{
+    mock_conn_t *p_conn = mock_find_conn( conn_id );
+    wiced_bt_gatt_status_t status = mock_start_request( p_conn );
+    mock_event_t *p_event;
+    uint16_t max_len, value_len;
+    int i, index;
+
+    if ( status != WICED_BT_GATT_SUCCESS )
+        return status;
+
+    if ( ( num_handles < 2 ) ||
+         ( ( opcode != GATT_REQ_READ_MULTI ) && ( opcode != GATT_REQ_READ_MULTI_VAR_LENGTH ) ) )
+    {
+        p_conn->busy = WICED_FALSE;
+        return WICED_BT_GATT_ILLEGAL_PARAMETER;
+    }
+
+    mock_stats.read_multiple++;
+    p_event = mock_read_event( conn_id, GATTC_OPTYPE_READ_MULTIPLE, p_handle_list[0], p_read_buf, len );
+    if ( mock_read_multiple_unsupported )
+    {
+        p_event->data.gatt.operation_complete.status = WICED_BT_GATT_REQ_NOT_SUPPORTED;
+        mock_event_post( p_event );
+        return WICED_BT_GATT_SUCCESS;
+    }
+    max_len = p_conn->mtu - 1;
+    for ( i = 0; i < num_handles; i++ )
+    {
+        index = mock_db_find( p_handle_list[i] );
+        if ( index < 0 )
+        {
+            p_event->data.gatt.operation_complete.status = WICED_BT_GATT_INVALID_HANDLE;
+            p_event->data.gatt.operation_complete.response_data.att_value.handle = p_handle_list[i];
+            p_event->value_len = 0;
+            break;
+        }
+        value_len = mock_db[index].len;
+        if ( opcode == GATT_REQ_READ_MULTI_VAR_LENGTH )
+        {
+            if ( p_event->value_len + 2 > max_len )
+                break;
+            p_event->value[p_event->value_len++] = value_len & 0xff;
+            p_event->value[p_event->value_len++] = value_len >> 8;
+        }
+        if ( p_event->value_len + value_len > max_len )
+            value_len = max_len - p_event->value_len;
+        memcpy( &p_event->value[p_event->value_len], mock_db[index].value, value_len );
+        p_event->value_len += value_len;
+    }
+    mock_event_post( p_event );
+    return WICED_BT_GATT_SUCCESS;
+}
+
+/* Server side of a write, returns the ATT status */
+static wiced_bt_gatt_status_t mock_server_write( mock_conn_t *p_conn, uint16_t handle, const uint8_t *p_val, uint16_t len )
+{
+    int index = mock_db_find( handle );
+    mock_attr_t *p_attr;
+
+    if ( index < 0 )
+        return WICED_BT_GATT_INVALID_HANDLE;
+    p_attr = &mock_db[index];
+
+    if ( p_attr->type == UUID_DESCRIPTOR_CLIENT_CHARACTERISTIC_CONFIGURATION )
+    {
+        if ( mock_require_encryption && !p_conn->encrypted )
+            return WICED_BT_GATT_INSUF_AUTHENTICATION;
+        if ( len != 2 )
+            return WICED_BT_GATT_INVALID_ATTR_LEN;
+        p_conn->cccd[index] = p_val[0] | ( p_val[1] << 8 );
+        return WICED_BT_GATT_SUCCESS;
+    }
+    if ( p_attr->type == UUID_CHARACTERISTIC_ALERT_NOTIFICATION_CONTROL_POINT )
+    {
+        /* command id 0-5, category id 0-9 or 0xff for all */
+        if ( ( len != 2 ) || ( p_val[0] > 5 ) || ( ( p_val[1] > 9 ) && ( p_val[1] != 0xff ) ) )
+            return MOCK_BTSTACK_ANS_CMD_NOT_SUPPORTED;
+        return WICED_BT_GATT_SUCCESS;
+    }
+    if ( ( index > 0 ) && ( mock_db[index - 1].type == UUID_ATTRIBUTE_CHARACTERISTIC ) &&
+         ( mock_db[index - 1].value[0] & MOCK_PROP_WRITE ) && ( len <= MOCK_BTSTACK_MAX_VALUE ) )
+    {
+        memcpy( p_attr->value, p_val, len );
+        p_attr->len = len;
+        return WICED_BT_GATT_SUCCESS;
+    }
+    return WICED_BT_GATT_WRITE_NOT_PERMIT;
+}
+
+wiced_bt_gatt_status_t wiced_bt_gatt_client_send_write( uint16_t conn_id, wiced_bt_gatt_opcode_t opcode,
+        wiced_bt_gatt_write_hdr_t *p_hdr, uint8_t *p_val, void *p_app_ctx )
+{
+    mock_conn_t *p_conn = mock_find_conn( conn_id );
+    wiced_bt_gatt_status_t status;
+    mock_event_t *p_event;
+
+    if ( p_conn == NULL )
+        return WICED_BT_GATT_ILLEGAL_PARAMETER;
+
+    if ( opcode == GATT_CMD_WRITE )
+    {
+        /* commands do not wait for a response and do not hold the bearer */
+        mock_stats.write_cmd++;
+        mock_server_write( p_conn, p_hdr->handle, p_val, p_hdr->len );
+        p_event = mock_event_alloc( MOCK_EVENT_GATT, conn_id, 0 );
+        p_event->data.gatt.operation_complete.op = GATTC_OPTYPE_WRITE_NO_RSP;
+        p_event->data.gatt.operation_complete.status = WICED_BT_GATT_SUCCESS;
+    }
+    else
+    {
+        status = mock_start_request( p_conn );
+        if ( status != WICED_BT_GATT_SUCCESS )
+            return status;
+
+        mock_stats.write_req++;
+        p_event = mock_event_alloc( MOCK_EVENT_GATT, conn_id, MOCK_BTSTACK_ROUND_TRIP_US );
+        p_event->completes_request = WICED_TRUE;
+        p_event->data.gatt.operation_complete.op = GATTC_OPTYPE_WRITE_WITH_RSP;
+        p_event->data.gatt.operation_complete.status = mock_server_write( p_conn, p_hdr->handle, p_val, p_hdr->len );
+    }
+    p_event->gatt_event = GATT_OPERATION_CPLT_EVT;
+    p_event->data.gatt.operation_complete.conn_id = conn_id;
+    p_event->data.gatt.operation_complete.response_data.handle = p_hdr->handle;
+    mock_event_post( p_event );
+    return WICED_BT_GATT_SUCCESS;
+}
+
+wiced_bt_gatt_status_t wiced_bt_gatt_client_configure_mtu( uint16_t conn_id, uint16_t mtu )
+{
+    mock_conn_t *p_conn = mock_find_conn( conn_id );
+    wiced_bt_gatt_status_t status = mock_start_request( p_conn );
+    mock_event_t *p_event;
+
+    if ( status != WICED_BT_GATT_SUCCESS )
+        return status;
+
+    mock_stats.config_mtu++;
+    p_conn->mtu = ( mtu < mock_server_mtu ) ? mtu : mock_server_mtu;
+    if ( p_conn->mtu < GATT_DEF_BLE_MTU_SIZE )
+        p_conn->mtu = GATT_DEF_BLE_MTU_SIZE;
+
+    p_event = mock_event_alloc( MOCK_EVENT_GATT, conn_id, MOCK_BTSTACK_ROUND_TRIP_US );
+    p_event->completes_request = WICED_TRUE;
+    p_event->gatt_event = GATT_OPERATION_CPLT_EVT;
+    p_event->data.gatt.operation_complete.conn_id = conn_id;
+    p_event->data.gatt.operation_complete.op = GATTC_OPTYPE_CONFIG_MTU;
+    p_event->data.gatt.operation_complete.status = WICED_BT_GATT_SUCCESS;
+    p_event->data.gatt.operation_complete.response_data.mtu = p_conn->mtu;
+    mock_event_post( p_event );
+    return WICED_BT_GATT_SUCCESS;
+}
+
+wiced_bt_gatt_status_t wiced_bt_gatt_client_send_indication_confirm( uint16_t conn_id, uint16_t handle )
+{
+    return ( mock_find_conn( conn_id ) != NULL ) ? WICED_BT_GATT_SUCCESS : WICED_BT_GATT_ILLEGAL_PARAMETER;
+}
+
+wiced_bt_gatt_status_t wiced_bt_gatt_disconnect( uint16_t conn_id )
+{
+    mock_conn_t *p_conn = mock_find_conn( conn_id );
+
+    if ( p_conn == NULL )
+        return WICED_BT_GATT_ILLEGAL_PARAMETER;
+
+    mock_stats.local_disconnects++;
+    mock_disconnect( p_conn, conn_id, GATT_CONN_TERMINATE_LOCAL_HOST );
+    return WICED_BT_GATT_SUCCESS;
+}
+
+/******************************************************
+ *               Stack, device and security
+ ******************************************************/
+wiced_result_t wiced_bt_stack_init( wiced_bt_management_cback_t *p_bt_management_cback,
+                                    const wiced_bt_cfg_settings_t *p_bt_cfg_settings )
+{
+    mock_event_t *p_event;
+
+    p_mock_mgmt_cback = p_bt_management_cback;
+    mock_db_build();
+
+    p_event = mock_event_alloc( MOCK_EVENT_MGMT, 0, 0 );
+    p_event->data.mgmt.enabled.status = WICED_BT_SUCCESS;
+    mock_post_mgmt( BTM_ENABLED_EVT, p_event );
+    return WICED_BT_SUCCESS;
+}
+
+wiced_result_t wiced_bt_stack_deinit( void )
+{
+    mock_event_t *p_event;
+
+    while ( ( p_event = p_mock_events ) != NULL )
+    {
+        p_mock_events = p_event->p_next;
+        free( p_event );
+    }
+    p_mock_timers = NULL;
+    p_mock_mgmt_cback = NULL;
+    p_mock_gatt_cback = NULL;
+    return WICED_BT_SUCCESS;
+}
+
+void wiced_bt_set_pairable_mode( uint8_t allow_pairing, uint8_t connect_only_paired )
+{
+}
+
+wiced_result_t wiced_bt_dev_add_device_to_address_resolution_db( wiced_bt_device_link_keys_t *p_link_keys )
+{
+    return WICED_BT_SUCCESS;
+}
+
+wiced_result_t wiced_bt_set_local_bdaddr( wiced_bt_device_address_t bda, wiced_bt_ble_address_type_t addr_type )
+{
+    return WICED_BT_SUCCESS;
+}
+
+void wiced_bt_dev_read_local_addr( wiced_bt_device_address_t bd_addr )
+{
+    static const wiced_bt_device_address_t local_addr = { 0x11, 0x12, 0x13, 0x51, 0x52, 0x53 };
+
+    memcpy( bd_addr, local_addr, BD_ADDR_LEN );
+}
+
+wiced_result_t wiced_bt_dev_confirm_req_reply( wiced_result_t res, wiced_bt_device_address_t bd_addr )
+{
+    return WICED_BT_SUCCESS;
+}
+
+/* Pairing always succeeds: keys, pairing complete and encryption come one round trip later */
+wiced_result_t wiced_bt_dev_sec_bond( wiced_bt_device_address_t bd_addr, wiced_bt_ble_address_type_t bd_addr_type,
+                                      wiced_bt_transport_t transport, uint8_t pin_len, uint8_t *p_pin )
+{
+    mock_event_t *p_event;
+    int i;
+
+    for ( i = 0; i < MOCK_BTSTACK_MAX_CONNS; i++ )
+        if ( ( mock_conns[i].conn_id != 0 ) && ( memcmp( mock_conns[i].bd_addr, bd_addr, BD_ADDR_LEN ) == 0 ) )
+            break;
+    if ( i == MOCK_BTSTACK_MAX_CONNS )
+        return WICED_BT_ERROR;
+
+    mock_conns[i].encrypted = WICED_TRUE;
+    memcpy( mock_paired_addr, bd_addr, BD_ADDR_LEN );
+    mock_paired = WICED_TRUE;
+
+    p_event = mock_event_alloc( MOCK_EVENT_MGMT, mock_conns[i].conn_id, MOCK_BTSTACK_ROUND_TRIP_US );
+    memcpy( p_event->data.mgmt.paired_device_link_keys_update.bd_addr, bd_addr, BD_ADDR_LEN );
+    memset( p_event->data.mgmt.paired_device_link_keys_update.key_data, 0x5a,
+            sizeof(p_event->data.mgmt.paired_device_link_keys_update.key_data) );
+    mock_post_mgmt( BTM_PAIRED_DEVICE_LINK_KEYS_UPDATE_EVT, p_event );
+
+    p_event = mock_event_alloc( MOCK_EVENT_MGMT, mock_conns[i].conn_id, MOCK_BTSTACK_ROUND_TRIP_US );
+    memcpy( p_event->bd_addr, bd_addr, BD_ADDR_LEN );
+    p_event->data.mgmt.pairing_complete.bd_addr = p_event->bd_addr;
+    p_event->data.mgmt.pairing_complete.pairing_complete_info.ble.reason = SMP_SUCCESS;
+    mock_post_mgmt( BTM_PAIRING_COMPLETE_EVT, p_event );
+
+    p_event = mock_event_alloc( MOCK_EVENT_MGMT, mock_conns[i].conn_id, MOCK_BTSTACK_ROUND_TRIP_US );
+    memcpy( p_event->bd_addr, bd_addr, BD_ADDR_LEN );
+    p_event->data.mgmt.encryption_status.bd_addr = p_event->bd_addr;
+    p_event->data.mgmt.encryption_status.result  = WICED_BT_SUCCESS;
+    mock_post_mgmt( BTM_ENCRYPTION_STATUS_EVT, p_event );
+
+    return WICED_PENDING;
+}
+
+wiced_result_t wiced_bt_ble_set_raw_advertisement_data( uint8_t num_elem, wiced_bt_ble_advert_elem_t *p_data )
+{
+    return WICED_BT_SUCCESS;
+}
+
+wiced_result_t wiced_bt_start_advertisements( wiced_bt_ble_advert_mode_t advert_mode,
+                                              wiced_bt_ble_address_type_t directed_advertisement_bdaddr_type,
+                                              wiced_bt_device_address_t directed_advertisement_bdaddr_ptr )
+{
+    mock_event_t *p_event = mock_event_alloc( MOCK_EVENT_MGMT, 0, 0 );
+
+    p_event->data.mgmt.ble_advert_state_changed = advert_mode;
+    mock_post_mgmt( BTM_BLE_ADVERT_STATE_CHANGED_EVT, p_event );
+    return WICED_BT_SUCCESS;
+}
+
+void wiced_bt_ble_security_grant( wiced_bt_device_address_t bd_addr, uint8_t res )
+{
+}
+
+/******************************************************
+ *               Buffers
+ ******************************************************/
+void *wiced_bt_get_buffer( uint32_t size )
+{
+    return malloc( size );
+}
+
+void wiced_bt_free_buffer( void *p_buf )
+{
+    free( p_buf );
+}
+
+wiced_bt_heap_t *wiced_bt_create_heap( const char *name, void *p_area, int size,
+                                       void *p_lock, wiced_bool_t b_make_default )
+{
+    return &mock_heap;
+}
+
+void wiced_bt_delete_heap( wiced_bt_heap_t *p_heap )
+{
+}
+
+/******************************************************
+ *               Timers, on the virtual clock
+ ******************************************************/
+wiced_result_t wiced_init_timer( wiced_timer_t *p_timer, wiced_timer_callback_t TimerCb,
+                                 WICED_TIMER_PARAM_TYPE cBackparam, wiced_timer_type_t type )
+{
+    memset( p_timer, 0, sizeof(*p_timer) );
+    p_timer->cback       = TimerCb;
+    p_timer->cback_param = cBackparam;
+    p_timer->type        = type;
+    return WICED_SUCCESS;
+}
+
+wiced_result_t wiced_deinit_timer( wiced_timer_t *p_timer )
+{
+    return wiced_stop_timer( p_timer );
+}
+
+wiced_result_t wiced_start_timer( wiced_timer_t *p_timer, uint32_t timeout )
+{
+    wiced_stop_timer( p_timer );
+    p_timer->timeout   = timeout;
+    p_timer->expiry_us = mock_now_us + mock_timer_period_us( p_timer );
+    p_timer->in_use    = WICED_TRUE;
+    p_timer->p_next    = p_mock_timers;
+    p_mock_timers      = p_timer;
+    return WICED_SUCCESS;
+}
+
+wiced_result_t wiced_stop_timer( wiced_timer_t *p_timer )
+{
+    wiced_timer_t **pp;
+
+    for ( pp = &p_mock_timers; *pp != NULL; pp = &( *pp )->p_next )
+    {
+        if ( *pp == p_timer )
+        {
+            *pp = p_timer->p_next;
+            break;
+        }
+    }
+    p_timer->in_use = WICED_FALSE;
+    p_timer->p_next = NULL;
+    return WICED_SUCCESS;
+}
+
+wiced_bool_t wiced_is_timer_in_use( wiced_timer_t *p_timer )
+{
+    return p_timer->in_use;
+}
+
+uint64_t clock_SystemTimeMicroseconds64( void )
+{
+    return mock_now_us;
+}
+
+/******************************************************
+ *               NVRAM, kept in memory
+ ******************************************************/
+static mock_nvram_t *mock_nvram_find( uint16_t vs_id, wiced_bool_t create )
+{
+    int i;
+
+    for ( i = 0; i < MOCK_BTSTACK_MAX_NVRAM; i++ )
+        if ( ( mock_nvram[i].id == vs_id ) && ( vs_id != 0 ) )
+            return &mock_nvram[i];
+    for ( i = 0; create && ( i < MOCK_BTSTACK_MAX_NVRAM ); i++ )
+    {
+        if ( mock_nvram[i].id == 0 )
+        {
+            mock_nvram[i].id = vs_id;
+            return &mock_nvram[i];
+        }
+    }
+    return NULL;
+}
+
+uint16_t wiced_hal_write_nvram( uint16_t vs_id, uint16_t data_length, uint8_t *p_data, wiced_result_t *p_status )
+{
+    mock_nvram_t *p_entry = mock_nvram_find( vs_id, WICED_TRUE );
+
+    if ( ( p_entry == NULL ) || ( data_length > sizeof(p_entry->data) ) )
+    {
+        *p_status = WICED_ERROR;
+        return 0;
+    }
+    memcpy( p_entry->data, p_data, data_length );
+    p_entry->len = data_length;
+    *p_status = WICED_SUCCESS;
+    return data_length;
+}
+
+uint16_t wiced_hal_read_nvram( uint16_t vs_id, uint16_t data_length, uint8_t *p_data, wiced_result_t *p_status )
+{
+    mock_nvram_t *p_entry = mock_nvram_find( vs_id, WICED_FALSE );
+
+    if ( p_entry == NULL )
+    {
+        *p_status = WICED_BADARG;
+        return 0;
+    }
+    if ( data_length > p_entry->len )
+        data_length = p_entry->len;
+    memcpy( p_data, p_entry->data, data_length );
+    *p_status = WICED_SUCCESS;
+    return data_length;
+}
+
+void wiced_hal_delete_nvram( uint16_t vs_id, wiced_result_t *p_status )
+{
+    mock_nvram_t *p_entry = mock_nvram_find( vs_id, WICED_FALSE );
+
+    if ( p_entry != NULL )
+        memset( p_entry, 0, sizeof(*p_entry) );
+    *p_status = WICED_SUCCESS;
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * In-process stand-in for the AIROC BTSTACK used by the anc_mock target.
+ *
+ * The stack side API (wiced_bt_gatt_client_*, buffers, timers, NVRAM, device
+ * management) is implemented against a scripted remote GATT database holding an
+ * Alert Notification service. Requests are answered through the registered
+ * callbacks from mock_btstack_run(), never from inside the request, like the
+ * real stack. Timers run on a virtual clock which only advances when no event
+ * is pending, so a run is deterministic and goes at CPU speed.
+ *
+ * The functions below are used by the driver to play the remote device.
+ */
+#ifndef MOCK_BTSTACK_H
+#define MOCK_BTSTACK_H
+
+#include "wiced_bt_types.h"
+#include "wiced_bt_gatt.h"
+
+/* Handles of the scripted remote database, the ANS one can be moved by
+ * mock_btstack_set_layout() */
+#define MOCK_BTSTACK_GAP_SERVICE_HANDLE             0x0001
+#define MOCK_BTSTACK_GATT_SERVICE_HANDLE            0x0006
+#define MOCK_BTSTACK_SERVICE_CHANGED_VALUE_HANDLE   0x0008
+#define MOCK_BTSTACK_DATABASE_HASH_VALUE_HANDLE     0x000B
+#define MOCK_BTSTACK_ANS_SERVICE_HANDLE             0x0010
+
+/* Number of ATT requests sent by the client, per procedure */
+typedef struct
+{
+    uint32_t discover_services;
+    uint32_t discover_characteristics;
+    uint32_t discover_descriptors;
+    uint32_t read_handle;
+    uint32_t read_by_type;
+    uint32_t read_multiple;
+    uint32_t write_req;
+    uint32_t write_cmd;
+    uint32_t config_mtu;
+    uint32_t busy;                  /* requests rejected because another one was pending */
+    uint32_t notifications;         /* notifications and indications sent by the server */
+    uint32_t local_disconnects;     /* links taken down by the client */
+} mock_btstack_stats_t;
+
+/* Deliver queued events and expired timers until nothing is left to do */
+void mock_btstack_run(void);
+
+/* Virtual time in microseconds */
+uint64_t mock_btstack_now_us(void);
+
+/* Remote device connects, returns the conn_id or 0 if no connection is free */
+uint16_t mock_btstack_connect(const wiced_bt_device_address_t bd_addr);
+
+/* Remote device disconnects */
+void mock_btstack_disconnect(uint16_t conn_id);
+
+/* Send a notification from the remote database. Only sent if the client enabled
+ * it in the CCCD of the characteristic */
+wiced_bool_t mock_btstack_notify(uint16_t conn_id, uint16_t handle, const uint8_t *p_data, uint16_t len);
+
+/* Value handle of a characteristic of the remote database, 0 if not present */
+uint16_t mock_btstack_find_value_handle(uint16_t char_uuid);
+
+/* MTU supported by the remote device, 23 to 517 */
+void mock_btstack_set_server_mtu(uint16_t mtu);
+
+/* Layout of the remote database: start handle of the ANS, which takes 12 more
+ * handles, and number of other services spread in front of it. Called once the
+ * stack is initialized, with no connection up, the database is rebuilt and its
+ * Database Hash changes, as after a firmware update of the remote device */
+void mock_btstack_set_layout(uint16_t ans_service_handle, uint16_t num_other_services);
+
+/* Remote device requires an encrypted link to write its CCCDs */
+void mock_btstack_set_require_encryption(wiced_bool_t require);
+
+/* Remote device answers Read Multiple Requests, the default */
+void mock_btstack_set_read_multiple_supported(wiced_bool_t supported);
+
+/* The remote device answers the next ATT request on the connection delay_us later than
+ * usual, the bearer stays busy until then. The response is lost if the link goes down first */
+void mock_btstack_delay_next_response(uint16_t conn_id, uint64_t delay_us);
+
+/* Number of ATT requests seen since the start */
+void mock_btstack_get_stats(mock_btstack_stats_t *p_stats);
+
+#endif /* MOCK_BTSTACK_H */
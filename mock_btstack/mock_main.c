@@ -0,0 +1,633 @@
+/******************************************************************************
+ * (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+ ******************************************************************************
+ * This software, including source code, documentation and related materials
+ * ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+ * subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+ * protection (United States and foreign), United States copyright laws and
+ * international treaty provisions. Therefore, you may use this Software only
+ * as provided in the license agreement accompanying the software package from
+ * which you obtained this Software ("EULA").
+ *
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software source
+ * code solely for use in connection with Cypress's integrated circuit products.
+ * Any reproduction, modification, translation, compilation, or representation
+ * of this Software except as specified above is prohibited without the express
+ * written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer of such
+ * system or application assumes all risk of such use and in doing so agrees to
+ * indemnify Cypress against all liability.
+ ******************************************************************************/
+/******************************************************************************
+ * File Name: mock_main.c
+ *
+ * Description: Entry file of the anc_mock target. Runs the alert notification
+ *              client against the mock stack and plays a remote Alert
+ *              Notification server: connect, discover, read the supported
+ *              categories, enable notifications, then send new alerts.
+ *              Then the asynchronous requests: mixed with commands, timed
+ *              out by a silent server, and pending when the link drops.
+ *              The outcome of each step is checked, the exit status is
+ *              EXIT_FAILURE when one check fails.
+ *
+ * Usage: anc_mock [number of alerts]
+ *
+ ******************************************************************************/
+/******************************************************************************
+ *                               INCLUDES
+ ******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include "wiced_memory.h"
+#include "wiced_bt_cfg.h"
+#include "wiced_bt_stack.h"
+#include "wiced_bt_uuid.h"
+#include "bt_app_anc.h"
+#include "mock_btstack.h"
+
+/******************************************************************************
+ *                               MACROS
+ ******************************************************************************/
+#define MOCK_DEFAULT_NUM_ALERTS     (10U)
+#define MOCK_NUM_ALERT_CATEGORIES   (10U)
+/* Time given to the event consumer thread to print the last events */
+#define MOCK_DRAIN_TIME_US          (200000U)
+
+/* Requests of the asynchronous API whose completion is kept */
+#define MOCK_MAX_COMPLETIONS        (8U)
+/* Delay of a response the client gives up on, past its default GATT timeout of 20 s */
+#define MOCK_LATE_RESPONSE_US       (40000000ULL)
+#define MOCK_GATT_TIMEOUT_US        (20000000ULL)
+
+/* Records a failed check with the line of the driver, the run goes on */
+#define MOCK_CHECK(cond)            mock_check((cond) ? WICED_TRUE : WICED_FALSE, #cond, __LINE__)
+
+/******************************************************************************
+ *                           GLOBAL VARIABLES
+ ******************************************************************************/
+wiced_bt_heap_t *p_default_heap = NULL;
+uint8_t anc_bd_address[LOCAL_BDA_LEN] = {0x11, 0x12, 0x13, 0x51, 0x52, 0x53};
+const wiced_bt_cfg_settings_t wiced_bt_cfg_settings =
+{
+    .device_name = (uint8_t *)"ANC mock",
+};
+
+static const wiced_bt_device_address_t mock_peer_addr = {0x20, 0x21, 0x22, 0x61, 0x62, 0x63};
+/* Peer that does not pair */
+static const wiced_bt_device_address_t mock_guest_addr = {0x20, 0x21, 0x22, 0x71, 0x72, 0x73};
+
+static const char *const mock_setup_phase_names[WICED_BT_ANC_NUM_PHASES] =
+{
+    "MTU exchange",
+    "service search",
+    "characteristics",
+    "descriptors",
+    "first CCCD write",
+};
+
+static unsigned int mock_failed_checks;
+
+/* Completion of a request of the asynchronous API */
+typedef struct
+{
+    wiced_bt_anc_request_id_t   id;
+    wiced_bt_anc_event_t        event;
+    wiced_bt_gatt_status_t      status;
+    uint64_t                    time_us;
+    wiced_bt_gatt_status_t      command_status;     /* of a command sent from a timed out completion */
+} mock_completion_t;
+
+static mock_completion_t mock_completions[MOCK_MAX_COMPLETIONS];
+static unsigned int mock_num_completions;
+
+/******************************************************************************
+ *                       FUNCTION DEFINITIONS
+ ******************************************************************************/
+
+/*******************************************************************************
+ * Function Name: mock_check()
+ ********************************************************************************
+ * Summary:
+ *   Counts and prints a check of the driver that failed
+ *
+ * Parameters:
+ *   wiced_bool_t passed    : outcome of the check
+ *   const char *p_check    : text of the check
+ *   int line               : line of the check
+ *
+ * Return:
+ *   None
+ *
+ *******************************************************************************/
+static void mock_check(wiced_bool_t passed, const char *p_check, int line)
+{
+    if (!passed)
+    {
+        fprintf(stderr, "mock_main.c:%d: check failed: %s\n", line, p_check);
+        mock_failed_checks++;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: mock_discoveries()
+ ********************************************************************************
+ * Summary:
+ *   Number of discovery requests sent since a snapshot of the stack counters
+ *
+ * Parameters:
+ *   const mock_btstack_stats_t *p_base : counters at the snapshot
+ *
+ * Return:
+ *   uint32_t : discovery requests of every type
+ *
+ *******************************************************************************/
+static uint32_t mock_discoveries(const mock_btstack_stats_t *p_base)
+{
+    mock_btstack_stats_t stats;
+
+    mock_btstack_get_stats(&stats);
+    return (stats.discover_services - p_base->discover_services) +
+           (stats.discover_characteristics - p_base->discover_characteristics) +
+           (stats.discover_descriptors - p_base->discover_descriptors);
+}
+
+/*******************************************************************************
+ * Function Name: mock_events_delivered()
+ ********************************************************************************
+ * Summary:
+ *   Number of ANC events of a type given to the application callback. The
+ *   callback runs on the stack thread, the count is final once the stack ran.
+ *
+ * Parameters:
+ *   wiced_bt_anc_event_t event : ANC event
+ *
+ * Return:
+ *   uint64_t : events delivered since the start
+ *
+ *******************************************************************************/
+static uint64_t mock_events_delivered(wiced_bt_anc_event_t event)
+{
+    return __atomic_load_n(&bt_app_anc_get_callback_time(event)->count, __ATOMIC_ACQUIRE);
+}
+
+/*******************************************************************************
+ * Function Name: mock_request_complete()
+ ********************************************************************************
+ * Summary:
+ *   Completion function of the asynchronous requests, keeps their result. A
+ *   request that timed out tries a command at once, which the client must
+ *   refuse while the stack still waits for the response of the server.
+ *
+ * Parameters:
+ *   wiced_bt_anc_request_id_t request_id : request identifier
+ *   wiced_bt_anc_event_t event           : result event of the operation
+ *   wiced_bt_anc_event_data_t *p_data    : result
+ *   void *p_context                      : connection id
+ *
+ * Return:
+ *   None
+ *
+ *******************************************************************************/
+static void mock_request_complete(wiced_bt_anc_request_id_t request_id, wiced_bt_anc_event_t event,
+                                  wiced_bt_anc_event_data_t *p_data, void *p_context)
+{
+    mock_completion_t *p_completion;
+
+    if (mock_num_completions == MOCK_MAX_COMPLETIONS)
+    {
+        return;
+    }
+    p_completion = &mock_completions[mock_num_completions++];
+    p_completion->id = request_id;
+    p_completion->event = event;
+    p_completion->time_us = mock_btstack_now_us();
+    p_completion->command_status = WICED_BT_GATT_SUCCESS;
+
+    switch (event)
+    {
+    case WICED_BT_ANC_CONTROL_ALERTS_RESULT:
+        p_completion->status = p_data->control_alerts_result.status;
+        break;
+    case WICED_BT_ANC_READ_SUPPORTED_NEW_ALERTS_RESULT:
+        p_completion->status = p_data->supported_new_alerts_result.status;
+        break;
+    case WICED_BT_ANC_READ_SUPPORTED_UNREAD_ALERTS_RESULT:
+        p_completion->status = p_data->supported_unread_alerts_result.status;
+        break;
+    default:
+        p_completion->status = p_data->enable_disable_alerts_result.status;
+        break;
+    }
+
+    if (p_completion->status == WICED_BT_ANC_GATT_TIMEOUT)
+    {
+        p_completion->command_status = wiced_bt_anc_enable_new_alerts((uint16_t)(uintptr_t)p_context);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: mock_submit()
+ ********************************************************************************
+ * Summary:
+ *   Submits a request of the asynchronous API
+ *
+ * Parameters:
+ *   uint16_t conn_id               : connection id
+ *   wiced_bt_anc_op_t op           : operation
+ *   wiced_bt_anc_request_id_t *p_id: set to the request identifier
+ *
+ * Return:
+ *   wiced_bt_gatt_status_t : status of wiced_bt_anc_submit
+ *
+ *******************************************************************************/
+static wiced_bt_gatt_status_t mock_submit(uint16_t conn_id, wiced_bt_anc_op_t op, wiced_bt_anc_request_id_t *p_id)
+{
+    wiced_bt_anc_request_t request;
+
+    memset(&request, 0, sizeof(request));
+    request.op = op;
+    request.cmd_id = ANP_ALERT_CONTROL_CMD_ENABLE_NEW_ALERTS;
+    request.category = ANP_ALERT_CATEGORY_ID_ALL_CONFIGURED;
+    return wiced_bt_anc_submit(conn_id, &request, mock_request_complete, (void *)(uintptr_t)conn_id, p_id);
+}
+
+/*******************************************************************************
+ * Function Name: mock_check_requests()
+ ********************************************************************************
+ * Summary:
+ *   Runs the requests of the asynchronous API on a connection: mixed with a
+ *   command of the application, with a response the client gives up on and
+ *   disconnects for, then on the reconnection pending when the link goes down
+ *
+ * Parameters:
+ *   uint16_t conn_id       : connection id, disconnected on return
+ *
+ * Return:
+ *   None
+ *
+ *******************************************************************************/
+static void mock_check_requests(uint16_t conn_id)
+{
+    wiced_bt_anc_request_id_t ids[3];
+    wiced_bt_anc_setup_stats_t setup_stats;
+    mock_btstack_stats_t base;
+    mock_btstack_stats_t stats;
+    uint64_t control_results;
+    uint64_t start_us;
+
+    mock_btstack_get_stats(&base);
+
+    /* requests are sent one at a time in submission order, the command of the
+     * application waits for the first one and its result goes to the callback */
+    mock_num_completions = 0;
+    control_results = mock_events_delivered(WICED_BT_ANC_CONTROL_ALERTS_RESULT);
+    MOCK_CHECK(mock_submit(conn_id, WICED_BT_ANC_OP_CONTROL_ALERTS, &ids[0]) == WICED_BT_GATT_SUCCESS);
+    MOCK_CHECK(bt_app_handle_usr_cmd(USR_ANC_COMMAND_CONTROL_ALERTS, ANP_ALERT_CONTROL_CMD_ENABLE_UNREAD_STATUS,
+                                     ANP_ALERT_CATEGORY_ID_ALL_CONFIGURED) == WICED_BT_GATT_SUCCESS);
+    MOCK_CHECK(mock_submit(conn_id, WICED_BT_ANC_OP_DISABLE_NEW_ALERTS, &ids[1]) == WICED_BT_GATT_SUCCESS);
+    MOCK_CHECK(mock_submit(conn_id, WICED_BT_ANC_OP_ENABLE_NEW_ALERTS, &ids[2]) == WICED_BT_GATT_SUCCESS);
+    /* a queued request is dropped */
+    MOCK_CHECK(wiced_bt_anc_cancel(ids[2]));
+    MOCK_CHECK(!wiced_bt_anc_cancel(ids[2]));
+    mock_btstack_run();
+    MOCK_CHECK(mock_num_completions == 2);
+    MOCK_CHECK((mock_completions[0].id == ids[0]) && (mock_completions[0].event == WICED_BT_ANC_CONTROL_ALERTS_RESULT) &&
+               (mock_completions[0].status == WICED_BT_GATT_SUCCESS));
+    MOCK_CHECK((mock_completions[1].id == ids[1]) && (mock_completions[1].event == WICED_BT_ANC_DISABLE_NEW_ALERTS_RESULT) &&
+               (mock_completions[1].status == WICED_BT_GATT_SUCCESS));
+    MOCK_CHECK(mock_events_delivered(WICED_BT_ANC_CONTROL_ALERTS_RESULT) == control_results + 1);
+    mock_btstack_get_stats(&stats);
+    MOCK_CHECK(stats.write_req - base.write_req == 3);
+
+    /* the server does not answer: the request fails once at the GATT timeout and the
+     * client takes the link down, the queued request fails with it instead of waiting
+     * for a response that may never come */
+    mock_num_completions = 0;
+    start_us = mock_btstack_now_us();
+    mock_btstack_delay_next_response(conn_id, MOCK_LATE_RESPONSE_US);
+    MOCK_CHECK(mock_submit(conn_id, WICED_BT_ANC_OP_ENABLE_NEW_ALERTS, &ids[0]) == WICED_BT_GATT_SUCCESS);
+    MOCK_CHECK(mock_submit(conn_id, WICED_BT_ANC_OP_CONTROL_ALERTS, &ids[1]) == WICED_BT_GATT_SUCCESS);
+    mock_btstack_run();
+    MOCK_CHECK(mock_num_completions == 2);
+    MOCK_CHECK((mock_completions[0].id == ids[0]) && (mock_completions[0].status == WICED_BT_ANC_GATT_TIMEOUT) &&
+               (mock_completions[0].time_us - start_us >= MOCK_GATT_TIMEOUT_US) &&
+               (mock_completions[0].time_us - start_us < MOCK_LATE_RESPONSE_US));
+    MOCK_CHECK(mock_completions[0].command_status == WICED_BT_GATT_BUSY);
+    MOCK_CHECK((mock_completions[1].id == ids[1]) && (mock_completions[1].status != WICED_BT_GATT_SUCCESS) &&
+               (mock_completions[1].time_us - start_us < MOCK_LATE_RESPONSE_US));
+    MOCK_CHECK(mock_btstack_now_us() - start_us < MOCK_LATE_RESPONSE_US);
+    mock_btstack_get_stats(&stats);
+    MOCK_CHECK(stats.local_disconnects - base.local_disconnects == 1);
+    MOCK_CHECK(stats.busy == base.busy);
+
+    /* the peer connects again, the handles come from the cache and requests go through */
+    mock_btstack_get_stats(&base);
+    conn_id = mock_btstack_connect(mock_peer_addr);
+    mock_btstack_run();
+    MOCK_CHECK(wiced_bt_anc_client_get_setup_stats(conn_id, &setup_stats) && setup_stats.handles_from_cache);
+    MOCK_CHECK(mock_discoveries(&base) == 0);
+    mock_num_completions = 0;
+    MOCK_CHECK(mock_submit(conn_id, WICED_BT_ANC_OP_ENABLE_NEW_ALERTS, &ids[0]) == WICED_BT_GATT_SUCCESS);
+    mock_btstack_run();
+    MOCK_CHECK((mock_num_completions == 1) && (mock_completions[0].id == ids[0]) &&
+               (mock_completions[0].status == WICED_BT_GATT_SUCCESS));
+    mock_btstack_get_stats(&stats);
+    MOCK_CHECK(stats.busy == base.busy);
+
+    /* the link drops with a request on the air and one queued, both fail and
+     * the GATT timeout of the first one goes with the connection */
+    mock_num_completions = 0;
+    start_us = mock_btstack_now_us();
+    mock_btstack_delay_next_response(conn_id, MOCK_LATE_RESPONSE_US);
+    MOCK_CHECK(mock_submit(conn_id, WICED_BT_ANC_OP_DISABLE_NEW_ALERTS, &ids[0]) == WICED_BT_GATT_SUCCESS);
+    MOCK_CHECK(mock_submit(conn_id, WICED_BT_ANC_OP_CONTROL_ALERTS, &ids[1]) == WICED_BT_GATT_SUCCESS);
+    mock_btstack_disconnect(conn_id);
+    mock_btstack_run();
+    MOCK_CHECK(mock_num_completions == 2);
+    MOCK_CHECK((mock_completions[0].id == ids[0]) && (mock_completions[0].status != WICED_BT_GATT_SUCCESS) &&
+               (mock_completions[0].status != WICED_BT_ANC_GATT_TIMEOUT));
+    MOCK_CHECK((mock_completions[1].id == ids[1]) && (mock_completions[1].status != WICED_BT_GATT_SUCCESS));
+    MOCK_CHECK(mock_btstack_now_us() - start_us < MOCK_GATT_TIMEOUT_US);
+}
+
+/*******************************************************************************
+ * Function Name: mock_send_cmd()
+ ********************************************************************************
+ * Summary:
+ *   Sends a user command the way the menu does and runs the stack until it
+ *   completes
+ *
+ * Parameters:
+ *   uint8_t cmd            : bt_app_anc_cmd user command
+ *   uint8_t cmd_id         : control point command id
+ *   uint8_t alert_category : control point alert category
+ *
+ * Return:
+ *   None
+ *
+ *******************************************************************************/
+static void mock_send_cmd(uint8_t cmd, uint8_t cmd_id, uint8_t alert_category)
+{
+    wiced_bt_gatt_status_t status;
+
+    status = bt_app_handle_usr_cmd(cmd, cmd_id, alert_category);
+    if (status != WICED_BT_GATT_SUCCESS)
+    {
+        fprintf(stderr, "Command %u failed. Status: 0x%x\n", cmd, status);
+    }
+    mock_btstack_run();
+}
+
+/*******************************************************************************
+ * Function Name: mock_print_setup_stats()
+ ********************************************************************************
+ * Summary:
+ *   Prints the setup phases of a connection as timed by the ANC library, in
+ *   virtual time
+ *
+ * Parameters:
+ *   uint16_t conn_id       : connection id
+ *
+ * Return:
+ *   None
+ *
+ *******************************************************************************/
+static void mock_print_setup_stats(uint16_t conn_id)
+{
+    wiced_bt_anc_setup_stats_t stats;
+    int phase;
+
+    if (!wiced_bt_anc_client_get_setup_stats(conn_id, &stats))
+    {
+        return;
+    }
+    fprintf(stdout, "\nSetup of conn_id %u%s\n", conn_id, stats.handles_from_cache ? ", handles from cache" : "");
+    for (phase = 0; phase < WICED_BT_ANC_NUM_PHASES; phase++)
+    {
+        fprintf(stdout, "  %-20s %8u us %3u requests\n", mock_setup_phase_names[phase],
+                stats.duration_us[phase], stats.num_requests[phase]);
+    }
+    fprintf(stdout, "  time to subscribed   %8u us\n", stats.time_to_subscribed_us);
+}
+
+/*******************************************************************************
+ * Function Name: main()
+ ********************************************************************************
+ * Summary:
+ *   Application entry function
+ *
+ * Parameters:
+ *   int argc            : argument count
+ *   char *argv[]        : list of arguments
+ *
+ * Return:
+ *   None
+ *
+ *******************************************************************************/
+int main(int argc, char *argv[])
+{
+    unsigned int num_alerts = MOCK_DEFAULT_NUM_ALERTS;
+    uint16_t new_alert_handle;
+    uint16_t unread_alert_handle;
+    uint16_t conn_id;
+    uint8_t alert[32];
+    uint8_t range[4];
+    mock_btstack_stats_t stats;
+    mock_btstack_stats_t base;
+    wiced_bt_anc_setup_stats_t setup_stats;
+    wiced_bt_anc_handle_cache_t handles;
+    uint64_t new_alerts;
+    uint64_t unread_alerts;
+    uint32_t consumed;
+    uint32_t dropped;
+    unsigned int i;
+    int len;
+
+    if (argc > 1)
+    {
+        num_alerts = (unsigned int)strtoul(argv[1], NULL, 0);
+    }
+
+    application_start();
+    mock_btstack_run();
+
+    bt_app_anc_start_advertisement();
+    mock_btstack_run();
+
+    /* CCCD writes fail until the link is encrypted, which makes the client pair */
+    mock_btstack_set_require_encryption(WICED_TRUE);
+    conn_id = mock_btstack_connect(mock_peer_addr);
+    mock_btstack_run();
+
+    mock_send_cmd(USR_ANC_COMMAND_READ_SERVER_SUPPORTED_CATEGORIES, 0, 0);
+    /* answered from the categories kept by the library, no read */
+    mock_send_cmd(USR_ANC_COMMAND_READ_SERVER_SUPPORTED_NEW_ALERTS, 0, 0);
+    mock_send_cmd(USR_ANC_COMMAND_ENABLE_NTF_NEW_ALERTS, 0, 0);
+    mock_send_cmd(USR_ANC_COMMAND_ENABLE_NTF_UNREAD_ALERT_STATUS, 0, 0);
+    /* the first CCCD write was rejected and started pairing, a command rejected
+     * by the peer is not replayed by the application */
+    mock_send_cmd(USR_ANC_COMMAND_ENABLE_NTF_NEW_ALERTS, 0, 0);
+    mock_send_cmd(USR_ANC_COMMAND_CONTROL_ALERTS, ANP_ALERT_CONTROL_CMD_ENABLE_NEW_ALERTS, ANP_ALERT_CATEGORY_ID_ALL_CONFIGURED);
+    mock_send_cmd(USR_ANC_COMMAND_CONTROL_ALERTS, ANP_ALERT_CONTROL_CMD_ENABLE_UNREAD_STATUS, ANP_ALERT_CATEGORY_ID_ALL_CONFIGURED);
+
+    /* discovered from scratch, then subscribed to both alerts: the ANS and the
+     * GATT service, their characteristics, then the CCCDs of New Alert, of
+     * Service Changed and, when it is enabled, of Unread Alert Status */
+    MOCK_CHECK(wiced_bt_anc_client_get_setup_stats(conn_id, &setup_stats) &&
+               !setup_stats.handles_from_cache && (setup_stats.time_to_subscribed_us != 0));
+    mock_btstack_get_stats(&stats);
+    MOCK_CHECK(stats.discover_services == 2);
+    MOCK_CHECK(stats.discover_characteristics == 2);
+    MOCK_CHECK(stats.discover_descriptors == 3);
+    MOCK_CHECK(stats.read_multiple == 1);
+    MOCK_CHECK(stats.busy == 0);
+
+    new_alert_handle = mock_btstack_find_value_handle(UUID_CHARACTERISTIC_NEW_ALERT);
+    unread_alert_handle = mock_btstack_find_value_handle(UUID_CHARACTERISTIC_UNREAD_ALERT_STATUS);
+    new_alerts = mock_events_delivered(WICED_BT_ANC_EVENT_NEW_ALERT_NOTIFICATION);
+    unread_alerts = mock_events_delivered(WICED_BT_ANC_EVENT_UNREAD_ALERT_NOTIFICATION);
+    for (i = 0; i < num_alerts; i++)
+    {
+        /* category id, count, then the text */
+        alert[0] = i % MOCK_NUM_ALERT_CATEGORIES;
+        alert[1] = 1;
+        len = snprintf((char *)&alert[2], sizeof(alert) - 2, "Alert %u", i);
+        MOCK_CHECK(mock_btstack_notify(conn_id, new_alert_handle, alert, (uint16_t)(len + 2)));
+        MOCK_CHECK(mock_btstack_notify(conn_id, unread_alert_handle, alert, 2));
+        mock_btstack_run();
+    }
+    MOCK_CHECK(mock_events_delivered(WICED_BT_ANC_EVENT_NEW_ALERT_NOTIFICATION) == new_alerts + num_alerts);
+    MOCK_CHECK(mock_events_delivered(WICED_BT_ANC_EVENT_UNREAD_ALERT_NOTIFICATION) == unread_alerts + num_alerts);
+
+    mock_print_setup_stats(conn_id);
+    mock_btstack_disconnect(conn_id);
+    mock_btstack_run();
+
+    /* reconnection of the bonded peer, the handles come from the cache */
+    mock_btstack_get_stats(&base);
+    conn_id = mock_btstack_connect(mock_peer_addr);
+    mock_btstack_run();
+    mock_send_cmd(USR_ANC_COMMAND_ENABLE_NTF_NEW_ALERTS, 0, 0);
+    mock_print_setup_stats(conn_id);
+    MOCK_CHECK(wiced_bt_anc_client_get_setup_stats(conn_id, &setup_stats) && setup_stats.handles_from_cache);
+    MOCK_CHECK(mock_discoveries(&base) == 0);
+    /* a peer without Read Multiple, the categories are read one by one */
+    mock_btstack_set_read_multiple_supported(WICED_FALSE);
+    mock_btstack_get_stats(&base);
+    mock_send_cmd(USR_ANC_COMMAND_READ_SERVER_SUPPORTED_CATEGORIES, 0, 0);
+    mock_btstack_get_stats(&stats);
+    MOCK_CHECK(stats.read_multiple - base.read_multiple == 1);
+    MOCK_CHECK(stats.read_handle - base.read_handle == 2);
+    /* read again, the cached answer is given from the stack and not from the call */
+    unread_alerts = mock_events_delivered(WICED_BT_ANC_READ_SUPPORTED_UNREAD_ALERTS_RESULT);
+    MOCK_CHECK(bt_app_handle_usr_cmd(USR_ANC_COMMAND_READ_SERVER_SUPPORTED_CATEGORIES, 0, 0) == WICED_BT_GATT_SUCCESS);
+    MOCK_CHECK(mock_events_delivered(WICED_BT_ANC_READ_SUPPORTED_UNREAD_ALERTS_RESULT) == unread_alerts);
+    mock_btstack_run();
+    MOCK_CHECK(mock_events_delivered(WICED_BT_ANC_READ_SUPPORTED_UNREAD_ALERTS_RESULT) == unread_alerts + 1);
+    mock_btstack_get_stats(&base);
+    MOCK_CHECK(base.read_handle == stats.read_handle);
+    /* Service Changed over the New Alert characteristic, only it is discovered
+     * again and its notifications enabled again */
+    range[0] = (uint8_t)(new_alert_handle - 1);
+    range[1] = (uint8_t)((new_alert_handle - 1) >> 8);
+    range[2] = (uint8_t)(new_alert_handle + 1);
+    range[3] = (uint8_t)((new_alert_handle + 1) >> 8);
+    mock_btstack_get_stats(&base);
+    MOCK_CHECK(mock_btstack_notify(conn_id, MOCK_BTSTACK_SERVICE_CHANGED_VALUE_HANDLE, range, sizeof(range)));
+    mock_btstack_run();
+    mock_btstack_get_stats(&stats);
+    MOCK_CHECK(stats.discover_services == base.discover_services);
+    MOCK_CHECK(stats.discover_characteristics - base.discover_characteristics == 1);
+    MOCK_CHECK(stats.write_req - base.write_req == 1);
+    MOCK_CHECK(wiced_bt_anc_get_handle_cache(conn_id, &handles) &&
+               (handles.new_alert_char_value_handle == new_alert_handle) &&
+               (handles.unread_alert_char_value_handle == unread_alert_handle));
+    new_alerts = mock_events_delivered(WICED_BT_ANC_EVENT_NEW_ALERT_NOTIFICATION);
+    len = snprintf((char *)&alert[2], sizeof(alert) - 2, "After Service Changed");
+    MOCK_CHECK(mock_btstack_notify(conn_id, new_alert_handle, alert, (uint16_t)(len + 2)));
+    mock_btstack_run();
+    MOCK_CHECK(mock_events_delivered(WICED_BT_ANC_EVENT_NEW_ALERT_NOTIFICATION) == new_alerts + 1);
+    mock_btstack_disconnect(conn_id);
+    mock_btstack_run();
+
+    /* the peer moved its ANS, e.g. after a firmware update: its Database Hash no
+     * longer matches the saved handles and the client discovers it again */
+    mock_btstack_set_layout(MOCK_BTSTACK_ANS_SERVICE_HANDLE + 0x10, 2);
+    new_alert_handle = mock_btstack_find_value_handle(UUID_CHARACTERISTIC_NEW_ALERT);
+    mock_btstack_get_stats(&base);
+    conn_id = mock_btstack_connect(mock_peer_addr);
+    mock_btstack_run();
+    mock_send_cmd(USR_ANC_COMMAND_ENABLE_NTF_NEW_ALERTS, 0, 0);
+    mock_print_setup_stats(conn_id);
+    MOCK_CHECK(wiced_bt_anc_client_get_setup_stats(conn_id, &setup_stats) && !setup_stats.handles_from_cache);
+    MOCK_CHECK(mock_discoveries(&base) != 0);
+    MOCK_CHECK(wiced_bt_anc_get_handle_cache(conn_id, &handles) &&
+               (handles.anc_s_handle == MOCK_BTSTACK_ANS_SERVICE_HANDLE + 0x10) &&
+               (handles.new_alert_char_value_handle == new_alert_handle));
+    new_alerts = mock_events_delivered(WICED_BT_ANC_EVENT_NEW_ALERT_NOTIFICATION);
+    MOCK_CHECK(mock_btstack_notify(conn_id, new_alert_handle, alert, (uint16_t)(len + 2)));
+    mock_btstack_run();
+    MOCK_CHECK(mock_events_delivered(WICED_BT_ANC_EVENT_NEW_ALERT_NOTIFICATION) == new_alerts + 1);
+    mock_btstack_disconnect(conn_id);
+    mock_btstack_run();
+
+    /* a peer that is not bonded discovers the ANS in between, its handles are
+     * not saved and do not hide the ones of the bonded peer */
+    mock_btstack_set_require_encryption(WICED_FALSE);
+    conn_id = mock_btstack_connect(mock_guest_addr);
+    mock_btstack_run();
+    mock_send_cmd(USR_ANC_COMMAND_ENABLE_NTF_NEW_ALERTS, 0, 0);
+    MOCK_CHECK(wiced_bt_anc_client_get_setup_stats(conn_id, &setup_stats) && !setup_stats.handles_from_cache);
+    mock_btstack_disconnect(conn_id);
+    mock_btstack_run();
+    mock_btstack_set_require_encryption(WICED_TRUE);
+    /* the handles of the bonded peer are read back from the NVRAM */
+    usleep(MOCK_DRAIN_TIME_US);
+
+    /* requests of the asynchronous API on the reconnection of the bonded peer */
+    mock_btstack_get_stats(&base);
+    conn_id = mock_btstack_connect(mock_peer_addr);
+    mock_btstack_run();
+    MOCK_CHECK(wiced_bt_anc_client_get_setup_stats(conn_id, &setup_stats) && setup_stats.handles_from_cache);
+    MOCK_CHECK(mock_discoveries(&base) == 0);
+    mock_check_requests(conn_id);
+
+    usleep(MOCK_DRAIN_TIME_US);
+    bt_app_anc_get_event_stats(&consumed, &dropped);
+    MOCK_CHECK(dropped == 0);
+
+    mock_btstack_get_stats(&stats);
+    fprintf(stdout, "\nVirtual time: %llu us\n", (unsigned long long)mock_btstack_now_us());
+    fprintf(stdout, "ATT requests: discover services %u characteristics %u descriptors %u\n",
+            stats.discover_services, stats.discover_characteristics, stats.discover_descriptors);
+    fprintf(stdout, "              read %u read by type %u read multiple %u\n",
+            stats.read_handle, stats.read_by_type, stats.read_multiple);
+    fprintf(stdout, "              write %u write cmd %u mtu %u busy %u\n",
+            stats.write_req, stats.write_cmd, stats.config_mtu, stats.busy);
+    fprintf(stdout, "Notifications: %u\n", stats.notifications);
+    bt_app_anc_print_latency();
+
+    wiced_bt_delete_heap(p_default_heap);
+    wiced_bt_stack_deinit();
+
+    if (mock_failed_checks != 0)
+    {
+        fprintf(stderr, "%u checks failed\n", mock_failed_checks);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
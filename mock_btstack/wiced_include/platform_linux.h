@@ -0,0 +1,6 @@
+/*
+ * Stand-in for the bluetooth-linux porting layer platform_linux.h.
+ */
+#pragma once
+
+#include <pthread.h>
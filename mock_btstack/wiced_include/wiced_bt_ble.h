@@ -0,0 +1,77 @@
+/*
+ * Stand-in for the AIROC BTSTACK wiced_bt_ble.h (subset).
+ */
+#pragma once
+
+#include "wiced_bt_types.h"
+#include "wiced_result.h"
+
+#define BTM_BLE_LIMITED_DISCOVERABLE_FLAG   (0x01 << 0)
+#define BTM_BLE_GENERAL_DISCOVERABLE_FLAG   (0x01 << 1)
+#define BTM_BLE_BREDR_NOT_SUPPORTED         (0x01 << 2)
+
+#define BTM_BLE_ADVERT_CHNL_37  (0x01 << 0)
+#define BTM_BLE_ADVERT_CHNL_38  (0x01 << 1)
+#define BTM_BLE_ADVERT_CHNL_39  (0x01 << 2)
+
+typedef enum
+{
+    BTM_BLE_ADVERT_TYPE_FLAG            = 0x01,
+    BTM_BLE_ADVERT_TYPE_NAME_SHORT      = 0x08,
+    BTM_BLE_ADVERT_TYPE_NAME_COMPLETE   = 0x09,
+    BTM_BLE_ADVERT_TYPE_TX_POWER        = 0x0A,
+    BTM_BLE_ADVERT_TYPE_APPEARANCE      = 0x19,
+    BTM_BLE_ADVERT_TYPE_LE_BD_ADDR      = 0x1B,
+    BTM_BLE_ADVERT_TYPE_LE_ROLE         = 0x1C,
+} wiced_bt_ble_advert_type_t;
+
+typedef struct
+{
+    uint8_t     *p_data;
+    uint16_t    len;
+    wiced_bt_ble_advert_type_t advert_type;
+} wiced_bt_ble_advert_elem_t;
+
+typedef enum
+{
+    BTM_BLE_ADVERT_OFF,
+    BTM_BLE_ADVERT_DIRECTED_HIGH,
+    BTM_BLE_ADVERT_DIRECTED_LOW,
+    BTM_BLE_ADVERT_UNDIRECTED_HIGH,
+    BTM_BLE_ADVERT_UNDIRECTED_LOW,
+    BTM_BLE_ADVERT_NONCONN_HIGH,
+    BTM_BLE_ADVERT_NONCONN_LOW,
+    BTM_BLE_ADVERT_DISCOVERABLE_HIGH,
+    BTM_BLE_ADVERT_DISCOVERABLE_LOW,
+} wiced_bt_ble_advert_mode_t;
+
+typedef enum
+{
+    BTM_BLE_SCAN_TYPE_NONE,
+    BTM_BLE_SCAN_TYPE_HIGH_DUTY,
+    BTM_BLE_SCAN_TYPE_LOW_DUTY,
+} wiced_bt_ble_scan_type_t;
+
+typedef enum
+{
+    BTM_BLE_SEC_NONE,
+    BTM_BLE_SEC_ENCRYPT,
+    BTM_BLE_SEC_ENCRYPT_NO_MITM,
+    BTM_BLE_SEC_ENCRYPT_MITM,
+} wiced_bt_ble_sec_action_type_t;
+
+typedef struct
+{
+    uint8_t     status;
+    wiced_bt_device_address_t bd_addr;
+    uint16_t    conn_interval;
+    uint16_t    conn_latency;
+    uint16_t    supervision_timeout;
+} wiced_bt_ble_connection_param_update_t;
+
+wiced_result_t wiced_bt_ble_set_raw_advertisement_data(uint8_t num_elem,
+                                                       wiced_bt_ble_advert_elem_t *p_data);
+wiced_result_t wiced_bt_start_advertisements(wiced_bt_ble_advert_mode_t advert_mode,
+                                             wiced_bt_ble_address_type_t directed_advertisement_bdaddr_type,
+                                             wiced_bt_device_address_t directed_advertisement_bdaddr_ptr);
+void wiced_bt_ble_security_grant(wiced_bt_device_address_t bd_addr, uint8_t res);
@@ -0,0 +1,12 @@
+/*
+ * Stand-in for the AIROC BTSTACK wiced_bt_cfg.h.  Only the fields the ANC
+ * application reads are modelled.
+ */
+#pragma once
+
+#include "wiced_bt_types.h"
+
+typedef struct
+{
+    uint8_t     *device_name;
+} wiced_bt_cfg_settings_t;
@@ -0,0 +1,4 @@
+/*
+ * Stand-in for the AIROC BTSTACK wiced_bt_constants.h.
+ */
+#pragma once
@@ -0,0 +1,136 @@
+/*
+ * Stand-in for the AIROC BTSTACK wiced_bt_dev.h (subset).
+ */
+#pragma once
+
+#include "wiced_bt_types.h"
+#include "wiced_result.h"
+#include "wiced_bt_ble.h"
+
+typedef enum
+{
+    BTM_ENABLED_EVT,
+    BTM_DISABLED_EVT,
+    BTM_POWER_MANAGEMENT_STATUS_EVT,
+    BTM_PIN_REQUEST_EVT,
+    BTM_USER_CONFIRMATION_REQUEST_EVT,
+    BTM_PASSKEY_NOTIFICATION_EVT,
+    BTM_PASSKEY_REQUEST_EVT,
+    BTM_KEYPRESS_NOTIFICATION_EVT,
+    BTM_PAIRING_IO_CAPABILITIES_BR_EDR_REQUEST_EVT,
+    BTM_PAIRING_IO_CAPABILITIES_BR_EDR_RESPONSE_EVT,
+    BTM_PAIRING_IO_CAPABILITIES_BLE_REQUEST_EVT,
+    BTM_PAIRING_COMPLETE_EVT,
+    BTM_ENCRYPTION_STATUS_EVT,
+    BTM_SECURITY_REQUEST_EVT,
+    BTM_SECURITY_FAILED_EVT,
+    BTM_SECURITY_ABORTED_EVT,
+    BTM_READ_LOCAL_OOB_DATA_COMPLETE_EVT,
+    BTM_REMOTE_OOB_DATA_REQUEST_EVT,
+    BTM_PAIRED_DEVICE_LINK_KEYS_UPDATE_EVT,
+    BTM_PAIRED_DEVICE_LINK_KEYS_REQUEST_EVT,
+    BTM_LOCAL_IDENTITY_KEYS_UPDATE_EVT,
+    BTM_LOCAL_IDENTITY_KEYS_REQUEST_EVT,
+    BTM_BLE_SCAN_STATE_CHANGED_EVT,
+    BTM_BLE_ADVERT_STATE_CHANGED_EVT,
+    BTM_SMP_REMOTE_OOB_DATA_REQUEST_EVT,
+    BTM_SMP_SC_REMOTE_OOB_DATA_REQUEST_EVT,
+    BTM_SMP_SC_LOCAL_OOB_DATA_NOTIFICATION_EVT,
+    BTM_SCO_CONNECTED_EVT,
+    BTM_SCO_DISCONNECTED_EVT,
+    BTM_SCO_CONNECTION_REQUEST_EVT,
+    BTM_SCO_CONNECTION_CHANGE_EVT,
+    BTM_BLE_CONNECTION_PARAM_UPDATE,
+    BTM_BLE_PHY_UPDATE_EVT,
+} wiced_bt_management_evt_t;
+
+typedef enum
+{
+    SMP_SUCCESS                 = 0,
+    SMP_PASSKEY_ENTRY_FAIL      = 0x01,
+    SMP_OOB_FAIL                = 0x02,
+    SMP_PAIR_AUTH_FAIL          = 0x03,
+    SMP_CONFIRM_VALUE_ERR       = 0x04,
+    SMP_PAIR_NOT_SUPPORT        = 0x05,
+    SMP_ENC_KEY_SIZE            = 0x06,
+    SMP_INVALID_CMD             = 0x07,
+    SMP_PAIR_FAIL_UNKNOWN       = 0x08,
+    SMP_REPEATED_ATTEMPTS       = 0x09,
+    SMP_INVALID_PARAMETERS      = 0x0A,
+    SMP_DHKEY_CHK_FAIL          = 0x0B,
+    SMP_NUMERIC_COMPAR_FAIL     = 0x0C,
+    SMP_BR_PAIRING_IN_PROGR     = 0x0D,
+    SMP_XTRANS_DERIVE_NOT_ALLOW = 0x0E,
+    SMP_PAIR_INTERNAL_ERR,
+    SMP_UNKNOWN_IO_CAP,
+    SMP_INIT_FAIL,
+    SMP_CONFIRM_FAIL,
+    SMP_BUSY,
+    SMP_ENC_FAIL,
+    SMP_STARTED,
+    SMP_RSP_TIMEOUT,
+    SMP_FAIL,
+    SMP_CONN_TOUT,
+} wiced_bt_smp_status_t;
+
+#define BTM_IO_CAPABILITIES_NONE    3
+#define BTM_OOB_NONE                0
+#define BTM_LE_AUTH_REQ_SC_BOND     0x09
+#define BTM_LE_KEY_PENC             (1 << 0)
+#define BTM_LE_KEY_PID              (1 << 1)
+#define BTM_LE_KEY_PCSRK            (1 << 2)
+#define BTM_LE_KEY_LENC             (1 << 3)
+#define BTM_SEC_BEST_EFFORT         0
+
+typedef struct
+{
+    wiced_bt_device_address_t   bd_addr;
+    uint8_t                     key_data[128];
+} wiced_bt_device_link_keys_t;
+
+typedef struct
+{
+    uint8_t                     local_key_data[80];
+} wiced_bt_local_identity_keys_t;
+
+typedef union
+{
+    struct { wiced_result_t status; } enabled;
+    struct { wiced_bt_device_address_t bd_addr; uint32_t numeric_value; } user_confirmation_request;
+    struct { wiced_bt_device_address_t bd_addr; uint32_t passkey; } user_passkey_notification;
+    struct
+    {
+        wiced_bt_device_address_t bd_addr;
+        uint8_t local_io_cap;
+        uint8_t oob_data;
+        uint8_t auth_req;
+        uint8_t max_key_size;
+        uint8_t init_keys;
+        uint8_t resp_keys;
+    } pairing_io_capabilities_ble_request;
+    struct
+    {
+        uint8_t *bd_addr;
+        union { struct { uint8_t reason; } ble; } pairing_complete_info;
+    } pairing_complete;
+    struct { uint8_t *bd_addr; wiced_result_t result; } encryption_status;
+    struct { wiced_bt_device_address_t bd_addr; } security_request;
+    wiced_bt_device_link_keys_t     paired_device_link_keys_update;
+    wiced_bt_device_link_keys_t     paired_device_link_keys_request;
+    wiced_bt_local_identity_keys_t  local_identity_keys_update;
+    wiced_bt_local_identity_keys_t  local_identity_keys_request;
+    wiced_bt_ble_scan_type_t        ble_scan_state_changed;
+    wiced_bt_ble_advert_mode_t      ble_advert_state_changed;
+    wiced_bt_ble_connection_param_update_t ble_connection_param_update;
+} wiced_bt_management_evt_data_t;
+
+typedef wiced_result_t (wiced_bt_management_cback_t)(wiced_bt_management_evt_t event,
+                                                     wiced_bt_management_evt_data_t *p_event_data);
+
+void wiced_bt_set_pairable_mode(uint8_t allow_pairing, uint8_t connect_only_paired);
+wiced_result_t wiced_bt_dev_add_device_to_address_resolution_db(wiced_bt_device_link_keys_t *p_link_keys);
+wiced_result_t wiced_bt_set_local_bdaddr(wiced_bt_device_address_t bda, wiced_bt_ble_address_type_t addr_type);
+void wiced_bt_dev_read_local_addr(wiced_bt_device_address_t bd_addr);
+wiced_result_t wiced_bt_dev_confirm_req_reply(wiced_result_t res, wiced_bt_device_address_t bd_addr);
+wiced_result_t wiced_bt_dev_sec_bond(wiced_bt_device_address_t bd_addr, wiced_bt_ble_address_type_t bd_addr_type,
+                                     wiced_bt_transport_t transport, uint8_t pin_len, uint8_t *p_pin);
@@ -0,0 +1,258 @@
+/*
+ * Stand-in for the AIROC BTSTACK wiced_bt_gatt.h, covering the GATT client
+ * surface used by the ANC example and library.
+ */
+#pragma once
+
+#include "wiced_bt_types.h"
+#include "wiced_result.h"
+
+typedef enum
+{
+    WICED_BT_GATT_SUCCESS                    = 0x00,
+    WICED_BT_GATT_INVALID_HANDLE             = 0x01,
+    WICED_BT_GATT_READ_NOT_PERMIT            = 0x02,
+    WICED_BT_GATT_WRITE_NOT_PERMIT           = 0x03,
+    WICED_BT_GATT_INVALID_PDU                = 0x04,
+    WICED_BT_GATT_INSUF_AUTHENTICATION       = 0x05,
+    WICED_BT_GATT_REQ_NOT_SUPPORTED          = 0x06,
+    WICED_BT_GATT_INVALID_OFFSET             = 0x07,
+    WICED_BT_GATT_INSUF_AUTHORIZATION        = 0x08,
+    WICED_BT_GATT_PREPARE_Q_FULL             = 0x09,
+    WICED_BT_GATT_ATTRIBUTE_NOT_FOUND        = 0x0a,
+    WICED_BT_GATT_NOT_LONG                   = 0x0b,
+    WICED_BT_GATT_INSUF_KEY_SIZE             = 0x0c,
+    WICED_BT_GATT_INVALID_ATTR_LEN           = 0x0d,
+    WICED_BT_GATT_ERR_UNLIKELY               = 0x0e,
+    WICED_BT_GATT_INSUF_ENCRYPTION           = 0x0f,
+    WICED_BT_GATT_UNSUPPORT_GRP_TYPE         = 0x10,
+    WICED_BT_GATT_INSUF_RESOURCE             = 0x11,
+    WICED_BT_GATT_DATABASE_OUT_OF_SYNC       = 0x12,
+    WICED_BT_GATT_VALUE_NOT_ALLOWED          = 0x13,
+    WICED_BT_GATT_ILLEGAL_PARAMETER          = 0x87,
+    WICED_BT_GATT_NO_RESOURCES               = 0x80,
+    WICED_BT_GATT_INTERNAL_ERROR             = 0x81,
+    WICED_BT_GATT_WRONG_STATE                = 0x82,
+    WICED_BT_GATT_DB_FULL                    = 0x83,
+    WICED_BT_GATT_BUSY                       = 0x84,
+    WICED_BT_GATT_ERROR                      = 0x85,
+    WICED_BT_GATT_CMD_STARTED                = 0x86,
+    WICED_BT_GATT_PENDING                    = 0x88,
+    WICED_BT_GATT_AUTH_FAIL                  = 0x89,
+    WICED_BT_GATT_MORE                       = 0x8a,
+    WICED_BT_GATT_INVALID_CFG                = 0x8b,
+    WICED_BT_GATT_SERVICE_STARTED            = 0x8c,
+    WICED_BT_GATT_ENCRYPTED_MITM             = WICED_BT_GATT_SUCCESS,
+    WICED_BT_GATT_ENCRYPTED_NO_MITM          = 0x8d,
+    WICED_BT_GATT_NOT_ENCRYPTED              = 0x8e,
+    WICED_BT_GATT_CONGESTED                  = 0x8f,
+    WICED_BT_GATT_WRITE_REQ_REJECTED         = 0xFC,
+    WICED_BT_GATT_CCC_CFG_ERR                = 0xFD,
+    WICED_BT_GATT_PRC_IN_PROGRESS            = 0xFE,
+    WICED_BT_GATT_OUT_OF_RANGE               = 0xFF,
+} wiced_bt_gatt_status_t;
+
+typedef enum
+{
+    GATT_REQ_READ_BY_TYPE       = 0x08,
+    GATT_REQ_READ               = 0x0A,
+    GATT_REQ_READ_MULTI         = 0x0E,
+    GATT_REQ_WRITE              = 0x12,
+    GATT_CMD_WRITE              = 0x52,
+    GATT_REQ_READ_MULTI_VAR_LENGTH = 0x20,
+} wiced_bt_gatt_opcode_t;
+
+typedef enum
+{
+    GATT_AUTH_REQ_NONE              = 0,
+    GATT_AUTH_REQ_NO_MITM           = 1,
+    GATT_AUTH_REQ_MITM              = 2,
+    GATT_AUTH_REQ_SIGNED_NO_MITM    = 3,
+    GATT_AUTH_REQ_SIGNED_MITM       = 4,
+} wiced_bt_gatt_auth_req_t;
+
+#define GATT_MAX_ATTR_LEN                   512     /* As defined in the spec */
+#define GATT_DEF_BLE_MTU_SIZE               23
+
+#define GATT_CLIENT_CONFIG_NONE             0x0000
+#define GATT_CLIENT_CONFIG_NOTIFICATION     0x0001
+#define GATT_CLIENT_CONFIG_INDICATION       0x0002
+
+typedef enum
+{
+    GATT_DISCOVER_SERVICES_ALL = 1,
+    GATT_DISCOVER_SERVICES_BY_UUID,
+    GATT_DISCOVER_INCLUDED_SERVICES,
+    GATT_DISCOVER_CHARACTERISTICS,
+    GATT_DISCOVER_CHARACTERISTIC_DESCRIPTORS,
+    GATT_DISCOVER_MAX
+} wiced_bt_gatt_discovery_type_t;
+
+typedef enum
+{
+    GATTC_OPTYPE_NONE           = 0,
+    GATTC_OPTYPE_DISCOVERY      = 1,
+    GATTC_OPTYPE_READ_HANDLE    = 2,
+    GATTC_OPTYPE_READ_BY_TYPE   = 3,
+    GATTC_OPTYPE_READ_MULTIPLE  = 4,
+    GATTC_OPTYPE_WRITE_WITH_RSP = 5,
+    GATTC_OPTYPE_WRITE_NO_RSP   = 6,
+    GATTC_OPTYPE_PREPARE_WRITE  = 7,
+    GATTC_OPTYPE_EXECUTE_WRITE  = 8,
+    GATTC_OPTYPE_CONFIG_MTU     = 9,
+    GATTC_OPTYPE_NOTIFICATION   = 10,
+    GATTC_OPTYPE_INDICATION     = 11,
+} wiced_bt_gatt_optype_t;
+
+typedef enum
+{
+    GATT_CONN_UNKNOWN               = 0,
+    GATT_CONN_L2C_FAILURE           = 1,
+    GATT_CONN_TIMEOUT               = 0x08,
+    GATT_CONN_TERMINATE_PEER_USER   = 0x13,
+    GATT_CONN_TERMINATE_LOCAL_HOST  = 0x16,
+    GATT_CONN_FAIL_ESTABLISH        = 0x3E,
+    GATT_CONN_LMP_TIMEOUT           = 0x22,
+    GATT_CONN_CANCEL                = 0x0100,
+} wiced_bt_gatt_disconn_reason_t;
+
+typedef enum
+{
+    GATT_CONNECTION_STATUS_EVT,
+    GATT_OPERATION_CPLT_EVT,
+    GATT_DISCOVERY_RESULT_EVT,
+    GATT_DISCOVERY_CPLT_EVT,
+    GATT_ATTRIBUTE_REQUEST_EVT,
+    GATT_CONGESTION_EVT,
+    GATT_GET_RESPONSE_BUFFER_EVT,
+    GATT_APP_BUFFER_TRANSMITTED_EVT,
+} wiced_bt_gatt_evt_t;
+
+typedef struct
+{
+    uint16_t    handle;
+    uint16_t    len;
+    uint16_t    offset;
+    uint8_t     *p_data;
+} wiced_bt_gatt_data_t;
+
+typedef struct
+{
+    uint16_t                    handle;
+    uint16_t                    offset;
+    uint16_t                    len;
+    wiced_bt_gatt_auth_req_t    auth_req;
+} wiced_bt_gatt_write_hdr_t;
+
+typedef union
+{
+    wiced_bt_gatt_data_t    att_value;
+    uint16_t                mtu;
+    uint16_t                handle;
+} wiced_bt_gatt_operation_complete_rsp_t;
+
+typedef struct
+{
+    uint16_t                                conn_id;
+    wiced_bt_gatt_optype_t                  op;
+    wiced_bt_gatt_status_t                  status;
+    uint8_t                                 pending_events;
+    wiced_bt_gatt_operation_complete_rsp_t  response_data;
+} wiced_bt_gatt_operation_complete_t;
+
+typedef struct
+{
+    wiced_bt_uuid_t uuid;
+    uint16_t        s_handle;
+    uint16_t        e_handle;
+} wiced_bt_gatt_discovery_param_t;
+
+typedef struct
+{
+    uint16_t        handle;
+    uint16_t        s_handle;
+    uint16_t        e_handle;
+    wiced_bt_uuid_t service_type;
+} wiced_bt_gatt_included_service_t;
+
+typedef struct
+{
+    uint16_t        s_handle;
+    uint16_t        e_handle;
+    wiced_bt_uuid_t service_type;
+} wiced_bt_gatt_group_value_t;
+
+typedef struct
+{
+    uint16_t        handle;
+    uint8_t         characteristic_properties;
+    uint16_t        val_handle;
+    wiced_bt_uuid_t char_uuid;
+} wiced_bt_gatt_char_declaration_t;
+
+typedef struct
+{
+    wiced_bt_uuid_t type;
+    uint16_t        handle;
+} wiced_bt_gatt_char_descr_info_t;
+
+typedef union
+{
+    wiced_bt_gatt_included_service_t    included_service;
+    wiced_bt_gatt_group_value_t         group_value;
+    wiced_bt_gatt_char_declaration_t    characteristic_declaration;
+    wiced_bt_gatt_char_descr_info_t     char_descr_info;
+} wiced_bt_gatt_discovery_data_t;
+
+typedef struct
+{
+    uint16_t                        conn_id;
+    wiced_bt_gatt_discovery_type_t  discovery_type;
+    wiced_bt_gatt_discovery_data_t  discovery_data;
+} wiced_bt_gatt_discovery_result_t;
+
+typedef struct
+{
+    uint16_t                        conn_id;
+    wiced_bt_gatt_discovery_type_t  discovery_type;
+    wiced_bt_gatt_status_t          status;
+} wiced_bt_gatt_discovery_complete_t;
+
+typedef struct
+{
+    uint8_t                         *bd_addr;
+    wiced_bt_ble_address_type_t     addr_type;
+    uint16_t                        conn_id;
+    wiced_bool_t                    connected;
+    wiced_bt_gatt_disconn_reason_t  reason;
+    wiced_bt_transport_t            transport;
+    uint8_t                         link_role;
+} wiced_bt_gatt_connection_status_t;
+
+typedef union
+{
+    wiced_bt_gatt_connection_status_t   connection_status;
+    wiced_bt_gatt_operation_complete_t  operation_complete;
+    wiced_bt_gatt_discovery_result_t    discovery_result;
+    wiced_bt_gatt_discovery_complete_t  discovery_complete;
+} wiced_bt_gatt_event_data_t;
+
+typedef wiced_bt_gatt_status_t (wiced_bt_gatt_cback_t)(wiced_bt_gatt_evt_t event,
+                                                       wiced_bt_gatt_event_data_t *p_event_data);
+
+wiced_bt_gatt_status_t wiced_bt_gatt_register(wiced_bt_gatt_cback_t *p_gatt_cback);
+wiced_bt_gatt_status_t wiced_bt_gatt_client_send_discover(uint16_t conn_id,
+        wiced_bt_gatt_discovery_type_t discovery_type, wiced_bt_gatt_discovery_param_t *p_discovery_param);
+wiced_bt_gatt_status_t wiced_bt_gatt_client_send_read_handle(uint16_t conn_id, uint16_t handle,
+        uint16_t offset, void *p_read_buf, uint16_t len, wiced_bt_gatt_auth_req_t auth_req);
+wiced_bt_gatt_status_t wiced_bt_gatt_client_send_read_by_type(uint16_t conn_id, uint16_t s_handle,
+        uint16_t e_handle, wiced_bt_uuid_t *p_uuid, uint8_t *p_read_buf, uint16_t len,
+        wiced_bt_gatt_auth_req_t auth_req);
+wiced_bt_gatt_status_t wiced_bt_gatt_client_send_read_multiple(uint16_t conn_id,
+        wiced_bt_gatt_opcode_t opcode, uint16_t *p_handle_list, int num_handles,
+        uint8_t *p_read_buf, uint16_t len, wiced_bt_gatt_auth_req_t auth_req);
+wiced_bt_gatt_status_t wiced_bt_gatt_client_send_write(uint16_t conn_id, wiced_bt_gatt_opcode_t opcode,
+        wiced_bt_gatt_write_hdr_t *p_hdr, uint8_t *p_val, void *p_app_ctx);
+wiced_bt_gatt_status_t wiced_bt_gatt_client_configure_mtu(uint16_t conn_id, uint16_t mtu);
+wiced_bt_gatt_status_t wiced_bt_gatt_client_send_indication_confirm(uint16_t conn_id, uint16_t handle);
+wiced_bt_gatt_status_t wiced_bt_gatt_disconnect(uint16_t conn_id);
@@ -0,0 +1,11 @@
+/*
+ * Stand-in for the AIROC BTSTACK wiced_bt_stack.h.
+ */
+#pragma once
+
+#include "wiced_bt_dev.h"
+#include "wiced_bt_cfg.h"
+
+wiced_result_t wiced_bt_stack_init(wiced_bt_management_cback_t *p_bt_management_cback,
+                                   const wiced_bt_cfg_settings_t *p_bt_cfg_settings);
+wiced_result_t wiced_bt_stack_deinit(void);
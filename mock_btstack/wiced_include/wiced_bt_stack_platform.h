@@ -0,0 +1,4 @@
+/*
+ * Stand-in for the AIROC BTSTACK wiced_bt_stack_platform.h.
+ */
+#pragma once
@@ -0,0 +1,14 @@
+/*
+ * Stand-in for the AIROC BTSTACK wiced_bt_trace.h.  Traces go to stdout
+ * unless the mock build is configured quiet.
+ */
+#pragma once
+
+#include <stdio.h>
+
+#ifdef MOCK_BTSTACK_QUIET
+#define WICED_BT_TRACE(...)
+#else
+#define WICED_BT_TRACE(...)     printf(__VA_ARGS__)
+#endif
+#define WICED_BT_TRACE_ARRAY(ptr, len, ...)
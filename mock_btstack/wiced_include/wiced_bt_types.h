@@ -0,0 +1,55 @@
+/*
+ * Stand-in for the AIROC BTSTACK wiced_bt_types.h, covering only what the
+ * ANC example and library use.  Used by the mock_btstack build.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#ifndef TRUE
+#define TRUE    1
+#endif
+#ifndef FALSE
+#define FALSE   0
+#endif
+
+#define WICED_TRUE      1
+#define WICED_FALSE     0
+
+typedef uint8_t  wiced_bool_t;
+typedef uint8_t  BD_ADDR[6];
+
+#define BD_ADDR_LEN     6
+typedef uint8_t  wiced_bt_device_address_t[BD_ADDR_LEN];
+
+#define LEN_UUID_16     2
+#define LEN_UUID_32     4
+#define LEN_UUID_128    16
+
+typedef struct
+{
+    uint16_t len;
+    union
+    {
+        uint16_t uuid16;
+        uint32_t uuid32;
+        uint8_t  uuid128[LEN_UUID_128];
+    } uu;
+} wiced_bt_uuid_t;
+
+typedef enum
+{
+    BLE_ADDR_PUBLIC     = 0x00,
+    BLE_ADDR_RANDOM     = 0x01,
+    BLE_ADDR_PUBLIC_ID  = 0x02,
+    BLE_ADDR_RANDOM_ID  = 0x03,
+} wiced_bt_ble_address_type_t;
+
+typedef uint8_t wiced_bt_transport_t;
+#define BT_TRANSPORT_BR_EDR     1
+#define BT_TRANSPORT_LE         2
+
+#define BT_OCTET16_LEN          16
+typedef uint8_t BT_OCTET16[BT_OCTET16_LEN];
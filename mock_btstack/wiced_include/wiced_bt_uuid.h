@@ -0,0 +1,30 @@
+/*
+ * Stand-in for the AIROC BTSTACK wiced_bt_uuid.h (subset).
+ */
+#pragma once
+
+#define UUID_SERVICE_GENERIC_ACCESS                             0x1800
+#define UUID_SERVICE_GENERIC_ATTRIBUTE                          0x1801
+#define UUID_SERVICE_ALERT_NOTIFICATION                         0x1811
+#define UUID_SERVICE_DEVICE_INFORMATION                         0x180A
+
+#define UUID_ATTRIBUTE_PRIMARY_SERVICE                          0x2800
+#define UUID_ATTRIBUTE_SECONDARY_SERVICE                        0x2801
+#define UUID_ATTRIBUTE_INCLUDE                                  0x2802
+#define UUID_ATTRIBUTE_CHARACTERISTIC                           0x2803
+
+#define UUID_DESCRIPTOR_CHARACTERISTIC_EXTENDED_PROPERTIES      0x2900
+#define UUID_DESCRIPTOR_CHARACTERISTIC_USER_DESCRIPTION         0x2901
+#define UUID_DESCRIPTOR_CLIENT_CHARACTERISTIC_CONFIGURATION     0x2902
+
+#define UUID_CHARACTERISTIC_DEVICE_NAME                         0x2A00
+#define UUID_CHARACTERISTIC_MANUFACTURER_NAME_STRING            0x2A29
+#define UUID_CHARACTERISTIC_APPEARANCE                          0x2A01
+#define UUID_CHARACTERISTIC_SERVICE_CHANGED                     0x2A05
+#define UUID_CHARACTERISTIC_ALERT_NOTIFICATION_CONTROL_POINT    0x2A44
+#define UUID_CHARACTERISTIC_UNREAD_ALERT_STATUS                 0x2A45
+#define UUID_CHARACTERISTIC_NEW_ALERT                           0x2A46
+#define UUID_CHARACTERISTIC_SUPPORTED_NEW_ALERT_CATEGORY        0x2A47
+#define UUID_CHARACTERISTIC_SUPPORTED_UNREAD_ALERT_CATEGORY     0x2A48
+#define UUID_CHARACTERISTIC_CLIENT_SUPPORTED_FEATURES           0x2B29
+#define UUID_CHARACTERISTIC_DATABASE_HASH                       0x2B2A
@@ -0,0 +1,15 @@
+/*
+ * Stand-in for the AIROC BTSTACK wiced_hal_nvram.h.
+ */
+#pragma once
+
+#include "wiced_result.h"
+
+#define WICED_NVRAM_VSID_START  0x200
+#define WICED_NVRAM_VSID_END    0x3FFF
+
+uint16_t wiced_hal_write_nvram(uint16_t vs_id, uint16_t data_length, uint8_t *p_data,
+                               wiced_result_t *p_status);
+uint16_t wiced_hal_read_nvram(uint16_t vs_id, uint16_t data_length, uint8_t *p_data,
+                              wiced_result_t *p_status);
+void wiced_hal_delete_nvram(uint16_t vs_id, wiced_result_t *p_status);
@@ -0,0 +1,14 @@
+/*
+ * Stand-in for the AIROC BTSTACK wiced_memory.h.
+ */
+#pragma once
+
+#include "wiced_bt_types.h"
+
+typedef struct wiced_bt_heap wiced_bt_heap_t;
+
+void *wiced_bt_get_buffer(uint32_t size);
+void wiced_bt_free_buffer(void *p_buf);
+wiced_bt_heap_t *wiced_bt_create_heap(const char *name, void *p_area, int size,
+                                      void *p_lock, wiced_bool_t b_make_default);
+void wiced_bt_delete_heap(wiced_bt_heap_t *p_heap);
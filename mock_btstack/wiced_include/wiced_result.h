@@ -0,0 +1,23 @@
+/*
+ * Stand-in for the AIROC BTSTACK wiced_result.h.
+ */
+#pragma once
+
+#include "wiced_bt_types.h"
+
+typedef enum
+{
+    WICED_SUCCESS           = 0,
+    WICED_PENDING           = 1,
+    WICED_TIMEOUT           = 2,
+    WICED_PARTIAL_RESULTS   = 3,
+    WICED_ERROR             = 4,
+    WICED_BADARG            = 5,
+    WICED_BADOPTION         = 6,
+    WICED_UNSUPPORTED       = 7,
+    WICED_OUT_OF_HEAP_SPACE = 8,
+    WICED_NOT_FOUND         = 9,
+
+    WICED_BT_SUCCESS        = 0,
+    WICED_BT_ERROR          = 0x8003,
+} wiced_result_t;
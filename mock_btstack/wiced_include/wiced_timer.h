@@ -0,0 +1,37 @@
+/*
+ * Stand-in for the AIROC BTSTACK wiced_timer.h.
+ */
+#pragma once
+
+#include "wiced_result.h"
+
+#define WICED_TIMER_PARAM_TYPE  uint32_t
+
+typedef void (*wiced_timer_callback_t)(WICED_TIMER_PARAM_TYPE cb_params);
+
+typedef enum
+{
+    WICED_SECONDS_TIMER = 1,
+    WICED_MILLI_SECONDS_TIMER,
+    WICED_SECONDS_PERIODIC_TIMER,
+    WICED_MILLI_SECONDS_PERIODIC_TIMER,
+} wiced_timer_type_t;
+
+typedef struct wiced_timer_s
+{
+    struct wiced_timer_s    *p_next;
+    wiced_timer_callback_t  cback;
+    WICED_TIMER_PARAM_TYPE  cback_param;
+    wiced_timer_type_t      type;
+    uint64_t                expiry_us;
+    uint32_t                timeout;
+    wiced_bool_t            in_use;
+} wiced_timer_t;
+
+wiced_result_t wiced_init_timer(wiced_timer_t *p_timer, wiced_timer_callback_t TimerCb,
+                                WICED_TIMER_PARAM_TYPE cBackparam, wiced_timer_type_t type);
+wiced_result_t wiced_deinit_timer(wiced_timer_t *p_timer);
+wiced_result_t wiced_start_timer(wiced_timer_t *p_timer, uint32_t timeout);
+wiced_result_t wiced_stop_timer(wiced_timer_t *p_timer);
+wiced_bool_t wiced_is_timer_in_use(wiced_timer_t *p_timer);
+uint64_t clock_SystemTimeMicroseconds64(void);
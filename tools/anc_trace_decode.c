@@ -0,0 +1,132 @@
+/*
+ * Copyright 2016-2022, Cypress Semiconductor Corporation (an Infineon company) or
+ * an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+ *
+ * This software, including source code, documentation and related
+ * materials ("Software") is owned by Cypress Semiconductor Corporation
+ * or one of its affiliates ("Cypress") and is protected by and subject to
+ * worldwide patent protection (United States and foreign),
+ * United States copyright laws and international treaty provisions.
+ * Therefore, you may use this Software only as provided in the license
+ * agreement accompanying the software package from which you
+ * obtained this Software ("EULA").
+ * If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+ * non-transferable license to copy, modify, and compile the Software
+ * source code solely for use in connection with Cypress's
+ * integrated circuit products.  Any reproduction, modification, translation,
+ * compilation, or representation of this Software except as specified
+ * above is prohibited without the express written permission of Cypress.
+ *
+ * Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+ * reserves the right to make changes to the Software without notice. Cypress
+ * does not assume any liability arising out of the application or use of the
+ * Software or any product or circuit described in the Software. Cypress does
+ * not authorize its products for use in any products where a malfunction or
+ * failure of the Cypress product may reasonably be expected to result in
+ * significant property damage, injury or death ("High Risk Product"). By
+ * including Cypress's product in a High Risk Product, the manufacturer
+ * of such system or application assumes all risk of such use and in doing
+ * so agrees to indemnify Cypress against all liability.
+ */
+
+/** @file
+ *
+ * Offline decoder of the ANC binary trace.
+ *
+ * Reads a file written by wiced_bt_anc_trace_dump and prints the records of
+ * all threads in timestamp order, using the same format strings as the text
+ * trace.
+ *
+ * Usage: anc_trace_decode <dump file>
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "wiced_bt_anc_trace.h"
+
+const char * const wiced_bt_anc_trace_fmt[ANC_TRACE_NUM_EVENTS] =
+{
+#define ANC_TRACE_EVENT( id, fmt )  fmt,
+#include "wiced_bt_anc_trace_events.h"
+#undef ANC_TRACE_EVENT
+};
+
+static int anc_trace_decode_compare( const void *p_a, const void *p_b )
+{
+    const anc_trace_record_t *p_rec_a = p_a;
+    const anc_trace_record_t *p_rec_b = p_b;
+
+    if ( p_rec_a->timestamp_ns != p_rec_b->timestamp_ns )
+        return ( p_rec_a->timestamp_ns < p_rec_b->timestamp_ns ) ? -1 : 1;
+    return (int)p_rec_a->thread - (int)p_rec_b->thread;
+}
+
+int main( int argc, char *argv[] )
+{
+    anc_trace_file_hdr_t file_hdr;
+    anc_trace_ring_hdr_t ring_hdr;
+    anc_trace_record_t   *p_records = NULL;
+    anc_trace_record_t   *p_rec;
+    size_t               num_records = 0;
+    uint64_t             start_ns;
+    uint32_t             ring;
+    size_t               i;
+    FILE                 *p_file;
+
+    if ( argc != 2 )
+    {
+        fprintf( stderr, "Usage: %s <dump file>\n", argv[0] );
+        return EXIT_FAILURE;
+    }
+
+    p_file = fopen( argv[1], "rb" );
+    if ( p_file == NULL )
+    {
+        perror( argv[1] );
+        return EXIT_FAILURE;
+    }
+
+    if ( ( fread( &file_hdr, sizeof(file_hdr), 1, p_file ) != 1 ) ||
+         ( file_hdr.magic != ANC_TRACE_FILE_MAGIC ) || ( file_hdr.version != ANC_TRACE_FILE_VERSION ) ||
+         ( file_hdr.record_size != sizeof(anc_trace_record_t) ) )
+    {
+        fprintf( stderr, "%s: not an ANC trace dump\n", argv[1] );
+        fclose( p_file );
+        return EXIT_FAILURE;
+    }
+
+    for ( ring = 0; ring < file_hdr.num_rings; ring++ )
+    {
+        if ( fread( &ring_hdr, sizeof(ring_hdr), 1, p_file ) != 1 )
+            break;
+
+        if ( ring_hdr.lost_records )
+            printf( "thread %u: %llu older records lost\n", ring_hdr.thread, (unsigned long long)ring_hdr.lost_records );
+
+        p_rec = realloc( p_records, ( num_records + ring_hdr.num_records ) * sizeof(anc_trace_record_t) );
+        if ( p_rec == NULL )
+            break;
+        p_records = p_rec;
+
+        num_records += fread( &p_records[num_records], sizeof(anc_trace_record_t), ring_hdr.num_records, p_file );
+    }
+    fclose( p_file );
+
+    qsort( p_records, num_records, sizeof(anc_trace_record_t), anc_trace_decode_compare );
+
+    start_ns = num_records ? p_records[0].timestamp_ns : 0;
+    for ( i = 0; i < num_records; i++ )
+    {
+        p_rec = &p_records[i];
+        printf( "[%12.6f] T%u ", (double)( p_rec->timestamp_ns - start_ns ) / 1e9, p_rec->thread );
+        if ( p_rec->event < ANC_TRACE_NUM_EVENTS )
+            printf( wiced_bt_anc_trace_fmt[p_rec->event], p_rec->arg[0], p_rec->arg[1], p_rec->arg[2], p_rec->arg[3] );
+        else
+            printf( "unknown event %u: %08x %08x %08x %08x\n", p_rec->event,
+                    p_rec->arg[0], p_rec->arg[1], p_rec->arg[2], p_rec->arg[3] );
+    }
+
+    free( p_records );
+    return EXIT_SUCCESS;
+}